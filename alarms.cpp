@@ -0,0 +1,106 @@
+#include "alarms.hpp"
+#include <cstdint>
+#include "chanfilter.hpp"
+#include "dashconfig.hpp"
+
+static constexpr uint64_t NS_PER_MS = 1000000ull;
+
+// Oil pressure drops fastest and costs the engine, so it is on soonest and
+// wins the strip; a sagging voltage has to last before it is worth a look.
+static constexpr AlarmDef ALARMS[ALARM_COUNT] = {
+  // name               channel       high   hysteresis         debounce  prio  threshold
+  { "temperature high", CH_COOLANT_C, true,  2   /* 2 C */,     2000,     1,    &DashConfig::temp_max_raw },
+  { "oil pressure low", CH_OIL_KPA,   false, 500 /* 5 kPa */,   500,      3,    &DashConfig::pressure_min_raw },
+  { "voltage low",      CH_VOLT,      false, 3   /* 0.3 V */,   5000,     2,    &DashConfig::voltage_min_raw },
+};
+
+struct AlarmState {
+  FxHysteresis hyst;
+  bool         active;
+  bool         pending;    // the other state holds, since deadline - debounce
+  uint64_t     deadline;
+};
+
+struct Listener {
+  AlarmListener fn;
+  void         *user;
+};
+
+static AlarmState g_state[ALARM_COUNT];
+static int32_t    g_value[CH_COUNT];
+static bool       g_have[CH_COUNT];
+static Listener   g_listeners[ALARM_LISTENERS];
+static int        g_listener_cnt;
+
+const AlarmDef &alarm_def(AlarmId id){ return ALARMS[id]; }
+
+bool alarms_listen(AlarmListener fn, void *user){
+  if (g_listener_cnt == ALARM_LISTENERS) return false;
+  g_listeners[g_listener_cnt++] = { fn, user };
+  return true;
+}
+
+static void toggle(int id, uint64_t t_ns){
+  AlarmState &s = g_state[id];
+  s.active = !s.active;
+  s.pending = false;
+  AlarmEvent ev{ AlarmId(id), s.active, g_value[ALARMS[id].ch], t_ns };
+  for (int i = 0; i < g_listener_cnt; ++i) g_listeners[i].fn(ev, g_listeners[i].user);
+}
+
+static void evaluate(int id, int32_t v, uint64_t t_ns){
+  AlarmState &s = g_state[id];
+  bool on = s.hyst.update(v);
+  if (on == s.active) { s.pending = false; return; }
+  if (!s.pending) {
+    s.pending = true;
+    s.deadline = t_ns + ALARMS[id].debounce_ms * NS_PER_MS;
+  }
+  if (t_ns >= s.deadline) toggle(id, t_ns);
+}
+
+void alarms_configure(const DashConfig &c, uint64_t now_ns){
+  for (int id = 0; id < ALARM_COUNT; ++id) {
+    const AlarmDef &d = ALARMS[id];
+    int32_t on = c.*d.threshold;
+    g_state[id].hyst.set(on, d.high ? on - d.hysteresis : on + d.hysteresis);
+    if (g_have[d.ch]) evaluate(id, g_value[d.ch], now_ns);
+  }
+}
+
+void alarms_sample(DashChannel ch, int32_t v, uint64_t t_ns){
+  if (g_have[ch] && g_value[ch] == v) return;
+  g_have[ch] = true;
+  g_value[ch] = v;
+  for (int id = 0; id < ALARM_COUNT; ++id)
+    if (ALARMS[id].ch == ch) evaluate(id, v, t_ns);
+}
+
+void alarms_expire(uint64_t now_ns){
+  for (int id = 0; id < ALARM_COUNT; ++id)
+    if (g_state[id].pending && g_state[id].deadline <= now_ns) toggle(id, now_ns);
+}
+
+uint64_t alarms_next_deadline(){
+  uint64_t next = UINT64_MAX;
+  for (const AlarmState &s : g_state)
+    if (s.pending && s.deadline < next) next = s.deadline;
+  return next;
+}
+
+bool alarms_active(AlarmId id){ return g_state[id].active; }
+
+int alarms_top(){
+  int top = -1;
+  for (int id = 0; id < ALARM_COUNT; ++id)
+    if (g_state[id].active && (top < 0 || ALARMS[id].priority > ALARMS[top].priority)) top = id;
+  return top;
+}
+
+void alarms_reset(){
+  for (AlarmState &s : g_state) {
+    s.hyst.reset();
+    s.active = s.pending = false;
+  }
+  for (bool &h : g_have) h = false;
+}
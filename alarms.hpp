@@ -0,0 +1,65 @@
+#pragma once
+// Warnings of the dash: a table of alarms (alarms.cpp), each watching one
+// channel of cansignals.hpp against a threshold of the config (dashconfig.hpp):
+//   temperature high   coolant_c > temp_max
+//   oil pressure low   oil_kpa   < pressure_min
+//   voltage low        volt      < voltage_min
+// An alarm is evaluated only when its channel's value changes. It turns on
+// past the threshold and off only once the value is back by its hysteresis.
+// Either edge has to hold for the alarm's debounce time before it counts.
+// A value that stops changing can't complete a debounce, so the caller asks
+// alarms_next_deadline() and calls alarms_expire() then; dashui.cpp does
+// that with an lv_timer. Nothing is polled per frame.
+//
+// Every edge is an event to the listeners: dashui.cpp flashes the warning
+// widgets, main.cpp logs it and shows the top-priority alarm on the LED strip.
+// UI thread only.
+#include <cstdint>
+#include "cansignals.hpp"
+
+struct DashConfig;
+
+enum AlarmId : uint8_t { ALARM_TEMP_HIGH, ALARM_OIL_PRESSURE_LOW, ALARM_VOLTAGE_LOW, ALARM_COUNT };
+
+struct AlarmDef {
+  const char  *name;
+  DashChannel  ch;
+  bool         high;          // on above the threshold, else below it
+  int32_t      hysteresis;    // in the channel's scale
+  uint32_t     debounce_ms;
+  uint8_t      priority;      // higher wins the LED strip
+  uint16_t DashConfig::*threshold;   // raw, in the channel's scale
+};
+
+const AlarmDef &alarm_def(AlarmId id);
+
+struct AlarmEvent {
+  AlarmId  id;
+  bool     active;
+  int32_t  value;   // of the channel, in its scale
+  uint64_t t_ns;
+};
+
+using AlarmListener = void (*)(const AlarmEvent &ev, void *user);
+
+// Up to ALARM_LISTENERS, called in the order added.
+static constexpr int ALARM_LISTENERS = 4;
+bool alarms_listen(AlarmListener fn, void *user);
+
+// Takes the thresholds of c and re-evaluates the alarms whose channel has a
+// value already. States carry over.
+void alarms_configure(const DashConfig &c, uint64_t now_ns);
+
+// A value of ch at t_ns, in the channel's scale. Unchanged values cost one compare.
+void alarms_sample(DashChannel ch, int32_t v, uint64_t t_ns);
+// Completes the debounces due by now_ns.
+void alarms_expire(uint64_t now_ns);
+// When the next debounce completes, UINT64_MAX if none is pending.
+uint64_t alarms_next_deadline();
+
+bool alarms_active(AlarmId id);
+// The active alarm of the highest priority, -1 if none.
+int alarms_top();
+
+// Forgets every value and state, keeping thresholds and listeners.
+void alarms_reset();
@@ -0,0 +1,74 @@
+#pragma once
+// Helpers shared by the benchmarks: monotonic clock, a headless LVGL display
+// (memory framebuffer, flush does nothing) and a tiny result printer.
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+  #include "lvgl.h"
+}
+
+static inline uint64_t bench_ns(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+// FNV-1a, used to check that two builds (e.g. NEON vs C) draw the same pixels.
+static inline uint32_t bench_hash(const void *p, size_t n){
+  const uint8_t *b = static_cast<const uint8_t *>(p);
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 16777619u; }
+  return h;
+}
+
+// Deterministic xorshift so every run/build sees the same inputs.
+struct BenchRng {
+  uint32_t s = 0x12345678u;
+  uint32_t next(){ s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+};
+
+// ---------- headless display ----------
+static lv_disp_draw_buf_t g_bench_draw_buf;
+static lv_disp_drv_t      g_bench_disp_drv;
+static std::vector<lv_color_t> g_bench_fb;
+
+static void bench_flush(lv_disp_drv_t *drv, const lv_area_t *, lv_color_t *){
+  lv_disp_flush_ready(drv);
+}
+
+// lv_init() + a full-screen, single-buffered memory display. Direct mode keeps
+// every area at its place, so g_bench_fb always holds the whole picture.
+static inline lv_disp_t *bench_lv_init(int w, int h){
+  lv_init();
+  g_bench_fb.assign(size_t(w) * size_t(h), lv_color_black());
+  lv_disp_draw_buf_init(&g_bench_draw_buf, g_bench_fb.data(), nullptr, uint32_t(w) * uint32_t(h));
+  lv_disp_drv_init(&g_bench_disp_drv);
+  g_bench_disp_drv.hor_res  = lv_coord_t(w);
+  g_bench_disp_drv.ver_res  = lv_coord_t(h);
+  g_bench_disp_drv.draw_buf = &g_bench_draw_buf;
+  g_bench_disp_drv.flush_cb = bench_flush;
+  g_bench_disp_drv.direct_mode = 1;
+  return lv_disp_drv_register(&g_bench_disp_drv);
+}
+
+// ---------- reporting ----------
+struct BenchStats {
+  double p50_us, p90_us, p99_us, max_us, mean_us;
+};
+
+static inline BenchStats bench_stats(std::vector<uint64_t> ns){
+  BenchStats s{};
+  if (ns.empty()) return s;
+  std::sort(ns.begin(), ns.end());
+  auto pct = [&](double p){ return ns[std::min(ns.size() - 1, size_t(p * double(ns.size())))] / 1000.0; };
+  uint64_t sum = 0;
+  for (uint64_t v : ns) sum += v;
+  s.p50_us = pct(0.50); s.p90_us = pct(0.90); s.p99_us = pct(0.99);
+  s.max_us = ns.back() / 1000.0;
+  s.mean_us = double(sum) / double(ns.size()) / 1000.0;
+  return s;
+}
@@ -0,0 +1,87 @@
+// CanLog (canlog.hpp) seen from the UI thread: the time of each frame() call
+// while the writer thread copies, maps and syncs segments in the background.
+// "clock" is the same loop with frame() left out, i.e. the cost of timing a
+// call; a frame() that costs nothing measurable sits on it. The dash traffic
+// is cantrace's drive at rpm_hz 100 (~170 frames/s) and 1000 (~1700), pushed
+// in the batches main.cpp drains per loop; "flat out" pushes back to back to
+// find the writer's throughput. "write amp" is bytes msync'd per byte logged.
+//   canlog_bench [dir] [seconds per case]
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include "bench_util.hpp"
+#include "canlog.hpp"
+
+struct LogCase {
+  const char *name;
+  uint32_t rpm_hz;   // 0: flat out
+  bool     log;
+};
+
+static void run(const LogCase &c, const char *dir, double secs){
+  CanLog log;
+  CanLogOptions opt;
+  opt.dir = dir;
+  opt.segment_kb = 1024;
+  opt.segments = 8;
+  if (c.log && !log.open(opt)) {
+    std::perror(dir);
+    std::exit(1);
+  }
+
+  DriveSchedule sched(c.rpm_hz ? c.rpm_hz : 1000);
+  std::vector<uint64_t> ns;
+  ns.reserve(c.rpm_hz ? size_t(secs * c.rpm_hz * 2) : 1u << 22);
+  uint64_t start = bench_ns(), end = start + uint64_t(secs * 1e9);
+  uint64_t now = start, pushed = 0;
+  TraceFrame f = sched.next();
+  while (now < end) {
+    // Everything due, like a pass of main.cpp's drain loop.
+    uint64_t t_us = (now - start) / 1000;
+    while ((c.rpm_hz == 0 || f.t_us <= t_us) && ns.size() < ns.capacity()) {
+      uint64_t t0 = bench_ns();
+      if (c.log) log.frame(f.fr);
+      ns.push_back(bench_ns() - t0);
+      ++pushed;
+      f = sched.next();
+      if (c.rpm_hz == 0 && (pushed & 1023) == 0) break;
+    }
+    if (c.rpm_hz) usleep(1000);  // main.cpp's SDL_Delay(1)
+    now = bench_ns();
+    if (ns.size() == ns.capacity()) break;
+  }
+  double wall = double(now - start) / 1e9;
+  uint64_t t_close = bench_ns();
+  log.close();
+  double close_ms = double(bench_ns() - t_close) / 1e6;
+
+  BenchStats s = bench_stats(ns);
+  CanLogStats st = log.stats();
+  std::printf("%-18s %9llu %7.0f %7.0f %7.0f %9.1f %8llu %6llu %9.2f %8.1f %8.1f\n", c.name,
+              (unsigned long long)pushed, s.p50_us * 1000, s.p99_us * 1000, s.max_us * 1000, s.mean_us * 1000,
+              (unsigned long long)st.dropped, (unsigned long long)st.syncs,
+              st.bytes_logged ? double(st.bytes_synced) / double(st.bytes_logged) : 0.0,
+              double(st.bytes_logged) / wall / 1e6, close_ms);
+}
+
+int main(int argc, char **argv){
+  std::string dir = argc > 1 ? argv[1] : "/tmp/canlog_bench";
+  double secs = argc > 2 ? std::atof(argv[2]) : 3.0;
+
+  static const LogCase cases[] = {
+    { "clock, 170/s",     100, false },
+    { "log, 170/s",       100, true  },
+    { "clock, 1700/s",   1000, false },
+    { "log, 1700/s",     1000, true  },
+    { "clock, flat out",    0, false },
+    { "log, flat out",      0, true  },
+  };
+  std::printf("%-18s %9s %7s %7s %7s %9s %8s %6s %9s %8s %8s\n", "case", "frames", "p50 ns", "p99 ns", "max ns",
+              "mean ns", "dropped", "syncs", "write amp", "MB/s", "close ms");
+  for (const LogCase &c : cases) run(c, dir.c_str(), secs);
+
+  std::vector<TraceFrame> tr;
+  canlog_load(dir.c_str(), tr);
+  std::printf("read back %zu frames from %s\n", tr.size(), dir.c_str());
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Columnar session logs (chanlog.hpp) over a multi-hour session: cantrace's
+// drive at rpm_hz 100 (~170 frames/s), decoded with can_decode() into the six
+// dash channels. Times writing the columns and, for oil pressure, extracting
+// the whole session and a one minute window, against decoding the raw frames
+// for the same answer. "ratio" is the raw 24 byte records per column byte;
+// every extraction is checked against the raw decode.
+//   chanlog_bench [hours] [file]
+#include <cstdlib>
+#include <string>
+#include "bench_util.hpp"
+#include "cantrace.hpp"
+#include "cansignals.hpp"
+#include "chanlog.hpp"
+
+// The raw way: every frame of the session, decoded, filtered.
+static std::vector<ChanSample> raw_extract(const std::vector<TraceFrame> &tr, DashChannel ch, uint64_t from_us,
+                                           uint64_t to_us){
+  std::vector<ChanSample> out;
+  for (const TraceFrame &f : tr) {
+    ChannelSample s[2];
+    int n = can_decode(f.fr, s);
+    for (int i = 0; i < n; ++i)
+      if (s[i].ch == ch && f.t_us >= from_us && f.t_us <= to_us) out.push_back({ f.t_us, s[i].v });
+  }
+  return out;
+}
+
+static bool same(const std::vector<ChanSample> &a, const std::vector<ChanSample> &b){
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].t_us != b[i].t_us || a[i].v != b[i].v) return false;
+  return true;
+}
+
+int main(int argc, char **argv){
+  double hours = argc > 1 ? std::atof(argv[1]) : 3.0;
+  std::string path = argc > 2 ? argv[2] : "/tmp/chanlog_bench.dcol";
+  uint64_t dur_us = uint64_t(hours * 3600e6);
+
+  std::vector<TraceFrame> tr = cantrace_synth(dur_us);
+  uint64_t raw_bytes = uint64_t(tr.size()) * CANTRACE_RECORD_SIZE;
+
+  uint64_t t0 = bench_ns();
+  ChanLogWriter w;
+  if (!w.open(path.c_str())) { std::perror(path.c_str()); return 1; }
+  uint32_t ids[CH_COUNT];
+  for (int i = 0; i < CH_COUNT; ++i) ids[i] = w.channel(DASH_CHANNEL_NAMES[i]);
+  uint64_t samples = 0;
+  for (const TraceFrame &f : tr) {
+    ChannelSample s[2];
+    int n = can_decode(f.fr, s);
+    for (int i = 0; i < n; ++i) w.add(ids[s[i].ch], f.t_us, s[i].v);
+    samples += uint64_t(n);
+  }
+  if (!w.close()) { std::perror(path.c_str()); return 1; }
+  double write_ms = double(bench_ns() - t0) / 1e6;
+
+  std::printf("%.1f h session: %zu frames (%.1f MB raw), %llu samples -> %.2f MB, ratio %.1f, %.2f bytes/sample, "
+              "written in %.0f ms\n", hours, tr.size(), raw_bytes / 1e6, (unsigned long long)samples,
+              w.bytes_written() / 1e6, double(raw_bytes) / double(w.bytes_written()),
+              double(w.bytes_written()) / double(samples), write_ms);
+
+  ChanLogReader r;
+  t0 = bench_ns();
+  if (!r.open(path.c_str())) { std::fprintf(stderr, "%s: can't read back\n", path.c_str()); return 1; }
+  double open_ms = double(bench_ns() - t0) / 1e6;
+  std::printf("%-12s %7s %10s %10s %8s\n", "channel", "blocks", "samples", "bytes", "B/sample");
+  for (uint32_t ch = 0; ch < r.channels().size(); ++ch) {
+    ChanLogReader::ChannelInfo ci = r.info(ch);
+    std::printf("%-12s %7u %10llu %10llu %8.2f\n", r.channels()[ch].c_str(), (unsigned)ci.blocks,
+                (unsigned long long)ci.samples, (unsigned long long)ci.bytes,
+                ci.samples ? double(ci.bytes) / double(ci.samples) : 0.0);
+  }
+
+  struct Query { const char *name; uint64_t from_us, to_us; };
+  const Query queries[] = {
+    { "whole session", 0, UINT64_MAX },
+    { "1 min window", dur_us / 2, dur_us / 2 + 60000000 },
+  };
+  std::printf("oil_kpa, open %.2f ms\n%-14s %10s %8s %10s %10s %10s %6s\n", open_ms, "query", "samples", "blocks",
+              "kB read", "column ms", "raw ms", "same");
+  for (const Query &q : queries) {
+    uint64_t b0 = r.blocks_read(), by0 = r.bytes_read();
+    std::vector<ChanSample> col;
+    t0 = bench_ns();
+    r.read(uint32_t(r.channel("oil_kpa")), q.from_us, q.to_us, col);
+    double col_ms = double(bench_ns() - t0) / 1e6;
+    t0 = bench_ns();
+    std::vector<ChanSample> raw = raw_extract(tr, CH_OIL_KPA, q.from_us, q.to_us);
+    double raw_ms = double(bench_ns() - t0) / 1e6;
+    std::printf("%-14s %10zu %8llu %10.1f %10.3f %10.3f %6s\n", q.name, col.size(),
+                (unsigned long long)(r.blocks_read() - b0), (r.bytes_read() - by0) / 1024.0, col_ms, raw_ms,
+                same(col, raw) ? "yes" : "NO");
+  }
+  return 0;
+}
@@ -0,0 +1,291 @@
+// Headless run of the dash as raspi_dash drives it: dashui_init() and the CAN
+// handlers of dashui.cpp, a memory display with the app's two 800x160 draw
+// buffers, and lv_timer_handler() once per refresh period. The CAN trace is a
+// log (candump -l, ASC or our binary trace) or, without one, the synthetic
+// drive of cantrace.hpp with rpm at 100 Hz, as tools/cangen sends it by
+// default. Reports the percentiles of lv_timer_handler() and, per refresh, the
+// CAN frames handled, invalidated areas, pixels flushed and lv_mem
+// allocations. The hash covers every refresh, like refr_bench's.
+//   dash_bench [-n refreshes] [-t log] [-c] [-v] [-m] [-L dir] [-T file] [-S socket] [-C config]
+//     -c  SquareLine rpm composite instead of the rpmbar widget
+//     -v  keep the [CAN] prints of the handlers, and print the alarm edges
+//     -m  throughput: the trace through CanReplay without timing, main.cpp's
+//         loop of MAX_CAN_PER_FRAME frames and lv_timer_handler() on the real
+//         clock; reports frames and refreshes per second, and the rpm's
+//         frame-to-flush latency (latency.hpp) with the trace all due at once
+//     -L  log every frame to a canlog ring in dir, as main.cpp does
+//     -T  write the last events of lv_trace (trace.hpp) to file as Chrome
+//         trace JSON at the end
+//     -S  with -m, serve the metrics (metrics.hpp) on socket while running
+//         and print them at the end
+//     -C  load a config file (dashconfig.hpp) and reload it, between
+//         refreshes, whenever it is saved
+#include <cstring>
+#include <cstdlib>
+#include <utility>
+#include <unistd.h>
+#include "bench_util.hpp"
+#include "dashui.hpp"
+#include "cantrace.hpp"
+#include "canlog.hpp"
+#include "latency.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+#include "dashconfig.hpp"
+#include "alarms.hpp"
+#include "fixedpoint.hpp"
+
+static constexpr int SCR_W = 800;
+static constexpr int SCR_H = 480;
+static constexpr uint32_t PERIOD_MS = LV_DISP_DEF_REFR_PERIOD;
+static constexpr int MAX_CAN_PER_FRAME = 300;  // as main.cpp
+
+// ---------- memory display ----------
+static lv_disp_draw_buf_t g_draw_buf;
+static lv_color_t g_buf1[SCR_W * 160];
+static lv_color_t g_buf2[SCR_W * 160];
+static std::vector<lv_color_t> g_fb(size_t(SCR_W) * SCR_H);
+static uint64_t g_flushed_px;
+static uint32_t g_refreshes;
+static CanLog   g_canlog;
+
+// Copies the area like sdl_flush() updates the texture.
+static void mem_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p){
+  int w = lv_area_get_width(area);
+  for (int y = area->y1; y <= area->y2; ++y) {
+    std::memcpy(&g_fb[size_t(y) * SCR_W + area->x1], color_p, size_t(w) * sizeof(lv_color_t));
+    color_p += w;
+  }
+  g_flushed_px += lv_area_get_size(area);
+  latency_flush(area);
+  if (lv_disp_flush_is_last(drv)) ++g_refreshes;
+  lv_disp_flush_ready(drv);
+}
+
+static lv_disp_t *mem_disp_init(){
+  lv_init();
+  lv_disp_draw_buf_init(&g_draw_buf, g_buf1, g_buf2, SCR_W * 160);
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = SCR_W; disp_drv.ver_res = SCR_H;
+  disp_drv.draw_buf = &g_draw_buf; disp_drv.flush_cb = mem_flush;
+  return lv_disp_drv_register(&disp_drv);
+}
+
+static void print_canlog(){
+  if (!g_canlog.is_open()) return;
+  g_canlog.close();
+  CanLogStats st = g_canlog.stats();
+  std::printf("canlog: %llu records, %llu dropped, %llu syncs, %llu kB written for %llu kB logged\n",
+              (unsigned long long)st.records, (unsigned long long)st.dropped, (unsigned long long)st.syncs,
+              (unsigned long long)st.bytes_synced / 1024, (unsigned long long)st.bytes_logged / 1024);
+  if (st.map_failures) std::printf("canlog: %llu segment mmaps failed\n", (unsigned long long)st.map_failures);
+}
+
+static void dump_trace(const char *path){
+  if (!path) return;
+#if LV_USE_TRACE
+  if (lv_trace_dump(path) != LV_RES_OK) std::perror(path);
+#else
+  std::fprintf(stderr, "%s: built without LV_USE_TRACE (DASH_TRACE)\n", path);
+#endif
+}
+
+// The trace as fast as main.cpp's loop decodes and draws it.
+static void run_max(std::vector<TraceFrame> trace){
+  CanReplay replay(std::move(trace), 0);
+  latency_enable(true);
+  std::vector<uint64_t> ns;
+  uint64_t handler_ns = 0, start = bench_ns(), last = start, tick_ns = 0;
+  uint32_t refreshes = g_refreshes;
+  while (!replay.done()) {
+    if (dashcfg_poll()) dashui_apply_config();
+    uint64_t t0 = bench_ns();
+    {
+      TRACE_SCOPE("can drain");
+      for (int i = 0; i < MAX_CAN_PER_FRAME; ++i) {
+        auto fr = replay.read_nonblock();
+        if (!fr) break;
+        if (g_canlog.is_open()) g_canlog.frame(*fr);
+        if (fr->id == 0x2000) latency_rx(0);
+        TRACE_SCOPE("decode");
+        uint64_t d0 = bench_ns();
+        dashui_handle_can(*fr);
+        metrics_can(fr->id, bench_ns() - d0);
+      }
+    }
+    {
+      TRACE_SCOPE("derived");
+      uint64_t d0 = bench_ns();
+      uint32_t n = dashui_update_derived();
+      metrics_derived(n, bench_ns() - d0);
+    }
+    uint64_t t1 = bench_ns();
+    handler_ns += t1 - t0;
+
+    tick_ns += t1 - last; last = t1;
+    lv_tick_inc(uint32_t(tick_ns / 1000000));
+    tick_ns %= 1000000;
+    {
+      TRACE_SCOPE("lv_timer_handler");
+      lv_timer_handler();
+    }
+    latency_present();
+    uint64_t t2 = bench_ns();
+    ns.push_back(t2 - t1);
+    metrics_frame(t2 - t1);
+    if (g_canlog.is_open()) metrics_dropped(DROP_CANLOG, g_canlog.stats().dropped);
+    metrics_tick(t2);
+  }
+  double secs = double(bench_ns() - start) / 1e9;
+  BenchStats s = bench_stats(ns);
+  std::printf("%llu frames in %.3f s: %.0f frames/s (%.2f us each in the handlers), %zu loops, %.0f refreshes/s\n",
+              (unsigned long long)replay.frames_read(), secs, replay.frames_read() / secs,
+              handler_ns / 1000.0 / double(std::max<uint64_t>(1, replay.frames_read())), ns.size(),
+              (g_refreshes - refreshes) / secs);
+  std::printf("lv_timer_handler: p50 %.1f us, p99 %.1f us, max %.1f us\n", s.p50_us, s.p99_us, s.max_us);
+  latency_report(stdout, false);
+}
+
+// Refresh mode plays the trace on a simulated clock (PERIOD_MS per refresh).
+static uint64_t g_trace_ns = 0;
+static uint64_t trace_ns(){ return g_trace_ns; }
+
+static void print_alarm(const AlarmEvent &ev, void *){
+  const AlarmDef &d = alarm_def(ev.id);
+  char buf[FX_FORMAT_MAX];
+  fx_format(buf, ev.value, DASH_CHANNEL_DECIMALS[d.ch]);
+  std::printf("[ALARM] %s %s, %s=%s\n", d.name, ev.active ? "on" : "off", DASH_CHANNEL_NAMES[d.ch], buf);
+}
+
+int main(int argc, char **argv){
+  int refreshes = 0;
+  const char *trace_path = nullptr;
+  const char *log_dir = nullptr;
+  const char *trace_out = nullptr;
+  const char *metrics_sock = nullptr;
+  const char *config_path = nullptr;
+  bool composite = false, verbose = false, max_rate = false;
+  for (int c; (c = getopt(argc, argv, "n:t:cvmL:T:S:C:")) != -1;) {
+    switch (c) {
+      case 'n': refreshes = std::atoi(optarg); break;
+      case 't': trace_path = optarg; break;
+      case 'c': composite = true; break;
+      case 'v': verbose = true; break;
+      case 'm': max_rate = true; break;
+      case 'L': log_dir = optarg; break;
+      case 'T': trace_out = optarg; break;
+      case 'S': metrics_sock = optarg; break;
+      case 'C': config_path = optarg; break;
+      default:
+        std::fprintf(stderr, "usage: %s [-n refreshes] [-t log] [-c] [-v] [-m] [-L dir] [-T file] [-S socket] "
+                     "[-C config]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  std::vector<TraceFrame> trace;
+  if (trace_path) {
+    bool ok = canlog_is_log(trace_path) ? canlog_load(trace_path, trace) : cantrace_load(trace_path, trace);
+    if (!ok) {
+      std::fprintf(stderr, "can't read %s\n", trace_path);
+      return 1;
+    }
+    // The whole trace unless -n asks for less.
+    int trace_refr = trace.empty() ? 0 : int(trace.back().t_us / (PERIOD_MS * 1000) + 1);
+    if (refreshes <= 0 || refreshes > trace_refr) refreshes = trace_refr;
+  } else {
+    if (refreshes <= 0) refreshes = 1000;
+    trace = cantrace_synth(uint64_t(refreshes) * PERIOD_MS * 1000);
+  }
+
+  if (log_dir) {
+    CanLogOptions opt;
+    opt.dir = log_dir;
+    if (!g_canlog.open(opt)) {
+      std::perror(log_dir);
+      return 1;
+    }
+  }
+
+  if (config_path) {
+    if (!dashcfg_load(config_path)) return 1;
+    if (!dashcfg_watch(config_path)) std::perror(config_path);
+  }
+
+  lv_disp_t *disp = mem_disp_init();
+  dashui_set_log(verbose);
+  if (verbose) alarms_listen(print_alarm, nullptr);
+  if (!max_rate) dashui_set_clock(trace_ns);   // the alarms debounce in trace time
+  dashui_init(!composite);
+  lv_refr_now(disp);
+  if (max_rate) {
+    std::printf("%s, %s, %zu CAN frames, no timing\n", composite ? "composite" : "rpmbar",
+                trace_path ? trace_path : "synthetic trace", trace.size());
+    if (metrics_sock && !metrics_serve(metrics_sock)) {
+      std::perror(metrics_sock);
+      return 1;
+    }
+    run_max(std::move(trace));
+    print_canlog();
+    dump_trace(trace_out);
+    if (metrics_sock) {
+      std::printf("%s\n", metrics_text().c_str());
+      metrics_stop();
+    }
+    return 0;
+  }
+
+  std::vector<uint64_t> ns;
+  ns.reserve(refreshes);
+  uint64_t handler_ns = 0, derived_ns = 0, derived_nodes = 0;
+  size_t next = 0;
+  double inv_areas = 0, inv_px = 0;
+  uint32_t hash = 0;
+  g_flushed_px = 0;
+  lv_mem_monitor_t mem;
+  lv_mem_monitor(&mem);
+  uint32_t alloc_cnt = mem.alloc_cnt;
+
+  for (int r = 0; r < refreshes; ++r) {
+    if (dashcfg_poll()) dashui_apply_config();
+    uint64_t end_us = uint64_t(r + 1) * PERIOD_MS * 1000;
+    uint64_t t0 = bench_ns();
+    for (; next < trace.size() && trace[next].t_us < end_us; ++next) {
+      if (g_canlog.is_open()) g_canlog.frame(trace[next].fr);
+      g_trace_ns = trace[next].t_us * 1000;
+      dashui_handle_can(trace[next].fr);
+    }
+    handler_ns += bench_ns() - t0;
+    g_trace_ns = end_us * 1000;
+    t0 = bench_ns();
+    derived_nodes += dashui_update_derived();
+    derived_ns += bench_ns() - t0;
+
+    inv_areas += disp->inv_p;
+    for (uint16_t i = 0; i < disp->inv_p; ++i) inv_px += lv_area_get_size(&disp->inv_areas[i]);
+
+    lv_tick_inc(PERIOD_MS);
+    t0 = bench_ns();
+    lv_timer_handler();
+    ns.push_back(bench_ns() - t0);
+    hash ^= bench_hash(g_fb.data(), g_fb.size() * sizeof(lv_color_t)) + uint32_t(r);
+  }
+
+  lv_mem_monitor(&mem);
+  BenchStats s = bench_stats(ns);
+  double n = refreshes > 0 ? refreshes : 1;
+  std::printf("%s, %s, %d refreshes of %u ms, %zu CAN frames\n", composite ? "composite" : "rpmbar",
+              trace_path ? trace_path : "synthetic trace", refreshes, (unsigned)PERIOD_MS, next);
+  std::printf("%9s %9s %9s %9s %9s\n", "p50 us", "p90 us", "p99 us", "max us", "mean us");
+  std::printf("%9.1f %9.1f %9.1f %9.1f %9.1f\n", s.p50_us, s.p90_us, s.p99_us, s.max_us, s.mean_us);
+  std::printf("per refresh: %.1f CAN frames in %.1f us, %.2f invalidated areas (%.0f px), %.0f px flushed, "
+              "%.1f allocs\n", next / n, handler_ns / 1000.0 / n, inv_areas / n, inv_px / n, g_flushed_px / n,
+              (mem.alloc_cnt - alloc_cnt) / n);
+  std::printf("derived: %.2f channels computed in %.2f us per refresh\n", derived_nodes / n, derived_ns / 1000.0 / n);
+  std::printf("heap: %u kB peak, %u%% frag   hash %08x\n", (unsigned)mem.max_used / 1024, (unsigned)mem.frag_pct,
+              (unsigned)hash);
+  print_canlog();
+  dump_trace(trace_out);
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Throughput of the channel filters (chanfilter.hpp): ns per sample for each
+// kind of stage and for a full chain, over many channels fed round robin with
+// a noisy signal, one sample per channel per ms. "double ewma" is the old
+// handler's EWMA in double, for comparison. Then the dash's six channels:
+// cantrace's synthetic drive through can_decode_fixed() and a chain per channel.
+//   filter_bench [samples per case] [channels]
+#include <cstdlib>
+#include <string>
+#include "bench_util.hpp"
+#include "cantrace.hpp"
+#include "cansignals.hpp"
+#include "chanfilter.hpp"
+
+static constexpr const char *CASES[] = {
+  "none",
+  "ewma 0.05",
+  "median 5",
+  "median 15",
+  "slew 1000",
+  "deadband 5",
+  "median 5, ewma 0.05, slew 1000, deadband 5",
+};
+
+static std::vector<int32_t> make_input(uint32_t n){
+  BenchRng rng;
+  std::vector<int32_t> in(n);
+  int32_t base = 20000;
+  for (uint32_t i = 0; i < n; ++i) {
+    if (i % 1000 == 0) base = 10000 + int32_t(rng.next() % 20000);   // a step now and then
+    int32_t noise = int32_t(rng.next() % 401) - 200;
+    if (rng.next() % 50 == 0) noise *= 20;                             // and spikes
+    in[i] = base + noise;
+  }
+  return in;
+}
+
+static void run_case(const char *text, const std::vector<int32_t> &in, uint32_t channels){
+  FilterSpec spec;
+  std::string err;
+  if (!filter_parse(text, 0, spec, err)) { std::fprintf(stderr, "%s: %s\n", text, err.c_str()); std::exit(1); }
+  std::vector<FilterChain> chains(channels);
+  for (FilterChain &c : chains) c.configure(spec);
+
+  uint64_t sum = 0, t_ns = 0;
+  uint64_t t0 = bench_ns();
+  for (size_t i = 0; i < in.size(); ++i) {
+    uint32_t ch = uint32_t(i % channels);
+    if (ch == 0) t_ns += 1000000;
+    sum += uint32_t(chains[ch].apply(in[i], t_ns));
+  }
+  double ns = double(bench_ns() - t0) / double(in.size());
+  std::printf("%-44s %8.1f %10.1f   %016llx\n", text, ns, 1e3 / ns, (unsigned long long)sum);
+}
+
+static void run_double_ewma(const std::vector<int32_t> &in, uint32_t channels){
+  std::vector<double> avg(channels, 0.0);
+  std::vector<bool> init(channels, false);
+  uint64_t sum = 0;
+  uint64_t t0 = bench_ns();
+  for (size_t i = 0; i < in.size(); ++i) {
+    uint32_t ch = uint32_t(i % channels);
+    double v = in[i] / 100.0;
+    if (!init[ch]) { avg[ch] = v; init[ch] = true; }
+    else avg[ch] += 0.05 * (v - avg[ch]);
+    sum += uint32_t(avg[ch] * 100.0 + 0.5);
+  }
+  double ns = double(bench_ns() - t0) / double(in.size());
+  std::printf("%-44s %8.1f %10.1f   %016llx\n", "double ewma", ns, 1e3 / ns, (unsigned long long)sum);
+}
+
+int main(int argc, char **argv){
+  uint32_t samples = argc > 1 ? uint32_t(std::atoi(argv[1])) : 4000000;
+  uint32_t channels = argc > 2 ? uint32_t(std::atoi(argv[2])) : 64;
+  if (channels == 0) channels = 1;
+  std::vector<int32_t> in = make_input(samples);
+
+  std::printf("%u samples over %u channels\n", (unsigned)samples, (unsigned)channels);
+  std::printf("%-44s %8s %10s   %s\n", "filter", "ns", "Msample/s", "checksum");
+  for (const char *c : CASES) run_case(c, in, channels);
+  run_double_ewma(in, channels);
+
+  // The dash's channels, as dashui.cpp filters them, with the chain above on each.
+  std::vector<TraceFrame> tr = cantrace_synth(600ull * 1000000);
+  FilterSpec spec;
+  std::string err;
+  FilterChain chains[CH_COUNT];
+  for (int ch = 0; ch < CH_COUNT; ++ch) {
+    filter_parse(CASES[6], DASH_CHANNEL_DECIMALS[ch], spec, err);
+    chains[ch].configure(spec);
+  }
+  uint64_t sum = 0, n = 0;
+  uint64_t t0 = bench_ns();
+  for (const TraceFrame &f : tr) {
+    ChannelFixed s[2];
+    int k = can_decode_fixed(f.fr, s);
+    for (int i = 0; i < k; ++i) sum += uint32_t(chains[s[i].ch].apply(s[i].v, f.t_us * 1000));
+    n += uint64_t(k);
+  }
+  double ns = double(bench_ns() - t0);
+  std::printf("dash channels: %zu frames, %llu samples decoded and filtered, %.1f ns/frame, %.2f M frames/s   %016llx\n",
+              tr.size(), (unsigned long long)n, ns / double(tr.size()), double(tr.size()) * 1e3 / ns,
+              (unsigned long long)sum);
+  return 0;
+}
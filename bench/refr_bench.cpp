@@ -0,0 +1,175 @@
+// Refresh benchmark on the real dash screen (squareline/ui_init) in a headless
+// display. Every frame changes the values like the CAN handlers of main.cpp do
+// and times lv_refr_now(). With LV_USE_REFR_THREADS (-DDASH_REFR_THREADS=ON)
+// it is repeated for 1..LV_REFR_THREAD_CNT drawing threads; the hash covers
+// every frame and must be the same for all thread counts, and with or without
+// LV_USE_REFR_OCCLUSION. "overdraw" is drawn / shown pixels, "culled" the
+// share of drawn pixels saved by skipping hidden objects, "circ miss" the
+// radius mask circles calculated per frame (argv[2]: circle cache size),
+// "alloc" the lv_mem allocations per frame; the heap use and the high water
+// mark of the frame arenas (LV_MEM_FRAME_SIZE) are printed at the end.
+// Everything runs first on the SquareLine rpm composite, again with only the
+// moved end of its lv_bar redrawn (lv_bar_set_delta_refr) and the speed arc's
+// track cached (lv_arc_set_bg_cache) -- same hashes --, then with the rpmbar
+// widget in its place (the two draw slightly different pictures).
+#include <cstring>
+#include "bench_util.hpp"
+
+extern "C" {
+  #include "ui.h"
+  #include "rpmbar.h"
+}
+
+static constexpr int SCR_W = 800;
+static constexpr int SCR_H = 480;
+
+enum Changes { ALL, RPM_ONLY, SPEED_ONLY };
+
+struct RefrCase {
+  const char *name;
+  Changes changes;
+  bool full;      // invalidate the whole screen every frame
+  bool shift;     // shift overlays / darkened shift zone shown
+};
+
+static const RefrCase CASES[] = {
+  { "dash",  ALL,        false, false },
+  { "rpm",   RPM_ONLY,   false, false },
+  { "speed", SPEED_ONLY, false, false },
+  { "full",  ALL,        true,  false },
+  { "shift", ALL,        true,  true  },
+};
+
+static lv_obj_t *g_rpmbar = nullptr;
+
+static void set_shift(bool on){
+  if (g_rpmbar) {
+    rpmbar_set_shift(g_rpmbar, on ? RPMBAR_SHIFT_UP : RPMBAR_SHIFT_NONE);
+    return;
+  }
+  for (lv_obj_t *o : { ui_erpmbackswitchup, ui_erpmbackswitchdown }) {
+    if (on) lv_obj_clear_flag(o, LV_OBJ_FLAG_HIDDEN);
+    else lv_obj_add_flag(o, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+static void set_values(int f, Changes changes){
+  char buf[16];
+  int speed = (f * 3) % 160;
+  if (changes == SPEED_ONLY) {
+    lv_arc_set_value(ui_espeedarc, speed);
+    return;
+  }
+
+  int rpm = (f * 97) % 7500;
+  if (g_rpmbar) rpmbar_set_value(g_rpmbar, rpm);
+  else lv_bar_set_value(ui_erpmbar, rpm, LV_ANIM_OFF);
+  if (changes == RPM_ONLY) return;
+
+  std::snprintf(buf, sizeof(buf), "%d", rpm);
+  lv_label_set_text(ui_erpm, buf);
+
+  std::snprintf(buf, sizeof(buf), "%d", speed);
+  lv_label_set_text(ui_espeed, buf);
+  lv_arc_set_value(ui_espeedarc, speed);
+
+  std::snprintf(buf, sizeof(buf), "%d", 80 + f % 25);
+  lv_label_set_text(ui_eoiltemperature, buf);
+  std::snprintf(buf, sizeof(buf), "%d.%d", 12 + (f / 10) % 3, f % 10);
+  lv_label_set_text(ui_evoltage, buf);
+  std::snprintf(buf, sizeof(buf), "%d", 1 + (f / 30) % 6);
+  lv_label_set_text(ui_egear, buf);
+}
+
+// Times `frames` refreshes of one case with 1..max_threads drawing threads.
+static void run_case(lv_disp_t *disp, const char *ui_name, const RefrCase &rc, int frames, uint32_t max_threads){
+  set_shift(rc.shift);
+  double mean_1 = 0;
+  for (uint32_t threads = 1; threads <= max_threads; ++threads) {
+#if LV_USE_REFR_THREADS
+    lv_refr_set_thread_cnt(threads);
+#endif
+    // Same starting picture for every thread count.
+    set_values(0, rc.changes);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(disp);
+
+    std::vector<uint64_t> ns;
+    ns.reserve(frames);
+    uint32_t hash = 0;
+    double shown = 0, drawn = 0, culled = 0;
+    lv_draw_mask_reset_circle_cache_stats();
+    lv_mem_monitor_t mem;
+    lv_mem_monitor(&mem);
+    uint32_t alloc_cnt = mem.alloc_cnt;
+    for (int f = 1; f <= frames; ++f) {
+      set_values(f, rc.changes);
+      if (rc.full) lv_obj_invalidate(lv_scr_act());
+      uint64_t t0 = bench_ns();
+      lv_refr_now(disp);
+      ns.push_back(bench_ns() - t0);
+      hash ^= bench_hash(g_bench_fb.data(), g_bench_fb.size() * sizeof(lv_color_t)) + uint32_t(f);
+
+      lv_refr_overdraw_t od;
+      lv_refr_get_overdraw(&od);
+      shown += od.px_shown;
+      drawn += od.px_drawn;
+      culled += od.px_culled;
+    }
+
+    lv_draw_mask_circle_cache_stats_t cs;
+    lv_draw_mask_get_circle_cache_stats(&cs);
+    lv_mem_monitor(&mem);
+
+    BenchStats s = bench_stats(ns);
+    if (threads == 1) mean_1 = s.mean_us;
+    std::printf("%-9s %-6s %7u %9.1f %9.1f %9.1f %8.2fx %8.2fx %6.1f%% %9.0f %9.2f %7.1f   %08x\n", ui_name, rc.name,
+                threads, s.mean_us, s.p50_us, s.p99_us, mean_1 / s.mean_us, shown > 0 ? drawn / shown : 0.0,
+                drawn > 0 ? 100.0 * culled / (drawn + culled) : 0.0, shown / frames, double(cs.miss) / frames,
+                double(mem.alloc_cnt - alloc_cnt) / frames,
+                (unsigned)hash);
+  }
+}
+
+int main(int argc, char **argv){
+  int frames = argc > 1 ? std::atoi(argv[1]) : 300;
+  if (argc > 2) lv_draw_mask_set_circle_cache_size(uint32_t(std::atoi(argv[2])));
+
+  lv_disp_t *disp = bench_lv_init(SCR_W, SCR_H);
+  ui_init();
+  lv_refr_now(disp);
+
+#if LV_USE_REFR_THREADS
+  const uint32_t max_threads = LV_REFR_THREAD_CNT;
+#else
+  const uint32_t max_threads = 1;
+  std::printf("(built without LV_USE_REFR_THREADS: 1 thread only)\n");
+#endif
+
+  std::printf("%-9s %-6s %7s %9s %9s %9s %9s %9s %7s %9s %9s %7s %10s\n", "ui", "case", "threads", "mean us", "p50 us",
+              "p99 us", "speedup", "overdraw", "culled", "px/frame", "circ miss", "alloc", "hash");
+  for (const RefrCase &rc : CASES) run_case(disp, "composite", rc, frames, max_threads);
+
+  lv_bar_set_delta_refr(ui_erpmbar, true);
+  lv_arc_set_bg_cache(ui_espeedarc, true);
+  for (const RefrCase &rc : CASES) run_case(disp, "partial", rc, frames, max_threads);
+
+  g_rpmbar = rpmbar_replace_ui_composite();
+  for (const RefrCase &rc : CASES) run_case(disp, "rpmbar", rc, frames, max_threads);
+
+  lv_mem_monitor_t mem;
+  lv_mem_monitor(&mem);
+  std::printf("\nheap: %u pools, %u kB, %u kB used, %u kB peak, %u%% frag, slabs %u / %u kB used\n",
+              (unsigned)mem.pool_cnt, (unsigned)mem.total_size / 1024, (unsigned)(mem.total_size - mem.free_size) / 1024,
+              (unsigned)mem.max_used / 1024, (unsigned)mem.frag_pct, (unsigned)mem.slab_used / 1024,
+              (unsigned)mem.slab_size / 1024);
+  lv_mem_frame_stats_t fs;
+  lv_mem_frame_get_stats(&fs);
+  std::printf("frame arena: %u / %u bytes high water, %u overflows\n", (unsigned)fs.high_water,
+              (unsigned)fs.size, (unsigned)fs.overflow);
+
+  // Removing the last display stops and joins the drawing threads.
+  lv_disp_remove(disp);
+  lv_deinit();
+  return 0;
+}
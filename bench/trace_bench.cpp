@@ -0,0 +1,74 @@
+// Cost of lv_trace (trace.hpp): ns per span (a begin and an end) on one
+// thread, with recording switched off, and while another thread dumps the
+// rings over and over; then the time and size of a dump with the ring of every
+// thread full. "clock" is two clock_gettime() calls, the floor of a span.
+//   trace_bench [spans per case] [file]
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <sys/stat.h>
+#include "bench_util.hpp"
+#include "trace.hpp"
+
+#if LV_USE_TRACE
+static double per_span_ns(uint32_t spans){
+  uint64_t t0 = bench_ns();
+  for (uint32_t i = 0; i < spans; ++i) {
+    TRACE_SCOPE("span");
+  }
+  return double(bench_ns() - t0) / spans;
+}
+
+static double per_clock_pair_ns(uint32_t spans){
+  volatile uint64_t sink = 0;
+  uint64_t t0 = bench_ns();
+  for (uint32_t i = 0; i < spans; ++i) sink = sink + bench_ns() + bench_ns();
+  return double(bench_ns() - t0) / spans;
+}
+
+int main(int argc, char **argv){
+  uint32_t spans = argc > 1 ? uint32_t(std::atoi(argv[1])) : 2000000;
+  std::string path = argc > 2 ? argv[2] : "/tmp/trace_bench.json";
+  TRACE_THREAD("bench");
+
+  std::printf("%-22s %9s\n", "case", "ns/span");
+  std::printf("%-22s %9.1f\n", "clock", per_clock_pair_ns(spans));
+  std::printf("%-22s %9.1f\n", "span", per_span_ns(spans));
+  lv_trace_set_enabled(false);
+  std::printf("%-22s %9.1f\n", "span, off", per_span_ns(spans));
+  lv_trace_set_enabled(true);
+
+  std::atomic<bool> run{true};
+  std::atomic<uint32_t> dumps{0};
+  std::thread dumper([&]{
+    TRACE_THREAD("dumper");
+    while (run.load(std::memory_order_relaxed)) {
+      lv_trace_dump(path.c_str());
+      dumps.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  double racing = per_span_ns(spans);
+  run = false;
+  dumper.join();
+  std::printf("%-22s %9.1f   (%u dumps meanwhile)\n", "span, dump racing", racing, (unsigned)dumps.load());
+
+  // Fill the rings of a few more threads, then time one dump of everything.
+  std::thread fill[3];
+  for (std::thread &t : fill) t = std::thread([]{ per_span_ns(LV_TRACE_BUF_EVENTS); });
+  for (std::thread &t : fill) t.join();
+  uint64_t t0 = bench_ns();
+  bool ok = lv_trace_dump(path.c_str()) == LV_RES_OK;
+  double ms = double(bench_ns() - t0) / 1e6;
+  struct stat st{};
+  stat(path.c_str(), &st);
+  std::printf("dump of 4 full rings, %u events each: %.1f ms, %lld kB in %s%s\n", (unsigned)LV_TRACE_BUF_EVENTS, ms,
+              (long long)st.st_size / 1024, path.c_str(), ok ? "" : " (failed)");
+  return ok ? 0 : 1;
+}
+#else
+int main(){
+  std::fprintf(stderr, "built without LV_USE_TRACE (DASH_TRACE)\n");
+  return 1;
+}
+#endif
@@ -0,0 +1,352 @@
+#include "canlog.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <string>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+
+// Segment file: a 4 kB header page with two header slots (at 0 and 2048),
+// then the records.
+static constexpr size_t   HDR_PAGE  = 4096;
+static constexpr size_t   HDR_SLOT2 = 2048;
+static constexpr uint32_t VERSION   = 1;
+static constexpr uint32_t POLL_MS   = 20;  // writer wakeups, far below what the queue holds (queue_len)
+static constexpr uint64_t RETRY_MIN_NS = 100000000ull;   // after a failed mmap, doubling
+static constexpr uint64_t RETRY_MAX_NS = 5000000000ull;
+static constexpr int      WRITER_NICE = 10;
+static constexpr char     SEG_MAGIC[8] = { 'D', 'A', 'S', 'H', 'S', 'E', 'G', '1' };
+
+struct SegHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t seq;      // segment number; the slot of the newest segment wins
+  uint64_t gen;      // header writes within the segment; the larger gen wins
+  uint64_t records;  // synced records, the rest of the file is ignored
+  int64_t  wall_ns;  // CLOCK_REALTIME at t_us 0 of the session
+  uint32_t crc;      // of the bytes above
+  uint32_t pad;
+};
+
+static uint32_t crc32(const void *p, size_t n){
+  const uint8_t *b = static_cast<const uint8_t *>(p);
+  uint32_t c = 0xFFFFFFFFu;
+  for (size_t i = 0; i < n; ++i) {
+    c ^= b[i];
+    for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+  }
+  return ~c;
+}
+
+static bool header_valid(const SegHeader &h){
+  return std::memcmp(h.magic, SEG_MAGIC, 8) == 0 && h.version == VERSION &&
+         h.record_size == CANTRACE_RECORD_SIZE && h.crc == crc32(&h, offsetof(SegHeader, crc));
+}
+
+// The newer of the two slots, false if neither is valid (never written, or torn).
+static bool header_read(const uint8_t *page, SegHeader &out){
+  SegHeader a, b;
+  std::memcpy(&a, page, sizeof(a));
+  std::memcpy(&b, page + HDR_SLOT2, sizeof(b));
+  bool va = header_valid(a), vb = header_valid(b);
+  if (!va && !vb) return false;
+  if (va && vb) out = (b.seq > a.seq || (b.seq == a.seq && b.gen > a.gen)) ? b : a;
+  else          out = va ? a : b;
+  return true;
+}
+
+static uint64_t clock_ns(clockid_t id){
+  timespec ts{};
+  clock_gettime(id, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static void seg_path(char *buf, size_t n, const char *dir, uint32_t i){
+  std::snprintf(buf, n, "%s/seg-%03u.dlog", dir, (unsigned)i);
+}
+
+CanLog::~CanLog(){ close(); }
+
+bool CanLog::open(const CanLogOptions &opt){
+  if (is_open()) return false;
+  opt_ = opt;
+  opt_.segments = std::max<uint32_t>(opt_.segments, 2);
+  map_len_ = std::max<size_t>(size_t(opt_.segment_kb) * 1024, HDR_PAGE * 4);
+  map_len_ = (map_len_ + HDR_PAGE - 1) / HDR_PAGE * HDR_PAGE;
+  uint32_t qlen = 64;
+  while (qlen < opt_.queue_len) qlen <<= 1;
+
+  if (::mkdir(opt_.dir, 0755) < 0 && errno != EEXIST) return false;
+
+  // Allocate the whole ring up front and find the newest segment, so a
+  // restart goes on after it instead of overwriting it.
+  bool found = false;
+  uint64_t max_seq = 0;
+  uint32_t max_slot = 0;
+  for (uint32_t i = 0; i < opt_.segments; ++i) {
+    char path[512];
+    seg_path(path, sizeof(path), opt_.dir, i);
+    int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) { close(); return false; }
+    fds_.push_back(fd);
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0) { close(); return false; }
+    if (size_t(st.st_size) < map_len_) {
+      int err = posix_fallocate(fd, 0, off_t(map_len_));
+      if (err != 0) { close(); errno = err; return false; }
+    }
+    uint8_t page[HDR_PAGE];
+    SegHeader h;
+    if (pread(fd, page, sizeof(page), 0) == ssize_t(sizeof(page)) && header_read(page, h) &&
+        (!found || h.seq > max_seq)) {
+      found = true; max_seq = h.seq; max_slot = i;
+    }
+  }
+  seq_  = found ? max_seq : 0;
+  slot_ = found ? max_slot : opt_.segments - 1;
+
+  queue_.reset(new Record[qlen]);
+  mask_ = qlen - 1;
+  head_ = 0; tail_ = 0;
+  t0_ns_ = clock_ns(CLOCK_MONOTONIC);
+  wall_ns_ = int64_t(clock_ns(CLOCK_REALTIME));
+  if (!begin_segment()) { int err = errno; close(); errno = err; return false; }
+
+  run_ = true;
+  writer_ = std::thread(&CanLog::writer_main, this);
+  return true;
+}
+
+void CanLog::close(){
+  if (writer_.joinable()) {
+    run_ = false;
+    writer_.join();
+  }
+  if (map_) { munmap(map_, map_len_); map_ = nullptr; }
+  for (int fd : fds_) ::close(fd);
+  fds_.clear();
+}
+
+void CanLog::push(const TraceFrame &f, uint8_t kind){
+  if (!queue_) return;
+  uint32_t h = head_.load(std::memory_order_relaxed);
+  if (h - tail_.load(std::memory_order_acquire) > mask_) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  uint8_t *rec = queue_[h & mask_].b;
+  cantrace_encode(rec, f);
+  rec[13] = kind;
+  head_.store(h + 1, std::memory_order_release);
+  records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CanLog::frame(const CanFrame &fr){
+  push(TraceFrame{ (clock_ns(CLOCK_MONOTONIC) - t0_ns_) / 1000, fr }, CANLOG_FRAME);
+}
+
+void CanLog::signal(uint32_t channel, double value){
+  TraceFrame f{ (clock_ns(CLOCK_MONOTONIC) - t0_ns_) / 1000, { channel, 8, {} } };
+  std::memcpy(f.fr.data, &value, sizeof(value));
+  push(f, CANLOG_SIGNAL);
+}
+
+CanLogStats CanLog::stats() const {
+  return CanLogStats{ records_.load(), dropped_.load(), syncs_.load(), bytes_logged_.load(), bytes_synced_.load(),
+                      seg_cnt_.load(), map_failures_.load(), stalled_.load() };
+}
+
+// ---------- writer thread ----------
+
+static void write_header(uint8_t *map, size_t off, uint64_t seq, uint64_t gen, uint64_t records, int64_t wall_ns){
+  SegHeader h{};
+  std::memcpy(h.magic, SEG_MAGIC, 8);
+  h.version = VERSION;
+  h.record_size = CANTRACE_RECORD_SIZE;
+  h.seq = seq; h.gen = gen; h.records = records; h.wall_ns = wall_ns;
+  h.crc = crc32(&h, offsetof(SegHeader, crc));
+  std::memcpy(map + off, &h, sizeof(h));
+}
+
+// Maps the next file of the ring. Both header slots get the new seq (and no
+// records) on the card before any record goes in, so the old contents of the
+// file can never be taken for the new segment or the other way round. On a
+// failure the slot stays, so a retry maps the same file.
+bool CanLog::begin_segment(){
+  if (map_) { munmap(map_, map_len_); map_ = nullptr; }
+  uint32_t slot = (slot_ + 1) % opt_.segments;
+  void *m = mmap(nullptr, map_len_, PROT_READ | PROT_WRITE, MAP_SHARED, fds_[slot], 0);
+  if (m == MAP_FAILED) return false;
+  slot_ = slot;
+  map_ = static_cast<uint8_t *>(m);
+  madvise(map_, map_len_, MADV_SEQUENTIAL);
+
+  ++seq_;
+  write_header(map_, 0, seq_, 0, 0, wall_ns_);
+  write_header(map_, HDR_SLOT2, seq_, 0, 0, wall_ns_);
+  msync(map_, HDR_PAGE, MS_SYNC);
+  gen_ = 1;
+  pos_ = synced_pos_ = 0;
+  seg_cnt_.fetch_add(1, std::memory_order_relaxed);
+  bytes_synced_.fetch_add(HDR_PAGE, std::memory_order_relaxed);
+  return true;
+}
+
+// Data first, then the header slot not written last time.
+void CanLog::sync(bool final){
+  if (!map_ || (pos_ == synced_pos_ && !final)) return;
+  size_t from = (HDR_PAGE + synced_pos_) / HDR_PAGE * HDR_PAGE;
+  size_t to = (HDR_PAGE + pos_ + HDR_PAGE - 1) / HDR_PAGE * HDR_PAGE;
+  if (to > from) msync(map_ + from, to - from, MS_SYNC);
+  write_header(map_, (gen_ & 1) ? HDR_SLOT2 : 0, seq_, gen_, pos_ / CANTRACE_RECORD_SIZE, wall_ns_);
+  msync(map_, HDR_PAGE, MS_SYNC);
+  ++gen_;
+
+  syncs_.fetch_add(1, std::memory_order_relaxed);
+  bytes_logged_.fetch_add(pos_ - synced_pos_, std::memory_order_relaxed);
+  bytes_synced_.fetch_add((to - from) + HDR_PAGE, std::memory_order_relaxed);
+  synced_pos_ = pos_;
+}
+
+// begin_segment(), backing off after a failure: until a segment maps again the
+// records wait in the queue, and only what overflows it is dropped.
+bool CanLog::next_segment(){
+  uint64_t now = clock_ns(CLOCK_MONOTONIC);
+  if (now < retry_ns_) return false;
+  if (begin_segment()) {
+    if (backoff_ns_) std::fprintf(stderr, "canlog: %s segment %u mapped again\n", opt_.dir, (unsigned)slot_);
+    backoff_ns_ = retry_ns_ = 0;
+    stalled_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+  int err = errno;
+  map_failures_.fetch_add(1, std::memory_order_relaxed);
+  stalled_.store(true, std::memory_order_relaxed);
+  if (!backoff_ns_)  // once per streak, stats() has the count
+    std::fprintf(stderr, "canlog: can't map %s segment %u: %s, retrying\n", opt_.dir,
+                 (unsigned)((slot_ + 1) % opt_.segments), std::strerror(err));
+  backoff_ns_ = backoff_ns_ ? std::min(backoff_ns_ * 2, RETRY_MAX_NS) : RETRY_MIN_NS;
+  retry_ns_ = now + backoff_ns_;
+  return false;
+}
+
+// Queue to segment; page faults and rollovers happen here, not in the UI.
+bool CanLog::drain(){
+  uint32_t t = tail_.load(std::memory_order_relaxed);
+  uint32_t h = head_.load(std::memory_order_acquire);
+  const uint32_t t0 = t;
+  for (; t != h; ++t) {
+    if (!map_ || HDR_PAGE + pos_ + CANTRACE_RECORD_SIZE > map_len_) {
+      sync(true);
+      if (!next_segment()) break;
+    }
+    std::memcpy(map_ + HDR_PAGE + pos_, queue_[t & mask_].b, CANTRACE_RECORD_SIZE);
+    pos_ += CANTRACE_RECORD_SIZE;
+  }
+  tail_.store(t, std::memory_order_release);
+  return t != t0;
+}
+
+void CanLog::writer_main(){
+  // Below the UI loop: on a busy core the copy and the syncs wait, not a refresh.
+  setpriority(PRIO_PROCESS, pid_t(syscall(SYS_gettid)), WRITER_NICE);
+  uint64_t next_sync = clock_ns(CLOCK_MONOTONIC) + uint64_t(opt_.sync_ms) * 1000000ull;
+  while (run_.load(std::memory_order_relaxed)) {
+    drain();
+    uint64_t now = clock_ns(CLOCK_MONOTONIC);
+    if (now >= next_sync) {
+      sync(false);
+      next_sync = now + uint64_t(opt_.sync_ms) * 1000000ull;
+    }
+    timespec ts{ 0, long(POLL_MS) * 1000000L };
+    nanosleep(&ts, nullptr);
+  }
+  // One more try for a stalled log; what still can't be written is lost with
+  // the queue.
+  retry_ns_ = 0;
+  drain();
+  sync(true);
+  uint32_t left = head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+  if (left) dropped_.fetch_add(left, std::memory_order_relaxed);
+}
+
+// ---------- reader ----------
+
+struct SegInfo {
+  std::string path;
+  SegHeader   h;
+};
+
+static bool seg_info(const std::string &path, SegInfo &out){
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  uint8_t page[HDR_PAGE];
+  bool ok = pread(fd, page, sizeof(page), 0) == ssize_t(sizeof(page)) && header_read(page, out.h);
+  ::close(fd);
+  out.path = path;
+  return ok;
+}
+
+bool canlog_load(const char *path, std::vector<TraceFrame> &tr){
+  struct stat st{};
+  if (stat(path, &st) < 0) return false;
+  std::vector<SegInfo> segs;
+  if (S_ISDIR(st.st_mode)) {
+    DIR *d = opendir(path);
+    if (!d) return false;
+    while (dirent *e = readdir(d)) {
+      size_t len = std::strlen(e->d_name);
+      if (std::strncmp(e->d_name, "seg-", 4) != 0 || len < 5 || std::strcmp(e->d_name + len - 5, ".dlog") != 0) continue;
+      SegInfo si;
+      if (seg_info(std::string(path) + "/" + e->d_name, si)) segs.push_back(si);
+    }
+    closedir(d);
+  } else {
+    SegInfo si;
+    if (!seg_info(path, si)) return false;
+    segs.push_back(si);
+  }
+  std::sort(segs.begin(), segs.end(), [](const SegInfo &a, const SegInfo &b){ return a.h.seq < b.h.seq; });
+
+  bool have_t0 = false;
+  int64_t t0_us = 0;
+  std::vector<uint8_t> buf;
+  for (const SegInfo &si : segs) {
+    FILE *f = std::fopen(si.path.c_str(), "rb");
+    if (!f) continue;
+    buf.resize(size_t(si.h.records) * CANTRACE_RECORD_SIZE);
+    size_t n = (std::fseek(f, long(HDR_PAGE), SEEK_SET) == 0) ? std::fread(buf.data(), 1, buf.size(), f) : 0;
+    std::fclose(f);
+    for (size_t off = 0; off + CANTRACE_RECORD_SIZE <= n; off += CANTRACE_RECORD_SIZE) {
+      if (buf[off + 13] != CANLOG_FRAME) continue;
+      TraceFrame tf = cantrace_decode(&buf[off]);
+      int64_t wall_us = si.h.wall_ns / 1000 + int64_t(tf.t_us);
+      if (!have_t0) { t0_us = wall_us; have_t0 = true; }
+      tf.t_us = uint64_t(std::max<int64_t>(0, wall_us - t0_us));
+      tr.push_back(tf);
+    }
+  }
+  return true;
+}
+
+bool canlog_is_log(const char *path){
+  struct stat st{};
+  if (stat(path, &st) < 0) return false;
+  if (S_ISDIR(st.st_mode)) return true;
+  FILE *f = std::fopen(path, "rb");
+  if (!f) return false;
+  char head[8] = {};
+  size_t n = std::fread(head, 1, sizeof(head), f);
+  std::fclose(f);
+  return n == 8 && std::memcmp(head, SEG_MAGIC, 8) == 0;
+}
@@ -0,0 +1,113 @@
+#pragma once
+// On-car data logger: every CAN frame (and, if asked, decoded signals) into a
+// ring of preallocated segment files, memory mapped.
+//
+// The UI thread only copies a 24 byte record into an in-memory queue, no
+// syscalls and no locks. A writer thread moves the queue into the mapped
+// segment and msyncs every sync_ms: first the data, then the segment header.
+// The header has two CRC'd slots written in turn, so a crash or power cut
+// loses at most the last sync_ms and never leaves a segment without a valid
+// header. Writes to the card are bounded too: the files are allocated once
+// and reused round robin (no metadata churn), and a sync writes the new data
+// plus at most one partial data page and the header page again.
+//
+// Records are cantrace's binary records (cantrace.hpp); canlog_load() reads
+// a log directory or a single segment back.
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "cantrace.hpp"
+
+struct CanLogOptions {
+  const char *dir      = "/var/log/dash";
+  uint32_t segment_kb  = 8192;   // per file, ~34 min at 170 frames/s, ~3.5 min at 1700/s
+  uint32_t segments    = 32;     // files in the ring
+  uint32_t sync_ms     = 1000;   // at most this much is lost on a crash
+  // Records between the UI and the writer, power of 2. They last queue_len / rate:
+  // 16384 is ~95 s of the dash's ~170 frames/s, ~10 s at 1700/s, ~2.5 s of a
+  // saturated 1 Mbit/s bus (~6500 frames/s, cangen flat out on a real bus).
+  uint32_t queue_len   = 16384;
+};
+
+struct CanLogStats {
+  uint64_t records;       // taken by frame()/signal()
+  uint64_t dropped;       // queue full, or still queued at close() with no segment mapped
+  uint64_t syncs;
+  uint64_t bytes_logged;  // records synced, in bytes
+  uint64_t bytes_synced;  // data and header pages msync'd
+  uint64_t segments;      // started since open()
+  uint64_t map_failures;  // segment mmaps that failed; the records wait in the queue meanwhile
+  bool     stalled;       // no segment mapped right now, retrying
+};
+
+class CanLog {
+public:
+  CanLog() = default;
+  ~CanLog();
+  CanLog(const CanLog &) = delete;
+  CanLog &operator=(const CanLog &) = delete;
+
+  // Creates or reuses the ring in opt.dir and starts the writer thread.
+  // False (with errno) if the directory or the files can't be set up.
+  bool open(const CanLogOptions &opt);
+  // Flushes the queue, syncs and stops the writer.
+  void close();
+  bool is_open() const { return run_.load(std::memory_order_relaxed); }
+
+  // Producer side, one thread (the UI loop). Never blocks: a full queue drops
+  // the record and counts it.
+  void frame(const CanFrame &fr);
+  void signal(uint32_t channel, double value);
+
+  CanLogStats stats() const;
+
+private:
+  struct Record { uint8_t b[CANTRACE_RECORD_SIZE]; };
+
+  void push(const TraceFrame &f, uint8_t kind);
+  void writer_main();
+  bool drain();
+  bool begin_segment();
+  bool next_segment();
+  void sync(bool final);
+
+  CanLogOptions opt_{};
+  std::vector<int> fds_;
+  std::unique_ptr<Record[]> queue_;
+  uint32_t mask_ = 0;
+  alignas(64) std::atomic<uint32_t> head_{0};  // written by the producer
+  alignas(64) std::atomic<uint32_t> tail_{0};  // written by the writer
+  alignas(64) std::atomic<uint64_t> records_{0}, dropped_{0};
+  std::atomic<uint64_t> syncs_{0}, bytes_logged_{0}, bytes_synced_{0}, seg_cnt_{0}, map_failures_{0};
+  std::atomic<bool> stalled_{false};
+
+  std::atomic<bool> run_{false};
+  std::thread writer_;
+  uint64_t t0_ns_ = 0;
+  int64_t  wall_ns_ = 0;
+
+  // Writer thread only.
+  uint8_t *map_ = nullptr;
+  size_t   map_len_ = 0;
+  uint32_t slot_ = 0;        // file index in the ring
+  uint64_t seq_ = 0;         // segment number, increasing across the ring and restarts
+  uint64_t gen_ = 0;         // header writes of this segment
+  size_t   pos_ = 0;         // bytes of records in the segment
+  size_t   synced_pos_ = 0;
+  uint64_t retry_ns_ = 0;    // next_segment() waits until then after a failure
+  uint64_t backoff_ns_ = 0;  // 0 while segments map
+};
+
+// Record kinds (byte 13 of a record): raw frames read back by cantrace, and
+// decoded signals (id = channel, data = the double value).
+static constexpr uint8_t CANLOG_FRAME  = 0;
+static constexpr uint8_t CANLOG_SIGNAL = 1;
+
+// Frames of a log directory (or one segment file) in time order, on the wall
+// clock of the sessions, relative to the first frame.
+bool canlog_load(const char *path, std::vector<TraceFrame> &tr);
+// True for a directory or a file starting with a segment header: what
+// canlog_load() reads rather than cantrace_load().
+bool canlog_is_log(const char *path);
@@ -0,0 +1,40 @@
+#include "cansignals.hpp"
+#include "fixedpoint.hpp"
+
+const char *const DASH_CHANNEL_NAMES[CH_COUNT] = { "rpm", "coolant_c", "kph", "oil_kpa", "volt", "gear" };
+const uint8_t DASH_CHANNEL_DECIMALS[CH_COUNT] = { 0, 0, 1, 2, 1, 0 };
+
+static inline ChannelFixed u16_auto(DashChannel ch, const uint8_t *d){
+  uint16_t le = uint16_t(d[0] | (uint16_t(d[1]) << 8));
+  if (le) return { ch, false, le };
+  return { ch, true, uint16_t((uint16_t(d[0]) << 8) | d[1]) };
+}
+
+int can_decode_fixed(const CanFrame &fr, ChannelFixed out[2]){
+  const uint8_t *d = fr.data;
+  switch (fr.id & 0x1FFFFFFF) {
+    case 0x2000:
+      out[0] = u16_auto(CH_RPM, &d[0]);
+      out[1] = u16_auto(CH_COOLANT_C, &d[4]);
+      return 2;
+    case 0x2001:
+      out[0] = u16_auto(CH_KPH, &d[4]);
+      out[1] = u16_auto(CH_OIL_KPA, &d[6]);
+      return 2;
+    case 0x2002:
+      out[0] = u16_auto(CH_VOLT, &d[4]);
+      return 1;
+    case 0x2003:
+      out[0] = { CH_GEAR, false, d[0] ? d[0] : d[1] };
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+int can_decode(const CanFrame &fr, ChannelSample out[2]){
+  ChannelFixed f[2];
+  int n = can_decode_fixed(fr, f);
+  for (int i = 0; i < n; ++i) out[i] = { f[i].ch, double(f[i].v) / fx_pow10(DASH_CHANNEL_DECIMALS[f[i].ch]) };
+  return n;
+}
@@ -0,0 +1,38 @@
+#pragma once
+// The dash's CAN map (see dashui.cpp) as named channels in engineering units,
+// for everything that wants values rather than frames: the dash's handlers,
+// the columnar logs (chanlog.hpp) and the tools. can_decode_fixed() gives the
+// scaled integers of fixedpoint.hpp, can_decode() doubles.
+#include <cstdint>
+#include "socketcan.hpp"
+
+enum DashChannel : uint8_t {
+  CH_RPM,        // 0x2000 @ 0..1, rpm
+  CH_COOLANT_C,  // 0x2000 @ 4..5, °C
+  CH_KPH,        // 0x2001 @ 4..5, / 10
+  CH_OIL_KPA,    // 0x2001 @ 6..7, / 100
+  CH_VOLT,       // 0x2002 @ 4..5, / 10
+  CH_GEAR,       // 0x2003 @ 0 or 1, 0 = N
+  CH_COUNT
+};
+
+// "rpm", "coolant_c", "kph", "oil_kpa", "volt", "gear".
+extern const char *const DASH_CHANNEL_NAMES[CH_COUNT];
+// Decimals of each channel as sent: 0, 0, 1, 2, 1, 0.
+extern const uint8_t DASH_CHANNEL_DECIMALS[CH_COUNT];
+
+struct ChannelSample {
+  DashChannel ch;
+  double      v;
+};
+
+struct ChannelFixed {
+  DashChannel ch;
+  bool        be;   // the U16 was big endian
+  int32_t     v;    // in 10^-DASH_CHANNEL_DECIMALS[ch] of the unit
+};
+
+// The channels carried by fr, at most 2; 0 for ids not in the map. U16s are
+// little endian, big endian when the LE value is 0.
+int can_decode_fixed(const CanFrame &fr, ChannelFixed out[2]);
+int can_decode(const CanFrame &fr, ChannelSample out[2]);
@@ -0,0 +1,199 @@
+#include "cantrace.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <utility>
+
+static constexpr uint64_t GEAR_US = 2500000;
+static constexpr uint32_t IDS[4] = { 0x2000, 0x2001, 0x2002, 0x2003 };
+static constexpr uint32_t DIVIDERS[4] = { 1, 2, 10, 10 };  // of rpm_hz
+
+DriveSample drive_at(uint64_t t_us){
+  DriveSample s{};
+  s.gear = 1 + uint32_t(t_us / GEAR_US) % 6;
+  double x = double(t_us % GEAR_US) / double(GEAR_US);
+  s.rpm = uint32_t(3000 + 4200 * x);
+  s.kph = s.rpm * s.gear * 0.0047;
+  s.oil_kpa = 200 + s.rpm / 20.0;
+  s.coolant_c = 85 + double(t_us % 150000000) / 10000000;  // creeps up to 100 in 150 s
+  s.volt = 13.7;
+  return s;
+}
+
+static void put_u16(uint8_t *d, double v){
+  uint32_t u = uint32_t(std::clamp(v, 0.0, 65535.0));
+  d[0] = uint8_t(u);
+  d[1] = uint8_t(u >> 8);
+}
+
+DriveSchedule::DriveSchedule(uint32_t rpm_hz){
+  if (rpm_hz == 0) rpm_hz = 1;
+  for (int i = 0; i < 4; ++i) {
+    period_us_[i] = std::max<uint64_t>(1, 1000000ull * DIVIDERS[i] / rpm_hz);
+    due_us_[i] = 0;
+  }
+}
+
+TraceFrame DriveSchedule::next(){
+  int i = int(std::min_element(due_us_, due_us_ + 4) - due_us_);
+  TraceFrame f{ due_us_[i], { IDS[i], 8, {} } };
+  due_us_[i] += period_us_[i];
+
+  // A bit of sensor noise, xorshift so every run sends the same frames.
+  rng_ ^= rng_ << 13; rng_ ^= rng_ >> 17; rng_ ^= rng_ << 5;
+  double noise = double(rng_ % 1000) / 1000.0;
+
+  DriveSample s = drive_at(f.t_us);
+  uint8_t *d = f.fr.data;
+  switch (IDS[i]) {
+    case 0x2000: put_u16(&d[0], s.rpm + noise * 20); put_u16(&d[4], s.coolant_c); break;
+    case 0x2001: put_u16(&d[4], s.kph * 10);         put_u16(&d[6], (s.oil_kpa + noise * 5) * 100); break;
+    case 0x2002: put_u16(&d[4], (s.volt + noise * 0.3) * 10); break;
+    case 0x2003: d[0] = uint8_t(s.gear); break;
+  }
+  return f;
+}
+
+std::vector<TraceFrame> cantrace_synth(uint64_t duration_us, uint32_t rpm_hz){
+  std::vector<TraceFrame> tr;
+  DriveSchedule sched(rpm_hz);
+  for (TraceFrame f = sched.next(); f.t_us < duration_us; f = sched.next()) tr.push_back(f);
+  return tr;
+}
+
+bool cantrace_load_candump(const char *path, std::vector<TraceFrame> &tr){
+  FILE *f = std::fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  double t0 = -1;
+  while (std::fgets(line, sizeof(line), f)) {
+    double ts;
+    unsigned id;
+    char data[160];
+    if (std::sscanf(line, " (%lf) %*s %x#%159s", &ts, &id, data) != 3) continue;
+    if (data[0] == '#' || data[0] == 'R') continue;
+    if (t0 < 0) t0 = ts;
+
+    TraceFrame tf{ uint64_t((ts - t0) * 1e6), { id, 0, {} } };
+    size_t len = std::strlen(data);
+    for (size_t i = 0; i + 1 < len && tf.fr.dlc < 8; i += 2) {
+      char hex[3] = { data[i], data[i + 1], 0 };
+      tf.fr.data[tf.fr.dlc++] = uint8_t(std::strtoul(hex, nullptr, 16));
+    }
+    tr.push_back(tf);
+  }
+  std::fclose(f);
+  return true;
+}
+
+bool cantrace_load_asc(const char *path, std::vector<TraceFrame> &tr){
+  FILE *f = std::fopen(path, "r");
+  if (!f) return false;
+  char line[512];
+  bool hex = true;
+  double t0 = -1;
+  while (std::fgets(line, sizeof(line), f)) {
+    if (std::strncmp(line, "base ", 5) == 0) { hex = std::strncmp(line + 5, "hex", 3) == 0; continue; }
+    double ts;
+    unsigned chan, dlc;
+    char id_s[16], dir[8], type;
+    int used = 0;
+    if (std::sscanf(line, " %lf %u %15s %7s %c %u%n", &ts, &chan, id_s, dir, &type, &dlc, &used) != 6) continue;
+    if (type != 'd' || dlc > 8) continue;
+    if (t0 < 0) t0 = ts;
+
+    TraceFrame tf{ uint64_t((ts - t0) * 1e6), { uint32_t(std::strtoul(id_s, nullptr, hex ? 16 : 10)), 0, {} } };
+    const char *p = line + used;
+    for (unsigned i = 0; i < dlc; ++i) {
+      char *end;
+      unsigned long b = std::strtoul(p, &end, hex ? 16 : 10);
+      if (end == p) break;
+      tf.fr.data[tf.fr.dlc++] = uint8_t(b);
+      p = end;
+    }
+    tr.push_back(tf);
+  }
+  std::fclose(f);
+  return true;
+}
+
+static constexpr char BIN_MAGIC[8] = { 'D', 'A', 'S', 'H', 'C', 'A', 'N', '1' };
+
+void cantrace_encode(uint8_t *rec, const TraceFrame &f){
+  std::memset(rec, 0, CANTRACE_RECORD_SIZE);
+  for (int i = 0; i < 8; ++i) rec[i] = uint8_t(f.t_us >> (8 * i));
+  for (int i = 0; i < 4; ++i) rec[8 + i] = uint8_t(f.fr.id >> (8 * i));
+  rec[12] = f.fr.dlc;
+  std::memcpy(rec + 16, f.fr.data, 8);
+}
+
+TraceFrame cantrace_decode(const uint8_t *rec){
+  TraceFrame f{};
+  for (int i = 0; i < 8; ++i) f.t_us |= uint64_t(rec[i]) << (8 * i);
+  for (int i = 0; i < 4; ++i) f.fr.id |= uint32_t(rec[8 + i]) << (8 * i);
+  f.fr.dlc = std::min<uint8_t>(rec[12], 8);
+  std::memcpy(f.fr.data, rec + 16, 8);
+  return f;
+}
+
+bool cantrace_load_bin(const char *path, std::vector<TraceFrame> &tr){
+  FILE *f = std::fopen(path, "rb");
+  if (!f) return false;
+  char magic[8];
+  bool ok = std::fread(magic, 1, 8, f) == 8 && std::memcmp(magic, BIN_MAGIC, 8) == 0;
+  uint8_t rec[CANTRACE_RECORD_SIZE];
+  while (ok && std::fread(rec, 1, sizeof(rec), f) == sizeof(rec))
+    if (rec[13] == 0) tr.push_back(cantrace_decode(rec));
+  std::fclose(f);
+  return ok;
+}
+
+bool cantrace_save_bin(const char *path, const std::vector<TraceFrame> &tr){
+  FILE *f = std::fopen(path, "wb");
+  if (!f) return false;
+  bool ok = std::fwrite(BIN_MAGIC, 1, 8, f) == 8;
+  uint8_t rec[CANTRACE_RECORD_SIZE];
+  for (size_t i = 0; ok && i < tr.size(); ++i) {
+    cantrace_encode(rec, tr[i]);
+    ok = std::fwrite(rec, 1, sizeof(rec), f) == sizeof(rec);
+  }
+  return std::fclose(f) == 0 && ok;
+}
+
+bool cantrace_load(const char *path, std::vector<TraceFrame> &tr){
+  FILE *f = std::fopen(path, "rb");
+  if (!f) return false;
+  char head[8] = {};
+  size_t n = std::fread(head, 1, sizeof(head), f);
+  std::fclose(f);
+  if (n == 8 && std::memcmp(head, BIN_MAGIC, 8) == 0) return cantrace_load_bin(path, tr);
+  size_t i = 0;
+  while (i < n && (head[i] == ' ' || head[i] == '\t' || head[i] == '\n' || head[i] == '\r')) ++i;
+  if (i < n && head[i] == '(') return cantrace_load_candump(path, tr);
+  return cantrace_load_asc(path, tr);
+}
+
+CanReplay::CanReplay(std::vector<TraceFrame> trace, double speed, bool loop)
+    : trace_(std::move(trace)), speed_(speed < 0 ? 1.0 : speed), loop_(loop && !trace_.empty()) {}
+
+std::optional<CanFrame> CanReplay::read_nonblock(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return read_due(uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec));
+}
+
+std::optional<CanFrame> CanReplay::read_due(uint64_t now_ns){
+  if (!started_) { start_ns_ = now_ns; started_ = true; }
+  if (pos_ == trace_.size()) {
+    if (!loop_) return std::nullopt;
+    offset_us_ += trace_.back().t_us + 10000;
+    pos_ = 0;
+  }
+  const TraceFrame &f = trace_[pos_];
+  if (speed_ > 0 && start_ns_ + uint64_t(double(f.t_us + offset_us_) * 1000.0 / speed_) > now_ns) return std::nullopt;
+  ++pos_;
+  ++read_;
+  return f.fr;
+}
@@ -0,0 +1,92 @@
+#pragma once
+// CAN traffic of the dash's CAN map (see dashui.cpp) without a car: a
+// synthetic drive with time-correlated rpm, speed, gear, oil and voltage, and
+// recorded logs played back with their timing. Used by tools/cangen to feed a
+// vcan interface, and by main.cpp (-r) and bench/dash_bench to feed the
+// handlers directly.
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "socketcan.hpp"
+
+struct TraceFrame {
+  uint64_t t_us;  // from the start of the trace
+  CanFrame fr;
+};
+
+// The synthetic drive: pulls from 3000 to 7200 rpm in every gear (2.5 s each),
+// 1st to 6th and over again; speed follows rpm and gear.
+struct DriveSample {
+  uint32_t rpm;
+  uint32_t gear;
+  double   kph;
+  double   oil_kpa;
+  double   coolant_c;
+  double   volt;
+};
+
+DriveSample drive_at(uint64_t t_us);
+
+// Frames of the drive in time order: 0x2000 at rpm_hz, 0x2001 at rpm_hz / 2,
+// 0x2002 and 0x2003 at rpm_hz / 10, each encoded from drive_at() at its time.
+class DriveSchedule {
+public:
+  explicit DriveSchedule(uint32_t rpm_hz = 100);
+  TraceFrame next();
+
+private:
+  uint64_t period_us_[4];
+  uint64_t due_us_[4];
+  uint32_t rng_ = 0x12345678u;
+};
+
+// The first duration_us of the drive.
+std::vector<TraceFrame> cantrace_synth(uint64_t duration_us, uint32_t rpm_hz = 100);
+
+// Reads a candump -l log, "(1436509052.249713) can0 00002000#1A2B3C4D".
+// FD and remote frames are skipped. Times are made relative to the first frame.
+bool cantrace_load_candump(const char *path, std::vector<TraceFrame> &tr);
+
+// Reads a Vector ASC log, "   0.012000 1  2000x  Rx   d 8 1A 2B 3C 4D 00 00 00 00".
+// Hex or decimal ids ("base"), remote, error and FD lines are skipped.
+bool cantrace_load_asc(const char *path, std::vector<TraceFrame> &tr);
+
+// Our binary trace: the 8 byte magic "DASHCAN1", then one 24 byte record per
+// frame, little endian: u64 t_us, u32 id, u8 dlc, u8 kind, 2 zero bytes, 8 data
+// bytes. kind is 0 for frames; canlog.hpp also writes decoded signals, which
+// the loaders skip.
+static constexpr size_t CANTRACE_RECORD_SIZE = 24;
+void cantrace_encode(uint8_t *rec, const TraceFrame &f);
+TraceFrame cantrace_decode(const uint8_t *rec);
+bool cantrace_load_bin(const char *path, std::vector<TraceFrame> &tr);
+bool cantrace_save_bin(const char *path, const std::vector<TraceFrame> &tr);
+
+// Any of the three, told apart by the content. canlog directories and
+// segments are canlog_load()'s (canlog.hpp).
+bool cantrace_load(const char *path, std::vector<TraceFrame> &tr);
+
+// Plays a trace back in the shape of SocketCan::read_nonblock(): a frame comes
+// out once its time has come, on CLOCK_MONOTONIC from the first read. speed 1
+// is the original timing, 2 twice as fast; speed 0 drops the timing and hands
+// out every frame at once, for throughput runs. With loop the trace starts
+// over 10 ms after its last frame.
+class CanReplay {
+public:
+  explicit CanReplay(std::vector<TraceFrame> trace, double speed = 1.0, bool loop = false);
+
+  std::optional<CanFrame> read_nonblock();
+  std::optional<CanFrame> read_due(uint64_t now_ns);
+
+  bool done() const { return !loop_ && pos_ == trace_.size(); }
+  uint64_t frames_read() const { return read_; }
+
+private:
+  std::vector<TraceFrame> trace_;
+  double   speed_;
+  bool     loop_;
+  size_t   pos_ = 0;
+  uint64_t offset_us_ = 0;
+  uint64_t start_ns_ = 0;
+  bool     started_ = false;
+  uint64_t read_ = 0;
+};
@@ -0,0 +1,193 @@
+#include "chanfilter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "fixedpoint.hpp"
+
+static constexpr int64_t  ONE = 65536;                  // 1.0 of the channel's scale in 16.16
+static constexpr int64_t  US_PER_S = 1000000;
+static constexpr uint64_t SLEW_MAX_DT_US = 10 * US_PER_S;  // a longer gap jumps anyway
+
+static const char *const KIND_NAMES[] = { "none", "ewma", "median", "slew", "deadband" };
+
+bool FilterSpec::operator==(const FilterSpec &o) const {
+  if (n != o.n) return false;
+  for (int i = 0; i < n; ++i)
+    if (stage[i].kind != o.stage[i].kind || stage[i].param != o.stage[i].param) return false;
+  return true;
+}
+
+// ---------- parsing ----------
+static bool parse_stage(const char *s, const char *end, unsigned dec, FilterStage &out, std::string &err){
+  while (s < end && (*s == ' ' || *s == '\t')) ++s;
+  while (end > s && (end[-1] == ' ' || end[-1] == '\t')) --end;
+  std::string word(s, end);
+  size_t sp = word.find_first_of(" \t");
+  std::string name = word.substr(0, sp);
+  std::string arg = sp == std::string::npos ? std::string() : word.substr(word.find_first_not_of(" \t", sp));
+
+  int kind = 0;
+  for (int k = FILTER_EWMA; k <= FILTER_DEADBAND; ++k)
+    if (name == KIND_NAMES[k]) kind = k;
+  if (!kind) { err = "unknown filter '" + name + "'"; return false; }
+
+  char *e = nullptr;
+  errno = 0;
+  double v = std::strtod(arg.c_str(), &e);
+  if (arg.empty() || *e || errno || !std::isfinite(v)) { err = name + " needs a number"; return false; }
+
+  out.kind = FilterKind(kind);
+  switch (out.kind) {
+    case FILTER_EWMA:
+      if (v <= 0 || v > 1) { err = "ewma alpha must be in (0, 1]"; return false; }
+      out.param = int32_t(fx_alpha(v));
+      break;
+    case FILTER_MEDIAN:
+      if (v != std::floor(v) || v < 1 || v > FILTER_MEDIAN_MAX || int(v) % 2 == 0) {
+        err = "median window must be odd, 1.." + std::to_string(FILTER_MEDIAN_MAX);
+        return false;
+      }
+      out.param = int32_t(v);
+      break;
+    case FILTER_SLEW:
+    case FILTER_DEADBAND: {
+      double scaled = std::round(v * fx_pow10(dec));
+      if (scaled <= 0 || scaled > 1e6) { err = name + " must be above 0 and at most 1e6 units"; return false; }
+      out.param = int32_t(scaled);
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
+
+bool filter_parse(const char *text, unsigned dec, FilterSpec &out, std::string &err){
+  FilterSpec spec{};
+  const char *s = text;
+  while (*s == ' ' || *s == '\t') ++s;
+  if (*s && std::strcmp(s, "none") != 0) {
+    for (;;) {
+      const char *comma = std::strchr(s, ',');
+      const char *end = comma ? comma : s + std::strlen(s);
+      if (spec.n == FILTER_STAGES) { err = "more than " + std::to_string(FILTER_STAGES) + " stages"; return false; }
+      if (!parse_stage(s, end, dec, spec.stage[spec.n], err)) return false;
+      ++spec.n;
+      if (!comma) break;
+      s = comma + 1;
+    }
+  }
+  out = spec;
+  return true;
+}
+
+std::string filter_format(const FilterSpec &spec, unsigned dec){
+  if (spec.n == 0) return "none";
+  std::string out;
+  char buf[48];
+  for (int i = 0; i < spec.n; ++i) {
+    const FilterStage &f = spec.stage[i];
+    if (i) out += ", ";
+    out += KIND_NAMES[f.kind];
+    out += ' ';
+    switch (f.kind) {
+      case FILTER_EWMA:     std::snprintf(buf, sizeof(buf), "%g", f.param / 16777216.0); break;
+      case FILTER_MEDIAN:   std::snprintf(buf, sizeof(buf), "%d", (int)f.param); break;
+      default:              fx_format(buf, f.param, dec); break;
+    }
+    out += buf;
+  }
+  return out;
+}
+
+// ---------- the chain ----------
+void FilterChain::configure(const FilterSpec &spec){
+  spec_ = spec;
+  reset();
+}
+
+void FilterChain::reset(){
+  for (State &s : state_) s = State{};
+}
+
+int32_t FilterChain::apply(int32_t x, uint64_t t_ns, unsigned drop){
+  if (spec_.n == 0 && drop == 0) return x;
+  int64_t v = int64_t(x) * ONE;
+  for (int i = 0; i < spec_.n; ++i) v = stage_apply(spec_.stage[i], state_[i], v, t_ns);
+  return int32_t(fx_div_round(v, ONE * fx_pow10(drop)));
+}
+
+int64_t FilterChain::stage_apply(const FilterStage &f, State &s, int64_t x, uint64_t t_ns){
+  if (!s.init) {
+    // The first sample passes as is; the median still has to take it in.
+    s.init = true;
+    s.out = x;
+    s.carry = 0;
+    s.t_ns = t_ns;
+    s.head = s.count = 0;
+    if (f.kind != FILTER_MEDIAN) return x;
+  }
+
+  switch (f.kind) {
+    case FILTER_EWMA:
+      // In 16.16 the difference takes up to 41 bits and alpha 25: 128-bit product.
+      s.out += int64_t(__int128(x - s.out) * f.param / 16777216);
+      break;
+
+    case FILTER_MEDIAN: {
+      const int n = f.param;
+      const int cnt = s.count;
+      if (cnt == n) {
+        // The new sample takes the oldest one's place in the sorted copy and
+        // slides to its rank: only the samples between the two move.
+        int64_t old = s.win[s.head];
+        int i = int(std::lower_bound(s.sorted, s.sorted + cnt, old) - s.sorted);
+        while (i + 1 < cnt && s.sorted[i + 1] < x) { s.sorted[i] = s.sorted[i + 1]; ++i; }
+        while (i > 0 && s.sorted[i - 1] > x) { s.sorted[i] = s.sorted[i - 1]; --i; }
+        s.sorted[i] = x;
+      } else {
+        int i = cnt;
+        while (i > 0 && s.sorted[i - 1] > x) { s.sorted[i] = s.sorted[i - 1]; --i; }
+        s.sorted[i] = x;
+        s.count = uint8_t(cnt + 1);
+      }
+      s.win[s.head] = x;
+      s.head = uint8_t(s.head + 1 == n ? 0 : s.head + 1);
+      s.out = s.sorted[s.count / 2];
+      break;
+    }
+
+    case FILTER_SLEW: {
+      uint64_t dt = t_ns > s.t_ns ? (t_ns - s.t_ns) / 1000 : 0;
+      s.t_ns = t_ns;
+      if (dt > SLEW_MAX_DT_US) dt = SLEW_MAX_DT_US;
+      // What is not used of a step carries over to the next sample.
+      int64_t budget = s.carry + int64_t(f.param) * ONE * int64_t(dt);
+      int64_t step = budget / US_PER_S;
+      int64_t diff = x - s.out;
+      if (diff <= step && -diff <= step) {
+        s.out = x;
+        s.carry = 0;
+      } else {
+        s.out += diff > 0 ? step : -step;
+        s.carry = budget - step * US_PER_S;
+      }
+      break;
+    }
+
+    case FILTER_DEADBAND: {
+      int64_t diff = x - s.out;
+      int64_t band = int64_t(f.param) * ONE;
+      if (diff >= band || -diff >= band) s.out = x;
+      break;
+    }
+
+    default:
+      s.out = x;
+      break;
+  }
+  return s.out;
+}
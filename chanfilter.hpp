@@ -0,0 +1,101 @@
+#pragma once
+// Per-channel filters, run on each sample as its frame arrives. A chain is up
+// to FILTER_STAGES stages, applied in order to the scaled integers of
+// can_decode_fixed() (fixedpoint.hpp):
+//   ewma A        exponential moving average, alpha A (0..1)
+//   median N      moving median of the last N samples, N odd, up to FILTER_MEDIAN_MAX
+//   slew R        output follows at most R units per second (kph/s, rpm/s...)
+//   deadband B    output moves only once the input is B units away from it
+// Written as in the config file (dashconfig.hpp), e.g.
+//   filter.oil_kpa = median 5, ewma 0.05
+//   filter.kph     = slew 40
+// Parameters are in the channel's unit and become its scale on parsing.
+// Between stages a value keeps 16 bits of fraction below the channel's scale,
+// so an average is rounded once, to the decimals the caller asks for.
+// All state lives in the chain, so applying a sample never allocates. Every
+// stage is O(1) except median: it finds the oldest sample in a sorted copy of
+// the window (O(log N)) and moves only the samples ranked between it and the
+// new one, at most N-1. With N <= FILTER_MEDIAN_MAX (15) that is a bounded few
+// dozen compares in one cache line or two, less than a two-heap median would
+// spend on its bookkeeping.
+//
+// FxHysteresis is the other half: an on/off state with separate on and off
+// thresholds, for warnings that should not flicker around a limit.
+#include <cstdint>
+#include <string>
+
+static constexpr int FILTER_STAGES = 4;
+static constexpr int FILTER_MEDIAN_MAX = 15;
+
+enum FilterKind : uint8_t { FILTER_NONE, FILTER_EWMA, FILTER_MEDIAN, FILTER_SLEW, FILTER_DEADBAND };
+
+struct FilterStage {
+  FilterKind kind;
+  int32_t    param;   // ewma: alpha in 8.24; median: N; slew: units/s, up to 1e6; deadband: units (scaled)
+};
+
+struct FilterSpec {
+  FilterStage stage[FILTER_STAGES];
+  uint8_t     n;
+
+  bool operator==(const FilterSpec &o) const;
+  bool operator!=(const FilterSpec &o) const { return !(*this == o); }
+};
+
+// Parses "median 5, ewma 0.05" for a channel with dec decimals. "" or "none" is
+// no filtering. False with the reason in err.
+bool filter_parse(const char *text, unsigned dec, FilterSpec &out, std::string &err);
+// The spec as filter_parse() reads it.
+std::string filter_format(const FilterSpec &spec, unsigned dec);
+
+class FilterChain {
+public:
+  // Takes the stages and drops all state.
+  void configure(const FilterSpec &spec);
+  const FilterSpec &spec() const { return spec_; }
+  // Forgets the samples seen, keeping the stages.
+  void reset();
+
+  // Filters sample x (within +-2^23) taken at t_ns (CLOCK_MONOTONIC; only
+  // slew looks at it). The result is in the channel's scale less drop
+  // decimals, rounded half away from zero.
+  int32_t apply(int32_t x, uint64_t t_ns, unsigned drop = 0);
+
+private:
+  // Values are in 16.16 of the channel's scale.
+  struct State {
+    bool     init;
+    int64_t  out;
+    int64_t  carry;                      // slew: budget left over, in 16.16 units x us
+    uint64_t t_ns;                       // slew
+    int64_t  win[FILTER_MEDIAN_MAX];     // median: samples in arrival order
+    int64_t  sorted[FILTER_MEDIAN_MAX];  // median: the same, sorted
+    uint8_t  head, count;
+  };
+
+  int64_t stage_apply(const FilterStage &f, State &s, int64_t x, uint64_t t_ns);
+
+  FilterSpec spec_{};
+  State      state_[FILTER_STAGES]{};
+};
+
+// On once the value crosses `on`, off again only once it is back past `off`:
+// on > off for a high warning, on < off for a low one.
+class FxHysteresis {
+public:
+  constexpr FxHysteresis(int32_t on = 0, int32_t off = 0) : on_(on), off_(off) {}
+
+  void set(int32_t on, int32_t off){ on_ = on; off_ = off; }
+  bool update(int32_t x){
+    bool high = on_ >= off_;
+    if (!state_) state_ = high ? x > on_ : x < on_;
+    else         state_ = high ? x > off_ : x < off_;
+    return state_;
+  }
+  bool state() const { return state_; }
+  void reset(){ state_ = false; }
+
+private:
+  int32_t on_, off_;
+  bool    state_ = false;
+};
@@ -0,0 +1,416 @@
+#include "chanlog.hpp"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+static constexpr char     MAGIC[8] = { 'D', 'A', 'S', 'H', 'C', 'O', 'L', '1' };
+static constexpr uint32_t VERSION = 1;
+static constexpr size_t   HEADER_SIZE = 16;  // magic, version, 0
+static constexpr size_t   FOOTER_SIZE = 24;  // u64 tail offset, u32 crc, u32 version, magic
+static constexpr size_t   ENTRY_SIZE = 40;
+
+static uint32_t crc32(const uint8_t *b, size_t n){
+  uint32_t c = 0xFFFFFFFFu;
+  for (size_t i = 0; i < n; ++i) {
+    c ^= b[i];
+    for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+  }
+  return ~c;
+}
+
+template <typename T> static void put(std::vector<uint8_t> &out, T v){
+  uint8_t b[sizeof(T)];
+  std::memcpy(b, &v, sizeof(T));
+  out.insert(out.end(), b, b + sizeof(T));
+}
+
+template <typename T> static T get(const uint8_t *p){
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+// ---------- block coding ----------
+
+static void put_varint(std::vector<uint8_t> &out, uint64_t v){
+  while (v >= 0x80) { out.push_back(uint8_t(v) | 0x80); v >>= 7; }
+  out.push_back(uint8_t(v));
+}
+
+static bool get_varint(const uint8_t *&p, const uint8_t *end, uint64_t &v){
+  v = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    uint8_t b = *p++;
+    v |= uint64_t(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+static inline uint64_t zigzag(int64_t v){ return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+static inline int64_t unzigzag(uint64_t v){ return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+// Signed varints with runs of zeros folded into one: zigzag(v) << 1 for a
+// value, run << 1 | 1 for run zeros. Steady timestamps and values that don't
+// change cost next to nothing.
+struct RunWriter {
+  std::vector<uint8_t> &out;
+  uint64_t run = 0;
+
+  void put(int64_t v){
+    if (v == 0) { ++run; return; }
+    flush();
+    put_varint(out, zigzag(v) << 1);
+  }
+  void flush(){
+    if (run) put_varint(out, (run << 1) | 1);
+    run = 0;
+  }
+};
+
+struct RunReader {
+  const uint8_t *p, *end;
+  uint64_t run = 0;
+
+  bool get(int64_t &v){
+    v = 0;
+    if (run) { --run; return true; }
+    uint64_t x;
+    if (!get_varint(p, end, x)) return false;
+    if (x & 1) { run = (x >> 1) - 1; return true; }
+    v = unzigzag(x >> 1);
+    return true;
+  }
+};
+
+struct BitWriter {
+  std::vector<uint8_t> &out;
+  uint64_t acc = 0;
+  int n = 0;  // bits in acc
+
+  void bits(uint64_t v, int cnt){  // cnt <= 64, MSB first
+    while (cnt > 0) {
+      int take = std::min(cnt, 56 - n);
+      uint64_t part = (v >> (cnt - take)) & ((uint64_t(1) << take) - 1);
+      acc = (acc << take) | part;
+      n += take; cnt -= take;
+      while (n >= 8) { out.push_back(uint8_t(acc >> (n - 8))); n -= 8; }
+    }
+  }
+  void finish(){ if (n > 0) { out.push_back(uint8_t(acc << (8 - n))); n = 0; } }
+};
+
+struct BitReader {
+  const uint8_t *p, *end;
+  uint64_t acc = 0;
+  int n = 0;
+
+  bool bits(int cnt, uint64_t &v){
+    v = 0;
+    while (cnt > 0) {
+      if (n == 0) {
+        if (p == end) return false;
+        acc = *p++; n = 8;
+      }
+      int take = std::min(cnt, n);
+      v = (v << take) | ((acc >> (n - take)) & ((uint64_t(1) << take) - 1));
+      n -= take; cnt -= take;
+    }
+    return true;
+  }
+};
+
+// Smallest power of ten (up to 1000) that makes every value an integer,
+// exactly: raw CAN fields scaled by /10 or /100 come back bit for bit.
+static int decimal_scale(const ChanSample *s, uint32_t n){
+  static constexpr double SCALES[4] = { 1, 10, 100, 1000 };
+  for (int k = 0; k < 4; ++k) {
+    bool exact = true;
+    for (uint32_t i = 0; i < n && exact; ++i) {
+      double m = s[i].v * SCALES[k];
+      double back = std::fabs(m) < 9e15 ? double(std::llround(m)) / SCALES[k] : 0.0;
+      exact = std::memcmp(&back, &s[i].v, 8) == 0;  // bitwise: -0.0 and NaN go to XOR
+    }
+    if (exact) return k;
+  }
+  return -1;
+}
+
+static constexpr double POW10[4] = { 1, 10, 100, 1000 };
+
+// Timestamps: u32 byte count, then the delta-of-deltas after the first
+// (RunWriter). Values: a mode byte, then
+// - mode 1..4, decimal: the values times 10^(mode - 1) are integers, stored as
+//   deltas (RunWriter);
+// - mode 0, XOR: the first as 64 bits, then per value the XOR with the
+//   previous: '0' same value; '10' + the meaningful bits in the previous
+//   window; '11' + 5 bits leading zeros + 6 bits length - 1 + the meaningful bits.
+static void encode_block(const ChanSample *s, uint32_t n, std::vector<uint8_t> &out){
+  out.clear();
+  put<uint32_t>(out, 0);
+  RunWriter tw{ out };
+  uint64_t prev_d = 0;
+  for (uint32_t i = 1; i < n; ++i) {
+    uint64_t d = s[i].t_us - s[i - 1].t_us;
+    tw.put(int64_t(d - prev_d));
+    prev_d = d;
+  }
+  tw.flush();
+  uint32_t ts_bytes = uint32_t(out.size() - 4);
+  std::memcpy(out.data(), &ts_bytes, 4);
+
+  int k = decimal_scale(s, n);
+  out.push_back(uint8_t(k + 1));
+  if (k >= 0) {
+    RunWriter vw{ out };
+    int64_t prev = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      int64_t m = std::llround(s[i].v * POW10[k]);
+      vw.put(m - prev);
+      prev = m;
+    }
+    vw.flush();
+    return;
+  }
+
+  BitWriter bw{ out };
+  uint64_t prev;
+  std::memcpy(&prev, &s[0].v, 8);
+  bw.bits(prev, 64);
+  int win_lz = -1, win_tz = 0;
+  for (uint32_t i = 1; i < n; ++i) {
+    uint64_t cur;
+    std::memcpy(&cur, &s[i].v, 8);
+    uint64_t x = cur ^ prev;
+    prev = cur;
+    if (x == 0) { bw.bits(0, 1); continue; }
+    int lz = std::min(__builtin_clzll(x), 31), tz = __builtin_ctzll(x);
+    if (win_lz >= 0 && lz >= win_lz && tz >= win_tz) {
+      bw.bits(0b10, 2);
+      bw.bits(x >> win_tz, 64 - win_lz - win_tz);
+    } else {
+      int sig = 64 - lz - tz;
+      bw.bits(0b11, 2);
+      bw.bits(uint64_t(lz), 5);
+      bw.bits(uint64_t(sig - 1), 6);
+      bw.bits(x >> tz, sig);
+      win_lz = lz; win_tz = tz;
+    }
+  }
+  bw.finish();
+}
+
+static bool decode_block(const ChanLogBlock &b, const uint8_t *p, size_t size, std::vector<ChanSample> &out,
+                         uint64_t from_us, uint64_t to_us){
+  if (size < 5 || b.count == 0) return false;
+  uint32_t ts_bytes = get<uint32_t>(p);
+  if (5 + size_t(ts_bytes) > size) return false;
+  const uint8_t *tend = p + 4 + ts_bytes;
+  uint8_t mode = *tend;
+  if (mode > 4) return false;
+  RunReader tr{ p + 4, tend };
+  RunReader vr{ tend + 1, p + size };
+  BitReader br{ tend + 1, p + size };
+
+  uint64_t t = b.t_first_us, d = 0, bits = 0;
+  int64_t m = 0;
+  int win_lz = 0, win_sig = 0;
+  if (mode == 0 && !br.bits(64, bits)) return false;
+  for (uint32_t i = 0; i < b.count; ++i) {
+    if (i > 0) {
+      int64_t dod;
+      if (!tr.get(dod)) return false;
+      d += uint64_t(dod);
+      t += d;
+    }
+    double v;
+    if (mode > 0) {
+      int64_t dm;
+      if (!vr.get(dm)) return false;
+      m += dm;
+      v = double(m) / POW10[mode - 1];
+    } else {
+      if (i > 0) {
+        uint64_t ctl, x;
+        if (!br.bits(1, ctl)) return false;
+        if (ctl) {
+          if (!br.bits(1, ctl)) return false;
+          if (ctl) {
+            uint64_t lz, sig;
+            if (!br.bits(5, lz) || !br.bits(6, sig)) return false;
+            win_lz = int(lz); win_sig = int(sig) + 1;
+          }
+          if (!br.bits(win_sig, x)) return false;
+          bits ^= x << (64 - win_lz - win_sig);
+        }
+      }
+      std::memcpy(&v, &bits, 8);
+    }
+    if (t > to_us) break;
+    if (t >= from_us) out.push_back({ t, v });
+  }
+  return true;
+}
+
+// ---------- writer ----------
+
+ChanLogWriter::~ChanLogWriter(){ if (f_) close(); }
+
+bool ChanLogWriter::write(const void *p, size_t n){
+  if (ok_ && std::fwrite(p, 1, n, f_) != n) ok_ = false;
+  off_ += n;
+  return ok_;
+}
+
+bool ChanLogWriter::open(const char *path){
+  f_ = std::fopen(path, "wb");
+  if (!f_) return false;
+  ok_ = true; off_ = 0;
+  cols_.clear(); index_.clear();
+  uint8_t head[HEADER_SIZE] = {};
+  std::memcpy(head, MAGIC, 8);
+  std::memcpy(head + 8, &VERSION, 4);
+  return write(head, sizeof(head));
+}
+
+uint32_t ChanLogWriter::channel(const char *name){
+  for (uint32_t i = 0; i < cols_.size(); ++i)
+    if (cols_[i].name == name) return i;
+  cols_.push_back(Column{ name, {}, 0 });
+  cols_.back().buf.reserve(CHANLOG_BLOCK);
+  return uint32_t(cols_.size() - 1);
+}
+
+void ChanLogWriter::add(uint32_t ch, uint64_t t_us, double v){
+  if (!f_ || ch >= cols_.size()) return;
+  Column &c = cols_[ch];
+  t_us = std::max(t_us, c.last_t_us);
+  c.last_t_us = t_us;
+  c.buf.push_back({ t_us, v });
+  if (c.buf.size() == CHANLOG_BLOCK) flush(ch);
+}
+
+bool ChanLogWriter::flush(uint32_t ch){
+  Column &c = cols_[ch];
+  if (c.buf.empty()) return ok_;
+  encode_block(c.buf.data(), uint32_t(c.buf.size()), enc_);
+  index_.push_back({ ch, uint32_t(c.buf.size()), c.buf.front().t_us, c.buf.back().t_us, off_, uint32_t(enc_.size()) });
+  c.buf.clear();
+  return write(enc_.data(), enc_.size());
+}
+
+bool ChanLogWriter::close(){
+  if (!f_) return false;
+  for (uint32_t ch = 0; ch < cols_.size(); ++ch) flush(ch);
+
+  std::vector<uint8_t> tail;
+  uint64_t tail_off = off_;
+  put<uint32_t>(tail, uint32_t(cols_.size()));
+  for (const Column &c : cols_) {
+    put<uint16_t>(tail, uint16_t(c.name.size()));
+    tail.insert(tail.end(), c.name.begin(), c.name.end());
+  }
+  put<uint32_t>(tail, uint32_t(index_.size()));
+  for (const ChanLogBlock &b : index_) {
+    put(tail, b.ch); put(tail, b.count); put(tail, b.t_first_us); put(tail, b.t_last_us);
+    put(tail, b.offset); put(tail, b.size); put<uint32_t>(tail, 0);
+  }
+  uint32_t crc = crc32(tail.data(), tail.size());
+  put(tail, tail_off); put(tail, crc); put(tail, VERSION);
+  tail.insert(tail.end(), MAGIC, MAGIC + 8);
+  write(tail.data(), tail.size());
+
+  bool ok = std::fclose(f_) == 0 && ok_;
+  f_ = nullptr;
+  return ok;
+}
+
+// ---------- reader ----------
+
+ChanLogReader::~ChanLogReader(){ close(); }
+
+void ChanLogReader::close(){
+  if (f_) std::fclose(f_);
+  f_ = nullptr;
+  names_.clear(); blocks_.clear();
+}
+
+bool ChanLogReader::open(const char *path){
+  close();
+  f_ = std::fopen(path, "rb");
+  if (!f_) return false;
+  uint8_t foot[FOOTER_SIZE];
+  if (fseeko(f_, 0, SEEK_END) != 0) { close(); return false; }
+  off_t size = ftello(f_);
+  if (size < off_t(HEADER_SIZE + FOOTER_SIZE) || fseeko(f_, size - off_t(FOOTER_SIZE), SEEK_SET) != 0 ||
+      std::fread(foot, 1, sizeof(foot), f_) != sizeof(foot) || std::memcmp(foot + 16, MAGIC, 8) != 0 ||
+      get<uint32_t>(foot + 12) != VERSION) {
+    close();
+    return false;
+  }
+  uint64_t tail_off = get<uint64_t>(foot);
+  if (tail_off < HEADER_SIZE || tail_off > uint64_t(size) - FOOTER_SIZE) { close(); return false; }
+
+  std::vector<uint8_t> tail(size_t(uint64_t(size) - FOOTER_SIZE - tail_off));
+  if (fseeko(f_, off_t(tail_off), SEEK_SET) != 0 || std::fread(tail.data(), 1, tail.size(), f_) != tail.size() ||
+      crc32(tail.data(), tail.size()) != get<uint32_t>(foot + 8)) {
+    close();
+    return false;
+  }
+
+  const uint8_t *p = tail.data(), *end = p + tail.size();
+  auto need = [&](size_t n){ return size_t(end - p) >= n; };
+  if (!need(4)) { close(); return false; }
+  uint32_t n_names = get<uint32_t>(p); p += 4;
+  for (uint32_t i = 0; i < n_names; ++i) {
+    if (!need(2)) { close(); return false; }
+    uint16_t len = get<uint16_t>(p); p += 2;
+    if (!need(len)) { close(); return false; }
+    names_.emplace_back(reinterpret_cast<const char *>(p), len);
+    p += len;
+  }
+  if (!need(4)) { close(); return false; }
+  uint32_t n_blocks = get<uint32_t>(p); p += 4;
+  if (!need(size_t(n_blocks) * ENTRY_SIZE)) { close(); return false; }
+  blocks_.resize(n_blocks);
+  for (ChanLogBlock &b : blocks_) {
+    b.ch = get<uint32_t>(p); b.count = get<uint32_t>(p + 4);
+    b.t_first_us = get<uint64_t>(p + 8); b.t_last_us = get<uint64_t>(p + 16);
+    b.offset = get<uint64_t>(p + 24); b.size = get<uint32_t>(p + 32);
+    p += ENTRY_SIZE;
+  }
+  return true;
+}
+
+int ChanLogReader::channel(const char *name) const {
+  for (size_t i = 0; i < names_.size(); ++i)
+    if (names_[i] == name) return int(i);
+  return -1;
+}
+
+bool ChanLogReader::read(uint32_t ch, uint64_t from_us, uint64_t to_us, std::vector<ChanSample> &out){
+  if (!f_) return false;
+  for (const ChanLogBlock &b : blocks_) {
+    if (b.ch != ch || b.t_last_us < from_us || b.t_first_us > to_us) continue;
+    buf_.resize(b.size);
+    if (fseeko(f_, off_t(b.offset), SEEK_SET) != 0 || std::fread(buf_.data(), 1, b.size, f_) != b.size) return false;
+    ++blocks_read_;
+    bytes_read_ += b.size;
+    if (!decode_block(b, buf_.data(), b.size, out, from_us, to_us)) return false;
+  }
+  return true;
+}
+
+ChanLogReader::ChannelInfo ChanLogReader::info(uint32_t ch) const {
+  ChannelInfo ci{ 0, 0, 0, UINT64_MAX, 0 };
+  for (const ChanLogBlock &b : blocks_) {
+    if (b.ch != ch) continue;
+    ++ci.blocks;
+    ci.samples += b.count;
+    ci.bytes += b.size;
+    ci.t_first_us = std::min(ci.t_first_us, b.t_first_us);
+    ci.t_last_us = std::max(ci.t_last_us, b.t_last_us);
+  }
+  if (ci.blocks == 0) ci.t_first_us = 0;
+  return ci;
+}
@@ -0,0 +1,106 @@
+#pragma once
+// Columnar session logs: one column per decoded channel (cansignals.hpp, or
+// any named channel), cut into blocks of up to CHANLOG_BLOCK samples, each
+// compressed on its own: timestamps as zigzag varint delta-of-deltas; values
+// as varint deltas when a power of ten makes them integers (the /10, /100
+// fields of the CAN map), otherwise XOR'd with the previous one and bit
+// packed (Gorilla style). Lossless either way. The index of
+// all blocks (channel, time span, offset) and the channel names sit at the
+// tail, so a reader loads the index once and then reads only the blocks of
+// the one channel and time range asked for.
+//
+// File: "DASHCOL1" header, blocks, names, index, 24 byte footer pointing at
+// the names (CRC'd along with the index). Little endian.
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t CHANLOG_BLOCK = 1024;  // samples per block
+
+struct ChanSample {
+  uint64_t t_us;
+  double   v;
+};
+
+// An index entry: where a block is and what it covers.
+struct ChanLogBlock {
+  uint32_t ch, count;
+  uint64_t t_first_us, t_last_us;
+  uint64_t offset;
+  uint32_t size;
+};
+
+class ChanLogWriter {
+public:
+  ChanLogWriter() = default;
+  ~ChanLogWriter();
+  ChanLogWriter(const ChanLogWriter &) = delete;
+  ChanLogWriter &operator=(const ChanLogWriter &) = delete;
+
+  bool open(const char *path);
+  // Id of the column named name, created on first use.
+  uint32_t channel(const char *name);
+  // Samples of a channel must come in time order; earlier ones are clamped.
+  void add(uint32_t ch, uint64_t t_us, double v);
+  // Writes the partial blocks, the index and the footer. False on I/O errors.
+  bool close();
+
+  uint64_t bytes_written() const { return off_; }
+
+private:
+  struct Column {
+    std::string name;
+    std::vector<ChanSample> buf;
+    uint64_t last_t_us = 0;
+  };
+
+  bool flush(uint32_t ch);
+  bool write(const void *p, size_t n);
+
+  FILE *f_ = nullptr;
+  uint64_t off_ = 0;
+  bool ok_ = true;
+  std::vector<Column> cols_;
+  std::vector<ChanLogBlock> index_;
+  std::vector<uint8_t> enc_;
+};
+
+class ChanLogReader {
+public:
+  ChanLogReader() = default;
+  ~ChanLogReader();
+  ChanLogReader(const ChanLogReader &) = delete;
+  ChanLogReader &operator=(const ChanLogReader &) = delete;
+
+  // Reads the footer, names and index only. False if it's not a complete
+  // chanlog (e.g. the writer never closed it).
+  bool open(const char *path);
+  void close();
+
+  const std::vector<std::string> &channels() const { return names_; }
+  // -1 if there is no such channel.
+  int channel(const char *name) const;
+
+  // Appends the samples of ch with from_us <= t_us <= to_us, reading only the
+  // blocks that overlap the range.
+  bool read(uint32_t ch, uint64_t from_us, uint64_t to_us, std::vector<ChanSample> &out);
+
+  // Per channel: blocks, samples and time span, from the index.
+  struct ChannelInfo {
+    uint32_t blocks;
+    uint64_t samples, bytes;
+    uint64_t t_first_us, t_last_us;
+  };
+  ChannelInfo info(uint32_t ch) const;
+
+  uint64_t blocks_read() const { return blocks_read_; }
+  uint64_t bytes_read() const { return bytes_read_; }
+
+private:
+  FILE *f_ = nullptr;
+  std::vector<std::string> names_;
+  std::vector<ChanLogBlock> blocks_;
+  std::vector<uint8_t> buf_;
+  uint64_t blocks_read_ = 0, bytes_read_ = 0;
+};
@@ -1,4 +1,6 @@
 // config.h
+// Compiled-in defaults. At runtime /etc/dash.conf overrides them and is
+// reloaded on every save (dashconfig.hpp).
 #ifndef CONFIG_H
 #define CONFIG_H
 
@@ -10,6 +12,12 @@
 
 #define RPM_MAX (int)(RPM_DISPLAY_MAX * 0.85)            // Starts flashing when RPM exceeds *above* this value (shift up).
 
+#define TOP_GEAR 6             // No shift-up light in this gear.
+
+#define SHIFT_LEAD_MS 150      // Shift lights come on this early, at the rate the RPM is moving.
+
+#define GEAR_RPM_PER_KPH { 212.8, 106.4, 70.9, 53.2, 42.6, 35.5 }  // 1st, 2nd... Guesses the gear without a 0x2003 frame.
+
 #define TEMP_MAX 100           // Startsts flashing when oil temperature rises *above* this value. Celcius.
 
 #define PRESSURE_MIN 60        // Starts flashing when oil pressure falls *below* this value. kPa.
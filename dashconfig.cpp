@@ -0,0 +1,305 @@
+#include "dashconfig.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "config.h"
+#include "fixedpoint.hpp"
+
+// The config in use and the ones retired before it, reused round robin. A
+// dashcfg() reader on another thread holds its reference for one LED update,
+// so a snapshot retired RETIRE_GRACE_NS ago has no reader left.
+static constexpr int      SNAPSHOTS = 4;
+static constexpr uint64_t RETIRE_GRACE_NS = 1000000000;
+static DashConfig g_snapshots[SNAPSHOTS];
+static uint64_t   g_retired_ns[SNAPSHOTS];    // 0 while never retired
+static int        g_cur = -1;
+static bool       g_reload_pending = false;   // waits for a snapshot to come free
+static std::atomic<const DashConfig *> g_cfg{nullptr};
+
+static std::string g_path;
+static std::string g_name;     // of the file in its directory, as inotify reports it
+static int         g_fd = -1;
+
+static uint16_t to_raw(double v, double per_unit){
+  double r = std::round(v * per_unit);
+  return uint16_t(r < 0 ? 0 : r > 65535 ? 65535 : r);
+}
+
+static void precompute(DashConfig &c){
+  c.temp_max_raw     = to_raw(c.temp_max, 1);
+  c.pressure_min_raw = to_raw(c.pressure_min, 100);
+  c.voltage_min_raw  = to_raw(c.voltage_min, 10);
+  c.rpm_recip_q32    = uint32_t(((1ull << 32) + uint64_t(c.rpm_display_max) - 1) / uint64_t(c.rpm_display_max));
+  for (int g = 0; g <= DASH_GEARS; ++g) {
+    c.rpm_per_kph_x100[g] = uint32_t(std::lround(c.rpm_per_kph[g] * 100));
+    c.shift_down[g] = uint16_t(g && c.gear_rpm_min[g] >= 0 ? c.gear_rpm_min[g] : c.rpm_min);
+    c.shift_up[g]   = uint16_t(g && c.gear_rpm_max[g] >= 0 ? c.gear_rpm_max[g] : c.rpm_max);
+  }
+}
+
+DashConfig dashcfg_defaults(){
+  DashConfig c{};
+  c.rpm_display_min = RPM_DISPLAY_MIN;
+  c.rpm_display_max = RPM_DISPLAY_MAX;
+  c.rpm_min         = RPM_MIN;
+  c.rpm_max         = RPM_MAX;
+  for (int g = 0; g <= DASH_GEARS; ++g) c.gear_rpm_min[g] = c.gear_rpm_max[g] = -1;
+  c.top_gear        = TOP_GEAR;
+  c.shift_lead_ms   = SHIFT_LEAD_MS;
+  static constexpr double RATIOS[] = GEAR_RPM_PER_KPH;
+  for (int g = 1; g <= DASH_GEARS && g <= int(sizeof(RATIOS) / sizeof(RATIOS[0])); ++g) c.rpm_per_kph[g] = RATIOS[g - 1];
+  c.temp_max        = TEMP_MAX;
+  c.pressure_min    = PRESSURE_MIN;
+  c.voltage_min     = VOLTAGE_MIN;
+  c.filters[CH_OIL_KPA].stage[0] = { FILTER_EWMA, int32_t(fx_alpha(0.01)) };
+  c.filters[CH_OIL_KPA].n = 1;
+  precompute(c);
+  return c;
+}
+
+const DashConfig &dashcfg(){
+  const DashConfig *c = g_cfg.load(std::memory_order_acquire);
+  if (c) return *c;
+  // Before anything was published: the defaults, built once.
+  static const DashConfig defaults = dashcfg_defaults();
+  return defaults;
+}
+
+static uint64_t now_ns(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+// False if the next snapshot was retired too recently to reuse: more than
+// SNAPSHOTS - 1 reloads within RETIRE_GRACE_NS.
+static bool publish(const DashConfig &c){
+  const int next = (g_cur + 1) % SNAPSHOTS;
+  const uint64_t now = now_ns();
+  if (g_retired_ns[next] && now - g_retired_ns[next] < RETIRE_GRACE_NS) return false;
+  g_snapshots[next] = c;
+  g_cfg.store(&g_snapshots[next], std::memory_order_release);
+  if (g_cur >= 0) g_retired_ns[g_cur] = now;
+  g_cur = next;
+  return true;
+}
+
+// ---------- parsing ----------
+struct Key {
+  const char *name;
+  int32_t DashConfig::*i;   // integer keys
+  double  DashConfig::*d;   // the others
+};
+
+static constexpr Key KEYS[] = {
+  { "rpm_display_min", &DashConfig::rpm_display_min, nullptr },
+  { "rpm_display_max", &DashConfig::rpm_display_max, nullptr },
+  { "rpm_min",         &DashConfig::rpm_min,         nullptr },
+  { "rpm_max",         &DashConfig::rpm_max,         nullptr },
+  { "top_gear",        &DashConfig::top_gear,        nullptr },
+  { "shift_lead_ms",   &DashConfig::shift_lead_ms,   nullptr },
+  { "temp_max",        nullptr, &DashConfig::temp_max },
+  { "pressure_min",    nullptr, &DashConfig::pressure_min },
+  { "voltage_min",     nullptr, &DashConfig::voltage_min },
+};
+
+static std::string trim(const std::string &s){
+  size_t b = s.find_first_not_of(" \t\r");
+  if (b == std::string::npos) return std::string();
+  size_t e = s.find_last_not_of(" \t\r");
+  return s.substr(b, e - b + 1);
+}
+
+static bool parse_line(const std::string &raw, DashConfig &c, std::string &err){
+  std::string line = trim(raw.substr(0, raw.find('#')));
+  if (line.empty()) return true;
+
+  size_t eq = line.find('=');
+  if (eq == std::string::npos) { err = "expected key = value"; return false; }
+  std::string key = trim(line.substr(0, eq));
+  std::string val = trim(line.substr(eq + 1));
+
+  if (key.compare(0, 7, "filter.") == 0) {
+    for (int ch = 0; ch < CH_COUNT; ++ch) {
+      if (key.compare(7, std::string::npos, DASH_CHANNEL_NAMES[ch]) != 0) continue;
+      if (!filter_parse(val.c_str(), DASH_CHANNEL_DECIMALS[ch], c.filters[ch], err)) { err = key + ": " + err; return false; }
+      return true;
+    }
+    err = "unknown channel " + key.substr(7);
+    return false;
+  }
+
+  // rpm_min.<gear>, rpm_max.<gear>, rpm_per_kph.<gear>
+  size_t dot = key.find('.');
+  std::string base = key.substr(0, dot);
+  if (dot != std::string::npos && (base == "rpm_min" || base == "rpm_max" || base == "rpm_per_kph")) {
+    char *end = nullptr;
+    long g = std::strtol(key.c_str() + dot + 1, &end, 10);
+    if (dot + 1 == key.size() || *end || g < 1 || g > DASH_GEARS) {
+      err = "no gear " + key.substr(dot + 1) + " (1.." + std::to_string(DASH_GEARS) + ")";
+      return false;
+    }
+    errno = 0;
+    if (base == "rpm_per_kph") {
+      double r = std::strtod(val.c_str(), &end);
+      if (val.empty() || *end || errno || !(r >= 0 && r <= 1000)) { err = key + ": not a ratio 0..1000: " + val; return false; }
+      c.rpm_per_kph[g] = r;
+      return true;
+    }
+    long v = std::strtol(val.c_str(), &end, 10);
+    if (val.empty() || *end || errno || v < 0 || v > 65535) { err = key + ": not an rpm: " + val; return false; }
+    (base == "rpm_min" ? c.gear_rpm_min : c.gear_rpm_max)[g] = int32_t(v);
+    return true;
+  }
+
+  for (const Key &k : KEYS) {
+    if (key != k.name) continue;
+    char *end = nullptr;
+    errno = 0;
+    if (k.i) {
+      long v = std::strtol(val.c_str(), &end, 10);
+      if (val.empty() || *end || errno || v < 0 || v > 65535) { err = key + ": not a number 0..65535: " + val; return false; }
+      c.*k.i = int32_t(v);
+    } else {
+      double v = std::strtod(val.c_str(), &end);
+      if (val.empty() || *end || errno || !std::isfinite(v)) { err = key + ": not a number: " + val; return false; }
+      c.*k.d = v;
+    }
+    return true;
+  }
+  err = "unknown key " + key;
+  return false;
+}
+
+static bool validate(const DashConfig &c, std::string &err){
+  if (c.rpm_display_max <= c.rpm_display_min) err = "rpm_display_max must be above rpm_display_min";
+  else if (c.rpm_display_max < 2) err = "rpm_display_max must be at least 2";  // rpm_recip_q32 fits 32 bits
+  else if (c.rpm_min < c.rpm_display_min || c.rpm_min > c.rpm_max || c.rpm_max > c.rpm_display_max)
+    err = "need rpm_display_min <= rpm_min <= rpm_max <= rpm_display_max";
+  else if (c.top_gear < 1 || c.top_gear > DASH_GEARS) err = "top_gear must be 1.." + std::to_string(DASH_GEARS);
+  else if (c.shift_lead_ms > 1000) err = "shift_lead_ms must be at most 1000";
+  else {
+    for (int g = 1; g <= DASH_GEARS; ++g) {
+      int32_t lo = c.gear_rpm_min[g] >= 0 ? c.gear_rpm_min[g] : c.rpm_min;
+      int32_t hi = c.gear_rpm_max[g] >= 0 ? c.gear_rpm_max[g] : c.rpm_max;
+      if (lo < c.rpm_display_min || lo > hi || hi > c.rpm_display_max) {
+        err = "gear " + std::to_string(g) + ": need rpm_display_min <= rpm_min <= rpm_max <= rpm_display_max";
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+bool dashcfg_parse(const char *path, DashConfig &out, std::string &err){
+  FILE *f = std::fopen(path, "r");
+  if (!f) { err = std::strerror(errno); return false; }
+
+  DashConfig c = dashcfg_defaults();
+  std::string line;
+  int lineno = 0;
+  bool ok = true;
+  for (int ch; ok;) {
+    line.clear();
+    while ((ch = std::fgetc(f)) != EOF && ch != '\n') line += char(ch);
+    if (ch == EOF && line.empty()) break;
+    ++lineno;
+    if (!parse_line(line, c, err)) {
+      err = "line " + std::to_string(lineno) + ": " + err;
+      ok = false;
+    }
+  }
+  if (ok && std::ferror(f)) { err = std::strerror(errno); ok = false; }
+  std::fclose(f);
+  if (!ok || !validate(c, err)) return false;
+
+  precompute(c);
+  out = c;
+  return true;
+}
+
+bool dashcfg_load(const char *path){
+  DashConfig c;
+  std::string err;
+  if (!dashcfg_parse(path, c, err)) {
+    std::fprintf(stderr, "config: %s: %s, keeping the current config\n", path, err.c_str());
+    return false;
+  }
+  if (!publish(c)) {
+    std::fprintf(stderr, "config: %s: reloaded too often, applying it in a moment\n", path);
+    g_reload_pending = true;
+    return false;
+  }
+  std::printf("config: %s: rpm %d..%d, shift %d/%d (lead %d ms, top gear %d), temp > %g, oil < %g, volt < %g\n",
+              path, (int)c.rpm_display_min, (int)c.rpm_display_max, (int)c.rpm_min, (int)c.rpm_max,
+              (int)c.shift_lead_ms, (int)c.top_gear, c.temp_max, c.pressure_min, c.voltage_min);
+  for (int g = 1; g <= DASH_GEARS; ++g)
+    if (c.gear_rpm_min[g] >= 0 || c.gear_rpm_max[g] >= 0)
+      std::printf("config:   gear %d shift %d/%d\n", g, (int)c.shift_down[g], (int)c.shift_up[g]);
+  std::string ratios;
+  for (int g = 1; g <= DASH_GEARS; ++g) {
+    if (c.rpm_per_kph[g] <= 0) continue;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), " %d:%g", g, c.rpm_per_kph[g]);
+    ratios += buf;
+  }
+  if (!ratios.empty()) std::printf("config:   rpm per kph%s\n", ratios.c_str());
+  for (int ch = 0; ch < CH_COUNT; ++ch)
+    if (c.filters[ch].n)
+      std::printf("config:   filter.%s = %s\n", DASH_CHANNEL_NAMES[ch],
+                  filter_format(c.filters[ch], DASH_CHANNEL_DECIMALS[ch]).c_str());
+  return true;
+}
+
+// ---------- watching ----------
+bool dashcfg_watch(const char *path){
+  dashcfg_unwatch();
+  g_path = path;
+  size_t slash = g_path.rfind('/');
+  std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : g_path.substr(0, slash);
+  g_name = slash == std::string::npos ? g_path : g_path.substr(slash + 1);
+
+  g_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (g_fd < 0) return false;
+  // A save in place ends with IN_CLOSE_WRITE, one by rename with IN_MOVED_TO.
+  if (inotify_add_watch(g_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    int e = errno;
+    dashcfg_unwatch();
+    errno = e;
+    return false;
+  }
+  return true;
+}
+
+bool dashcfg_poll(){
+  if (g_fd < 0) return false;
+
+  // An editor's save can be several events: drain them all, reload once.
+  bool changed = g_reload_pending;
+  g_reload_pending = false;
+  alignas(inotify_event) char buf[4096];
+  for (;;) {
+    ssize_t n = read(g_fd, buf, sizeof(buf));
+    if (n <= 0) break;
+    for (char *p = buf; p < buf + n;) {
+      const inotify_event *ev = reinterpret_cast<const inotify_event *>(p);
+      if (ev->len && g_name == ev->name) changed = true;
+      p += sizeof(inotify_event) + ev->len;
+    }
+  }
+  return changed && dashcfg_load(g_path.c_str());
+}
+
+void dashcfg_unwatch(){
+  if (g_fd >= 0) close(g_fd);
+  g_fd = -1;
+}
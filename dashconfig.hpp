@@ -0,0 +1,87 @@
+#pragma once
+// Runtime config of the dash: the range of the rpm bar, the shift points and
+// the warning thresholds. config.h holds the compiled-in defaults; a file of
+// `key = value` lines overrides them, and dashcfg_watch() picks up edits to it
+// with inotify, so moving a shift point needs no rebuild on the Pi:
+//   # /etc/dash.conf
+//   rpm_display_min = 0
+//   rpm_display_max = 8000
+//   rpm_min         = 1200   # shift down below
+//   rpm_max         = 6800   # shift up at or above
+//   rpm_max.1       = 6500   # per gear, else rpm_min/rpm_max
+//   rpm_min.3       = 2500
+//   top_gear        = 6      # no shift up in this gear
+//   shift_lead_ms   = 150    # predictive lead of the shift lights
+//   rpm_per_kph.4   = 53.2   # gear ratio, for the gear estimate (derived.hpp)
+//   temp_max        = 105    # warn above, °C
+//   pressure_min    = 55     # warn below, kPa
+//   voltage_min     = 11.8   # warn below, V
+//   filter.oil_kpa  = median 5, ewma 0.05
+// filter.<channel> sets the filter chain of a channel of cansignals.hpp
+// (chanfilter.hpp); oil_kpa defaults to "ewma 0.01", the others to none.
+// Keys left out keep their default. A file is taken whole or not at all: one
+// bad line and the current config stays.
+//
+// A config is an immutable snapshot published with a single pointer store, so
+// the LED thread calling dashcfg() sees the old one or the new one, never a
+// mix. There are four, reused in turn once retired for a second, so reloads
+// allocate nothing; past three reloads in a second, dashcfg_poll() applies
+// the file once a snapshot is free again.
+// dashcfg_load(), dashcfg_watch() and dashcfg_poll() belong to the UI thread,
+// which then re-applies the geometry (dashui_apply_config()) between frames.
+#include <cstdint>
+#include <string>
+#include "cansignals.hpp"
+#include "chanfilter.hpp"
+
+// Gears 1..DASH_GEARS can have their own shift points.
+static constexpr int DASH_GEARS = 8;
+
+struct DashConfig {
+  int32_t rpm_display_min;
+  int32_t rpm_display_max;
+  int32_t rpm_min;               // shift down below
+  int32_t rpm_max;               // shift up at or above
+  int32_t gear_rpm_min[DASH_GEARS + 1];  // [gear], -1 for rpm_min; [0] unused
+  int32_t gear_rpm_max[DASH_GEARS + 1];  // [gear], -1 for rpm_max; [0] unused
+  int32_t top_gear;
+  int32_t shift_lead_ms;
+  double  rpm_per_kph[DASH_GEARS + 1];   // [gear], 0 if unknown; [0] unused
+  double  temp_max;              // °C
+  double  pressure_min;          // kPa
+  double  voltage_min;           // V
+  FilterSpec filters[CH_COUNT];  // applied by dashui as frames arrive
+
+  // Precomputed for the hot paths, in the raw units of the CAN map (dashui.cpp)
+  uint16_t temp_max_raw;         // 1 °C
+  uint16_t pressure_min_raw;     // 0.01 kPa
+  uint16_t voltage_min_raw;      // 0.1 V
+  uint32_t rpm_recip_q32;        // 2^32 / rpm_display_max, rounded up
+  uint16_t shift_down[DASH_GEARS + 1];   // [gear] resolved; [0] for an unknown gear
+  uint16_t shift_up[DASH_GEARS + 1];
+  uint32_t rpm_per_kph_x100[DASH_GEARS + 1];
+
+  // rpm as a 16.16 fraction of rpm_display_max, at most 1.0.
+  uint32_t rpm_frac_q16(uint32_t rpm) const {
+    uint64_t f = (uint64_t(rpm) * rpm_recip_q32) >> 16;
+    return f > 0x10000 ? 0x10000 : uint32_t(f);
+  }
+};
+
+// The config in use. From any thread.
+const DashConfig &dashcfg();
+// The values of config.h.
+DashConfig dashcfg_defaults();
+
+// Reads path over the defaults into out. False with the reason in err.
+bool dashcfg_parse(const char *path, DashConfig &out, std::string &err);
+// Reads path and publishes it. False, keeping the config in use, if it can't
+// (or can't yet: dashcfg_poll() retries then).
+bool dashcfg_load(const char *path);
+
+// Watches path (its directory, so editors that save by renaming are seen too).
+// False if inotify can't.
+bool dashcfg_watch(const char *path);
+// Reloads the file if it changed. True when a new config was published.
+bool dashcfg_poll();
+void dashcfg_unwatch();
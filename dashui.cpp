@@ -0,0 +1,310 @@
+// CAN map:
+// (U16 little endian, big endian when the LE value is 0)
+//   0x2000: RPM      @ 0..1 (U16 / 1)          ; CoolTemp @ 4..5 (U16 / 1 °C)
+//   0x2001: Speed    @ 4..5 (U16 / 10.0 kph)   ; OilPres  @ 6..7 (U16 / 100.0 kPa)
+//   0x2002: Voltage  @ 4..5 (U16 / 10.0 V)
+//   0x2003: Gear     @ 0 or 1 (0 = N)
+#include "dashui.hpp"
+#include "latency.hpp"
+#include "dashconfig.hpp"
+#include "cansignals.hpp"
+#include "fixedpoint.hpp"
+#include "chanfilter.hpp"
+#include "alarms.hpp"
+#include "shiftpoint.hpp"
+#include "derived.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+  #include "lvgl.h"
+  #include "ui.h"
+  #include "rpmbar.h"
+}
+
+static lv_obj_t *g_rpmbar = nullptr;
+static bool      g_log    = true;
+static uint64_t (*g_now_ns)() = mono_ns;
+
+// ===================== CAN handlers =====================
+// Values arrive as the scaled integers of can_decode_fixed() and are rendered
+// with fx_format(): no double on the way from the frame to the label.
+static uint16_t last_rpm_raw=0xFFFF, last_speed_raw=0xFFFF,last_oilp_raw=0xFFFF, last_oilt_raw=0xFFFF, last_volt_raw=0xFFFF;
+
+// Every channel goes through its filter chain of the config (filter.<name>)
+// before it reaches a widget; oil pressure, which is noisy, defaults to an EWMA.
+static FilterChain g_filters[CH_COUNT];
+// Decimals of each channel not shown: oil pressure comes in 0.01 kPa, shows 0.1.
+static constexpr uint8_t SHOWN_DROP[CH_COUNT] = { 0, 0, 0, 1, 0, 0 };
+
+// The warning widgets of each alarm (alarms.hpp): the value and unit labels
+// and the red box behind them, which flashes while the alarm is on.
+struct AlarmWidgets {
+  lv_obj_t **value, **unit, **back;
+};
+static const AlarmWidgets ALARM_WIDGETS[ALARM_COUNT] = {
+  /* ALARM_TEMP_HIGH        */ { &ui_eoiltemperature, &ui_oiltemperaturedu, &ui_eoiltemperatureback },
+  /* ALARM_OIL_PRESSURE_LOW */ { &ui_eoilpressure,    &ui_oilpressuredu,    &ui_eoilpressureback },
+  /* ALARM_VOLTAGE_LOW      */ { &ui_evoltage,        &ui_voltagedu,        &ui_evoltageback },
+};
+static constexpr uint32_t ALARM_BLINK_MS = 250;
+static constexpr uint64_t NS_PER_MS = 1000000ull;
+
+static lv_timer_t *g_alarm_debounce = nullptr;  // fires at alarms_next_deadline()
+static lv_timer_t *g_alarm_blink    = nullptr;  // runs while an alarm is on
+static uint64_t    g_alarm_armed    = UINT64_MAX;
+static bool        g_blink_lit      = true;
+
+// The box behind a value stays up (red) until the first value comes in.
+static void first_value(const AlarmWidgets &w){
+  lv_obj_set_style_text_color(*w.value, lv_color_hex(0xFFFFFF), 0);
+  lv_obj_set_style_text_color(*w.unit,  lv_color_hex(0xFFFFFF), 0);
+  lv_obj_add_flag(*w.back, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void log_channel(const CanFrame &fr, const ChannelFixed &s){
+  char buf[FX_FORMAT_MAX];
+  fx_format(buf, s.v, DASH_CHANNEL_DECIMALS[s.ch]);
+  std::printf("[CAN] %X %s=%s%s\n", (unsigned)(fr.id & 0x1FFFFFFF), DASH_CHANNEL_NAMES[s.ch], buf, s.be ? " (BE)" : "");
+}
+
+//0x2000 rpm
+static void rpm(int32_t rpm){
+  if (last_rpm_raw == 0xFFFF || std::abs(rpm - int(last_rpm_raw)) >= 1) {
+    last_rpm_raw = uint16_t(rpm);
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, rpm, 0);
+    lv_label_set_text(ui_erpm, buf);
+    if (g_rpmbar) rpmbar_set_value(g_rpmbar, rpm);
+    else          lv_bar_set_value(ui_erpmbar, rpm, LV_ANIM_OFF);
+    latency_value(uint16_t(rpm), ui_erpm, g_rpmbar ? g_rpmbar : ui_erpmbar);
+  }
+  // Update LEDs based on CAN RPM moved to main loop
+}
+
+//0x2000 coolant, whole °C shown with one decimal
+static void coolant(int32_t c){
+  if (c != last_oilt_raw){
+    if (last_oilt_raw == 0xFFFF) first_value(ALARM_WIDGETS[ALARM_TEMP_HIGH]);
+    last_oilt_raw = uint16_t(c);
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, fx_rescale(c, 0, 1), 1);
+    lv_label_set_text(ui_eoiltemperature, buf);
+  }
+}
+
+//0x2001 speed in 0.1 kph, shown in whole kph cut like a speedometer's
+static void speed(int32_t dkph) {
+  if (last_speed_raw != dkph) {
+    last_speed_raw = uint16_t(dkph);
+    int32_t kph = dkph / 10;
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, kph, 0);
+    lv_label_set_text(ui_espeed, buf);
+    lv_arc_set_value(ui_espeedarc, int16_t(kph));
+  }
+}
+
+//0x2001 pressure, filtered to the 0.1 kPa shown
+static void oil_pressure(int32_t dkpa){
+  if (dkpa != last_oilp_raw){
+    if (last_oilp_raw == 0xFFFF) first_value(ALARM_WIDGETS[ALARM_OIL_PRESSURE_LOW]);
+    last_oilp_raw = uint16_t(dkpa);
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, dkpa, 1);
+    lv_label_set_text(ui_eoilpressure, buf);
+  }
+}
+
+//0x2002 voltage in 0.1 V
+static void voltage(int32_t dv){
+  if (dv != last_volt_raw){
+    if (last_volt_raw == 0xFFFF) first_value(ALARM_WIDGETS[ALARM_VOLTAGE_LOW]);
+    last_volt_raw = uint16_t(dv);
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, dv, 1);
+    lv_label_set_text(ui_evoltage, buf);
+  }
+}
+
+// Gear: the 0x2003 one, or the estimate without it (derived.hpp)
+static void gear(int32_t g){
+  if (g == 0) lv_label_set_text(ui_egear, "N");
+  else {
+    char buf[FX_FORMAT_MAX];
+    fx_format(buf, g, 0);
+    lv_label_set_text(ui_egear, buf);
+  }
+}
+
+// ===================== Shift lights =====================
+// The bar shows the shift points of the gear and darkens the zone to leave
+// while shiftpoint.hpp asks for a shift; the LEDs flash from the same state.
+static void set_hidden(lv_obj_t *obj, bool hidden){
+  if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) == hidden) return;  // a flag change redraws
+  if (hidden) lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  else        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void shift_apply(bool zones){
+  static uint16_t down = 0, up = 0;
+  const ShiftState st = shiftpoint_state();
+  if (g_rpmbar) {
+    rpmbar_set_shift_points(g_rpmbar, st.down, st.up);
+    rpmbar_set_shift(g_rpmbar, st.flash == ShiftFlash::UP   ? RPMBAR_SHIFT_UP :
+                               st.flash == ShiftFlash::DOWN ? RPMBAR_SHIFT_DOWN : RPMBAR_SHIFT_NONE);
+    return;
+  }
+  if (zones || st.down != down || st.up != up) {
+    const DashConfig &c = dashcfg();
+    ui_Screen1_set_rpm_zones(c.rpm_display_min, c.rpm_display_max, st.down, st.up);
+    down = st.down;
+    up = st.up;
+  }
+  set_hidden(ui_erpmbackswitchup,   st.flash != ShiftFlash::UP);
+  set_hidden(ui_erpmbackswitchdown, st.flash != ShiftFlash::DOWN);
+}
+
+// ===================== Derived channels =====================
+// Pulled once per frame (dashui_update_derived()), so a burst of frames costs
+// one evaluation. The gear label and the shift points follow the gear channel,
+// which falls back on the estimate without 0x2003 frames.
+static constexpr DerivedId DRV_USED[] = { DRV_GEAR, DRV_OIL_MARGIN, DRV_VOLT_SAG };
+static int32_t g_drv_last[DRV_COUNT];
+static bool    g_drv_seen[DRV_COUNT];
+
+static void log_derived(DerivedId id, int32_t v){
+  char buf[FX_FORMAT_MAX];
+  fx_format(buf, v, DERIVED_DECIMALS[id]);
+  std::printf("[DRV] %s=%s\n", DERIVED_NAMES[id], buf);
+}
+
+uint32_t dashui_update_derived(){
+  const uint64_t evals = derived_evals();
+  for (DerivedId id : DRV_USED) {
+    int32_t v;
+    if (!derived_dirty(id) || !derived_get(id, v)) continue;
+    if (g_drv_seen[id] && v == g_drv_last[id]) continue;
+    g_drv_seen[id] = true;
+    g_drv_last[id] = v;
+    if (g_log) log_derived(id, v);
+    if (id == DRV_GEAR) {
+      gear(v);
+      if (shiftpoint_gear(v, g_now_ns())) shift_apply(false);
+    }
+  }
+  return uint32_t(derived_evals() - evals);
+}
+
+// ===================== Alarms =====================
+static void alarm_blink_cb(lv_timer_t *){
+  g_blink_lit = !g_blink_lit;
+  for (int id = 0; id < ALARM_COUNT; ++id) {
+    if (!alarms_active(AlarmId(id))) continue;
+    if (g_blink_lit) lv_obj_clear_flag(*ALARM_WIDGETS[id].back, LV_OBJ_FLAG_HIDDEN);
+    else             lv_obj_add_flag(*ALARM_WIDGETS[id].back, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+static void on_alarm(const AlarmEvent &ev, void *){
+  lv_obj_t *back = *ALARM_WIDGETS[ev.id].back;
+  if (ev.active) lv_obj_clear_flag(back, LV_OBJ_FLAG_HIDDEN);
+  else           lv_obj_add_flag(back, LV_OBJ_FLAG_HIDDEN);
+
+  if (alarms_top() >= 0) {
+    if (ev.active) {
+      // Restart the cadence so the new box comes up lit with the others.
+      g_blink_lit = true;
+      for (int id = 0; id < ALARM_COUNT; ++id)
+        if (alarms_active(AlarmId(id))) lv_obj_clear_flag(*ALARM_WIDGETS[id].back, LV_OBJ_FLAG_HIDDEN);
+      lv_timer_reset(g_alarm_blink);
+    }
+    lv_timer_resume(g_alarm_blink);
+  } else {
+    lv_timer_pause(g_alarm_blink);
+  }
+}
+
+// Points the debounce timer at the next deadline, if that moved.
+static void alarm_timer_arm(){
+  uint64_t next = alarms_next_deadline();
+  if (next == g_alarm_armed) return;
+  g_alarm_armed = next;
+  if (next == UINT64_MAX) { lv_timer_pause(g_alarm_debounce); return; }
+
+  uint64_t now = g_now_ns();
+  uint64_t ms = next > now ? (next - now + NS_PER_MS - 1) / NS_PER_MS : 1;
+  lv_timer_set_period(g_alarm_debounce, uint32_t(ms));
+  lv_timer_reset(g_alarm_debounce);
+  lv_timer_resume(g_alarm_debounce);
+}
+
+static void alarm_debounce_cb(lv_timer_t *){
+  alarms_expire(g_now_ns());
+  g_alarm_armed = 0;   // re-arm even if the deadline is still the same (fired early)
+  alarm_timer_arm();
+}
+
+void dashui_init(bool rpmbar_widget){
+  ui_init();
+  lv_arc_set_bg_cache(ui_espeedarc, true);  // the speed arc track is drawn from a cached alpha map
+  if (rpmbar_widget) {
+    g_rpmbar = rpmbar_replace_ui_composite();
+  } else {
+    lv_bar_set_delta_refr(ui_erpmbar, true);  // redraw only the moved end of the bar
+  }
+
+  g_alarm_debounce = lv_timer_create(alarm_debounce_cb, 1000, nullptr);
+  lv_timer_pause(g_alarm_debounce);
+  g_alarm_blink = lv_timer_create(alarm_blink_cb, ALARM_BLINK_MS, nullptr);
+  lv_timer_pause(g_alarm_blink);
+  alarms_listen(on_alarm, nullptr);
+  derived_init();
+  dashui_apply_config();
+}
+
+void dashui_apply_config(){
+  const DashConfig &c = dashcfg();
+  for (int ch = 0; ch < CH_COUNT; ++ch)
+    if (g_filters[ch].spec() != c.filters[ch]) g_filters[ch].configure(c.filters[ch]);
+  alarms_configure(c, g_now_ns());
+  alarm_timer_arm();
+  if (g_rpmbar) rpmbar_set_range(g_rpmbar, c.rpm_display_min, c.rpm_display_max);
+  shiftpoint_configure(c);
+  shift_apply(true);
+  derived_configure(c);
+}
+
+bool dashui_handle_can(const CanFrame &fr){
+  ChannelFixed s[2];
+  int n = can_decode_fixed(fr, s);
+  uint64_t t_ns = fr.rx_ns ? fr.rx_ns : g_now_ns();
+  for (int i = 0; i < n; ++i) {
+    if (g_log) log_channel(fr, s[i]);
+    // Filtered to the decimals shown; the alarms see what the dash shows.
+    const unsigned dec = DASH_CHANNEL_DECIMALS[s[i].ch], drop = SHOWN_DROP[s[i].ch];
+    int32_t v = g_filters[s[i].ch].apply(s[i].v, t_ns, drop);
+    int32_t shown = fx_rescale(v, dec - drop, dec);
+    alarms_sample(s[i].ch, shown, t_ns);
+    derived_input(s[i].ch, shown);
+    switch (s[i].ch) {
+      case CH_RPM:
+        rpm(v);
+        if (shiftpoint_rpm(v, t_ns)) shift_apply(false);
+        break;
+      case CH_COOLANT_C: coolant(v); break;
+      case CH_KPH:       speed(v); break;
+      case CH_OIL_KPA:   oil_pressure(v); break;
+      case CH_VOLT:      voltage(v); break;
+      default:           break;
+    }
+  }
+  alarm_timer_arm();
+  return n > 0;
+}
+
+uint16_t dashui_rpm(){ return last_rpm_raw; }
+
+void dashui_set_log(bool on){ g_log = on; }
+
+void dashui_set_clock(uint64_t (*now_ns)()){ g_now_ns = now_ns; }
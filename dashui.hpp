@@ -0,0 +1,34 @@
+#pragma once
+// The dash screen as raspi_dash drives it: the SquareLine UI with our widget
+// tweaks, and the handlers turning CAN frames into label/bar/arc updates.
+// Kept out of main.cpp so bench/dash_bench can run the very same code without
+// SDL or ws281x.
+#include <cstdint>
+#include "socketcan.hpp"
+
+// ui_init() plus the cached speed arc track; the rpm bar is the rpmbar widget
+// (rpmbar.h) or, with rpmbar_widget false, the SquareLine composite.
+void dashui_init(bool rpmbar_widget);
+
+// Re-applies dashcfg() (dashconfig.hpp): the rpm bar range, the shift points
+// (shiftpoint.hpp) and the filter chains (a chain whose spec changed starts over).
+// dashui_init() does it once; call it again after dashcfg_poll() reloads.
+void dashui_apply_config();
+
+// Applies one frame of the CAN map. False if the id is not ours.
+bool dashui_handle_can(const CanFrame &fr);
+
+// Brings the widgets fed by derived channels (derived.hpp) up to date, once per
+// frame after the CAN frames: the gear label and shift points. Returns the
+// channels computed, 0 if no input changed.
+uint32_t dashui_update_derived();
+
+// Last rpm received, 0xFFFF before the first 0x2000 frame.
+uint16_t dashui_rpm();
+
+// Print every decoded value to stdout (on by default).
+void dashui_set_log(bool on);
+
+// The clock of frames without rx_ns and of the alarm debounces (alarms.hpp),
+// mono_ns() by default. dash_bench plays traces faster than real time on its own.
+void dashui_set_clock(uint64_t (*now_ns)());
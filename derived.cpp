@@ -0,0 +1,183 @@
+#include "derived.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include "dashconfig.hpp"
+
+const char *const DERIVED_NAMES[DRV_COUNT] = { "gear_est", "gear", "oil_margin", "volt_rest", "volt_sag" };
+const uint8_t DERIVED_DECIMALS[DRV_COUNT] = { 0, 0, 2, 1, 1 };
+
+// Nodes of the graph: the channels of cansignals.hpp, then the derived ones.
+static constexpr int NODES = CH_COUNT + DRV_COUNT;
+static constexpr int MAX_INPUTS = 3;
+static constexpr uint8_t D(DerivedId id){ return uint8_t(CH_COUNT + id); }
+static_assert(DRV_COUNT <= 32, "dirty sets are 32-bit masks");
+
+struct Args {
+  int32_t v[MAX_INPUTS];
+  bool    have[MAX_INPUTS];
+  bool    had;        // the channel has a value already, passed in out
+};
+// Sets out and returns true, or returns false if there is no value.
+using DerivedFn = bool (*)(const Args &a, int32_t &out);
+
+struct Def {
+  uint8_t   n;
+  uint8_t   in[MAX_INPUTS];
+  DerivedFn fn;
+};
+
+static constexpr int32_t GEAR_MIN_DKPH = 50;           // 5 kph, slower is N
+static constexpr int32_t GEAR_TOLERANCE_PCT = 8;       // off every ratio by more: clutch in
+static constexpr int32_t OIL_MIN_PER_KRPM = 6895;      // 0.01 kPa; 10 psi per 1000 rpm
+
+static const DashConfig *g_cfg = nullptr;
+
+static bool gear_est(const Args &a, int32_t &out){
+  if (!a.have[0] || !a.have[1]) return false;
+  const int32_t rpm = a.v[0], dkph = a.v[1];
+  if (rpm == 0 || dkph < GEAR_MIN_DKPH) { out = 0; return true; }
+  const DashConfig &c = g_cfg ? *g_cfg : dashcfg();
+  const int64_t r = int64_t(rpm) * 1000 / dkph;         // rpm per kph x100
+  int best = 0;
+  int64_t best_err = 0;
+  for (int g = 1; g <= DASH_GEARS; ++g) {
+    const int64_t ref = c.rpm_per_kph_x100[g];
+    if (!ref) continue;
+    int64_t err = (r > ref ? r - ref : ref - r) * 100 / ref;
+    if (!best || err < best_err) { best = g; best_err = err; }
+  }
+  if (!best || best_err > GEAR_TOLERANCE_PCT) return false;
+  out = best;
+  return true;
+}
+
+static bool gear(const Args &a, int32_t &out){
+  if (a.have[0])      out = a.v[0];
+  else if (a.have[1]) out = a.v[1];
+  else return false;
+  return true;
+}
+
+static bool oil_margin(const Args &a, int32_t &out){
+  if (!a.have[0] || !a.have[1]) return false;
+  out = a.v[0] - int32_t(int64_t(a.v[1]) * OIL_MIN_PER_KRPM / 1000);
+  return true;
+}
+
+static bool volt_rest(const Args &a, int32_t &out){
+  if (!a.have[0]) return false;
+  if (!a.had || !a.have[1] || a.v[1] == 0) out = a.v[0];
+  return true;
+}
+
+static bool volt_sag(const Args &a, int32_t &out){
+  if (!a.have[0] || !a.have[1]) return false;
+  out = a.v[0] > a.v[1] ? a.v[0] - a.v[1] : 0;
+  return true;
+}
+
+// In any order; derived_init() sorts them.
+static constexpr Def DEFS[DRV_COUNT] = {
+  /* DRV_GEAR_EST   */ { 2, { CH_RPM, CH_KPH },               gear_est },
+  /* DRV_GEAR       */ { 2, { CH_GEAR, D(DRV_GEAR_EST) },     gear },
+  /* DRV_OIL_MARGIN */ { 2, { CH_OIL_KPA, CH_RPM },           oil_margin },
+  /* DRV_VOLT_REST  */ { 2, { CH_VOLT, CH_RPM },              volt_rest },
+  /* DRV_VOLT_SAG   */ { 2, { D(DRV_VOLT_REST), CH_VOLT },    volt_sag },
+};
+
+static int32_t  g_val[NODES];
+static bool     g_have[NODES];
+static uint32_t g_users[NODES];          // derived channels reading the node
+static uint32_t g_need[DRV_COUNT];       // the channel and the derived ones it depends on
+static uint8_t  g_order[DRV_COUNT];      // topological
+static bool     g_ok = false;
+static uint32_t g_dirty = 0;
+static uint64_t g_evals = 0;
+
+static constexpr uint32_t ALL = DRV_COUNT == 32 ? 0xFFFFFFFFu : (1u << DRV_COUNT) - 1;
+
+bool derived_init(){
+  g_ok = false;
+  for (uint32_t &u : g_users) u = 0;
+  int indeg[DRV_COUNT] = {};
+  for (int d = 0; d < DRV_COUNT; ++d)
+    for (int i = 0; i < DEFS[d].n; ++i) {
+      g_users[DEFS[d].in[i]] |= 1u << d;
+      if (DEFS[d].in[i] >= CH_COUNT) ++indeg[d];
+    }
+
+  // Kahn: a channel goes once everything it reads is placed.
+  int n = 0;
+  uint32_t placed = 0;
+  while (n < DRV_COUNT) {
+    int d = 0;
+    while (d < DRV_COUNT && ((placed >> d & 1) || indeg[d])) ++d;
+    if (d == DRV_COUNT) {
+      for (d = 0; d < DRV_COUNT && (placed >> d & 1); ++d) {}
+      std::fprintf(stderr, "derived: %s is on a cycle, no derived channels\n", DERIVED_NAMES[d]);
+      return false;
+    }
+    placed |= 1u << d;
+    g_order[n++] = uint8_t(d);
+    g_need[d] = 1u << d;
+    for (int i = 0; i < DEFS[d].n; ++i)
+      if (DEFS[d].in[i] >= CH_COUNT) g_need[d] |= g_need[DEFS[d].in[i] - CH_COUNT];
+    for (int u = 0; u < DRV_COUNT; ++u)
+      if (g_users[CH_COUNT + d] >> u & 1) --indeg[u];
+  }
+  g_ok = true;
+  g_dirty = ALL;
+  return true;
+}
+
+void derived_configure(const DashConfig &c){
+  g_cfg = &c;
+  g_dirty |= 1u << DRV_GEAR_EST;
+}
+
+void derived_input(DashChannel ch, int32_t v){
+  if (g_have[ch] && g_val[ch] == v) return;
+  g_have[ch] = true;
+  g_val[ch] = v;
+  g_dirty |= g_users[ch];
+}
+
+bool derived_dirty(DerivedId id){ return g_dirty & g_need[id]; }
+
+bool derived_get(DerivedId id, int32_t &v){
+  if (!g_ok) return false;
+  const uint32_t need = g_need[id];
+  if (g_dirty & need) {
+    for (uint8_t d : g_order) {
+      if (!(need & g_dirty & 1u << d)) continue;
+      g_dirty &= ~(1u << d);
+      const Def &def = DEFS[d];
+      const int node = CH_COUNT + d;
+      Args a;
+      for (int i = 0; i < def.n; ++i) {
+        a.v[i] = g_val[def.in[i]];
+        a.have[i] = g_have[def.in[i]];
+      }
+      a.had = g_have[node];
+      int32_t out = g_val[node];
+      bool have = def.fn(a, out);
+      ++g_evals;
+      // Only a change goes on to the channels reading this one.
+      if (have != g_have[node] || (have && out != g_val[node])) g_dirty |= g_users[node];
+      g_have[node] = have;
+      if (have) g_val[node] = out;
+    }
+  }
+  v = g_val[CH_COUNT + id];
+  return g_have[CH_COUNT + id];
+}
+
+uint64_t derived_evals(){ return g_evals; }
+
+void derived_reset(){
+  for (int i = 0; i < NODES; ++i) {
+    g_have[i] = false;
+    g_val[i] = 0;
+  }
+  g_dirty = ALL;
+}
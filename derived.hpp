@@ -0,0 +1,43 @@
+#pragma once
+// Derived channels: values computed from the channels of cansignals.hpp (and
+// from each other) instead of read off the bus. Each one declares its inputs in
+// the table of derived.cpp:
+//   gear_est     the gear from rpm / kph and the ratios of the config
+//   gear         the 0x2003 gear once one came in, else gear_est
+//   oil_margin   oil pressure above the usual 10 psi per 1000 rpm, kPa
+//   volt_rest    the voltage while the engine is off, held once it runs
+//   volt_sag     how far the voltage is below volt_rest (cranking, load), V
+// A changed input marks the channels depending on it dirty; a dirty channel is
+// computed only when read, after the dirty ones it depends on, in topological
+// order. Reading a clean channel is a copy. Values are scaled integers like
+// can_decode_fixed()'s, with DERIVED_DECIMALS. No allocation; UI thread only.
+#include <cstdint>
+#include "cansignals.hpp"
+
+struct DashConfig;
+
+enum DerivedId : uint8_t { DRV_GEAR_EST, DRV_GEAR, DRV_OIL_MARGIN, DRV_VOLT_REST, DRV_VOLT_SAG, DRV_COUNT };
+
+extern const char *const DERIVED_NAMES[DRV_COUNT];
+extern const uint8_t DERIVED_DECIMALS[DRV_COUNT];
+
+// Sorts the table, false with the channel on a cycle printed if it has one.
+// Nothing is computed then.
+bool derived_init();
+// The ratios of c (a snapshot of dashcfg(), kept). Marks what uses them dirty.
+void derived_configure(const DashConfig &c);
+
+// A value of ch, in its scale. Unchanged values cost one compare.
+void derived_input(DashChannel ch, int32_t v);
+
+// True if id has to be computed before it can be read.
+bool derived_dirty(DerivedId id);
+// Computes id if dirty, false if it has no value (an input never came in,
+// or it can't tell, like gear_est with the clutch in).
+bool derived_get(DerivedId id, int32_t &v);
+
+// Channels computed so far, for the cost per frame.
+uint64_t derived_evals();
+
+// Forgets every value, keeping the config.
+void derived_reset();
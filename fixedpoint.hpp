@@ -0,0 +1,48 @@
+#pragma once
+// Scaled integers for the signal path. A value is an int32_t count of
+// 10^-dec of its unit (dec 1: 0.1 V, dec 2: 0.01 kPa), which is how the CAN
+// map sends it. Decoding, filtering (chanfilter.hpp) and formatting all keep
+// that form, so a label shows exactly the decimal that was decoded. No frame
+// pays for a float divide or for printf's double-to-decimal conversion.
+#include <cstdint>
+
+// 10^dec, dec 0..9.
+constexpr int32_t fx_pow10(unsigned dec){
+  return dec == 0 ? 1 : 10 * fx_pow10(dec - 1);
+}
+
+// Integer division rounding half away from zero. d > 0.
+constexpr int64_t fx_div_round(int64_t n, int64_t d){
+  return n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d);
+}
+
+// v with dec decimals rescaled to to_dec decimals, rounded half away from zero.
+constexpr int32_t fx_rescale(int32_t v, unsigned dec, unsigned to_dec){
+  return to_dec >= dec ? v * fx_pow10(to_dec - dec) : int32_t(fx_div_round(v, fx_pow10(dec - to_dec)));
+}
+
+// Writes v with dec decimals ("-12.34" for -1234, 2), NUL-terminated, to out of
+// at least FX_FORMAT_MAX bytes. Returns the length.
+static constexpr int FX_FORMAT_MAX = 13;
+inline int fx_format(char *out, int32_t v, unsigned dec){
+  char tmp[FX_FORMAT_MAX];
+  int n = 0;
+  uint32_t u = v < 0 ? 0u - uint32_t(v) : uint32_t(v);
+  do {
+    tmp[n++] = char('0' + u % 10);
+    u /= 10;
+    if (unsigned(n) == dec) tmp[n++] = '.';
+  } while (u || unsigned(n) <= dec + (dec > 0));   // a digit before the point too
+  if (v < 0) tmp[n++] = '-';
+
+  for (int i = 0; i < n; ++i) out[i] = tmp[n - 1 - i];
+  out[n] = 0;
+  return n;
+}
+
+// A smoothing factor 0..1 as an 8.24 fraction (chanfilter.hpp's ewma); 24
+// bits keep 0.01 within 1e-6 of itself.
+constexpr uint32_t fx_alpha(double a){
+  return uint32_t(a * 16777216.0 + 0.5);
+}
+
@@ -0,0 +1,147 @@
+#include "latency.hpp"
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+static constexpr uint32_t BUCKET_US = 100;
+static constexpr uint32_t BUCKETS   = 1000;  // 0..100 ms, then the overflow bucket
+
+enum Stage { RX_WIDGET, WIDGET_FLUSH, FLUSH_PRESENT, RX_PRESENT, RX_LEDS, STAGES };
+static const char *const STAGE_NAMES[STAGES] = { "rx->widget", "widget->flush", "flush->present", "rx->present",
+                                                 "rx->leds" };
+
+struct Histogram {
+  uint32_t bucket[BUCKETS + 1];
+  uint64_t count, max_ns;
+};
+
+// The sample in flight.
+struct Sample {
+  bool     open, flushed, presented, leds;
+  uint32_t rpm;
+  lv_obj_t *obj[2];
+  uint64_t rx_ns, widget_ns, flush_ns;
+};
+
+static std::mutex g_mutex;
+static std::atomic<bool> g_on{false};
+static uint64_t   g_rx_ns;     // of the frame being handled
+static Sample     g_cur;
+static Histogram  g_hist[STAGES];
+static uint64_t   g_superseded, g_unchanged, g_candidates;
+
+static uint64_t now_ns(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static void add(Stage s, uint64_t from, uint64_t to){
+  uint64_t d = to > from ? to - from : 0;
+  Histogram &h = g_hist[s];
+  uint64_t b = d / (BUCKET_US * 1000ull);
+  ++h.bucket[b < BUCKETS ? b : BUCKETS];
+  ++h.count;
+  if (d > h.max_ns) h.max_ns = d;
+}
+
+void latency_enable(bool on){ g_on = on; }
+
+bool latency_enabled(){ return g_on; }
+
+void latency_rx(uint64_t rx_ns){
+  if (!g_on) return;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (g_rx_ns) ++g_unchanged;  // the previous one never reached a widget
+  g_rx_ns = rx_ns ? rx_ns : now_ns();
+  ++g_candidates;
+}
+
+void latency_value(uint32_t rpm, lv_obj_t *a, lv_obj_t *b){
+  if (!g_on) return;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (!g_rx_ns) return;
+  if (g_cur.open && !g_cur.flushed) ++g_superseded;
+  uint64_t now = now_ns();
+  g_cur = Sample{ true, false, false, false, rpm, { a, b }, g_rx_ns, now, 0 };
+  g_rx_ns = 0;
+  add(RX_WIDGET, g_cur.rx_ns, now);
+}
+
+void latency_flush(const lv_area_t *area){
+  if (!g_on) return;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (!g_cur.open || g_cur.presented) return;
+  for (lv_obj_t *obj : g_cur.obj) {
+    lv_area_t common;
+    if (obj && _lv_area_intersect(&common, area, &obj->coords)) {
+      g_cur.flush_ns = now_ns();
+      g_cur.flushed = true;
+    }
+  }
+}
+
+void latency_present(){
+  if (!g_on) return;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (!g_cur.flushed || g_cur.presented) return;
+  uint64_t now = now_ns();
+  add(WIDGET_FLUSH, g_cur.widget_ns, g_cur.flush_ns);
+  add(FLUSH_PRESENT, g_cur.flush_ns, now);
+  add(RX_PRESENT, g_cur.rx_ns, now);
+  g_cur.presented = true;
+}
+
+void latency_leds(uint32_t rpm){
+  if (!g_on) return;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (!g_cur.open || g_cur.leds || g_cur.rpm != rpm) return;
+  add(RX_LEDS, g_cur.rx_ns, now_ns());
+  g_cur.leds = true;
+}
+
+// Upper edge of the bucket holding the p-th sample (at most the max), in ms.
+static double percentile(const Histogram &h, double p){
+  if (!h.count) return 0;
+  uint64_t want = uint64_t(p * double(h.count - 1)) + 1, seen = 0;
+  for (uint32_t i = 0; i <= BUCKETS; ++i) {
+    seen += h.bucket[i];
+    if (seen >= want) return i < BUCKETS ? std::min((i + 1) * BUCKET_US / 1000.0, h.max_ns / 1e6) : h.max_ns / 1e6;
+  }
+  return h.max_ns / 1e6;
+}
+
+void latency_report(FILE *f, bool reset){
+  std::lock_guard<std::mutex> lock(g_mutex);
+  std::fprintf(f, "[latency] rpm frames %llu: %llu on screen, %llu superseded, %llu unchanged\n",
+               (unsigned long long)g_candidates, (unsigned long long)g_hist[RX_PRESENT].count,
+               (unsigned long long)g_superseded, (unsigned long long)g_unchanged);
+  std::fprintf(f, "[latency] %-15s %8s %8s %8s %8s %8s\n", "ms", "count", "p50", "p90", "p99", "max");
+  for (int s = 0; s < STAGES; ++s) {
+    const Histogram &h = g_hist[s];
+    std::fprintf(f, "[latency] %-15s %8llu %8.1f %8.1f %8.1f %8.1f\n", STAGE_NAMES[s], (unsigned long long)h.count,
+                 percentile(h, 0.5), percentile(h, 0.9), percentile(h, 0.99), h.max_ns / 1e6);
+  }
+
+  // rx -> present in 5 ms steps, one '#' per 2% of the samples.
+  const Histogram &h = g_hist[RX_PRESENT];
+  if (h.count) {
+    for (uint32_t lo = 0; lo < BUCKETS; lo += 50) {
+      uint64_t n = 0;
+      for (uint32_t i = lo; i < lo + 50; ++i) n += h.bucket[i];
+      if (!n) continue;
+      std::fprintf(f, "[latency] %3u-%3u ms %7llu %.*s\n", (unsigned)(lo * BUCKET_US / 1000),
+                   (unsigned)((lo + 50) * BUCKET_US / 1000), (unsigned long long)n, int(n * 50 / h.count),
+                   "##################################################");
+    }
+    if (h.bucket[BUCKETS])
+      std::fprintf(f, "[latency]    >100 ms %7llu\n", (unsigned long long)h.bucket[BUCKETS]);
+  }
+  std::fflush(f);
+
+  if (reset) {
+    for (Histogram &hh : g_hist) hh = Histogram{};
+    g_superseded = g_unchanged = g_candidates = 0;
+  }
+}
@@ -0,0 +1,35 @@
+#pragma once
+// CAN-to-photon latency of the rpm. The newest 0x2000 frame whose value the
+// handler pushes into the widgets is followed through the loop:
+//   rx       frame received (kernel timestamp, CanFrame::rx_ns)
+//   widget   value set on the label and bar (dashui.cpp)
+//   flush    last flushed area covering them (sdl_flush)
+//   present  SDL_RenderPresent() returned
+//   leds     the strip shows that rpm
+// A frame superseded before its value is flushed is counted, not timed.
+// Stage times go into 0.1 ms histograms, printed by latency_report().
+// Off until latency_enable(); the calls then cost a lock and a clock read.
+#include <cstdint>
+#include <cstdio>
+
+extern "C" {
+  #include "lvgl.h"
+}
+
+void latency_enable(bool on);
+bool latency_enabled();
+
+// Before handling a frame carrying the rpm; rx_ns 0 means now.
+void latency_rx(uint64_t rx_ns);
+// The handler pushed rpm into a and b (b may be NULL).
+void latency_value(uint32_t rpm, lv_obj_t *a, lv_obj_t *b);
+// From the flush callback, for every area.
+void latency_flush(const lv_area_t *area);
+// After the frame is on the screen.
+void latency_present();
+// The LEDs show rpm; from any thread.
+void latency_leds(uint32_t rpm);
+
+// Percentiles of every stage and the rx -> present histogram; clears them
+// when reset.
+void latency_report(FILE *f, bool reset);
@@ -31,6 +31,18 @@
  *********************/
 #define LV_USE_DRAW_SW          1             /* software renderer (required) */
 #define LV_USE_GPU_SDL          0             /* disable SDL GPU acceleration */
+#ifndef LV_USE_DRAW_SW_ASM                    /* CMake sets NEON (DASH_DRAW_SW_NEON) */
+#define LV_USE_DRAW_SW_ASM      LV_DRAW_SW_ASM_NONE
+#endif
+#ifndef LV_USE_REFR_THREADS                   /* CMake sets it (DASH_REFR_THREADS) */
+#define LV_USE_REFR_THREADS     0
+#endif
+#define LV_REFR_THREAD_CNT      4             /* main thread + 3 helpers, one per Pi 5 core */
+#define LV_REFR_THREAD_CPU_FIRST 1            /* helpers on cores 1..3 */
+#define LV_CIRCLE_CACHE_SIZE    16            /* rounded buttons, their shadows, bar and arc radii */
+#ifndef LV_USE_REFR_OCCLUSION
+#define LV_USE_REFR_OCCLUSION   1             /* skip objects hidden by the rpm overlays */
+#endif
 
 /*********************
  * FILESYSTEM
@@ -123,8 +135,17 @@
 #define LV_USE_ASSERT_OBJ       1
 #define LV_USE_ASSERT_STYLE     1
 #define LV_MEM_CUSTOM           0
+#define LV_MEM_SIZE             (256U * 1024U) /* per-thread draw buffers, cached speed arc track */
+#define LV_MEM_EXPAND_SIZE      (128U * 1024U) /* grow with malloc instead of failing on heavier screens */
+#define LV_MEM_SLAB_SIZE        (32U * 1024U)  /* label texts, styles, timers, anims out of the TLSF pool */
+#define LV_MEM_FRAME_SIZE       (8U * 1024U)   /* per drawing thread; the dash peaks at ~1.2 kB */
 #define LV_USE_PERF_MONITOR     0
 #define LV_USE_REFR_DEBUG       0
+#ifndef LV_USE_TRACE                          /* CMake sets it (DASH_TRACE) */
+#define LV_USE_TRACE            0
+#endif
+#define LV_TRACE_BUF_EVENTS     16384         /* 256 kB per thread, ~2 s of the UI loop */
+#define LV_TRACE_MAX_THREADS    8             /* ui, leds, 3 refr helpers and spares */
 
 /*********************
  * MISC
@@ -1,28 +1,45 @@
 // Raspberry Pi dash for DTAFast T8+
 // LVGL + SDL2 + SocketCAN + WS2812 via rpi_ws281x (GPIO PWM/PCM)
-// CAN map:
-//   0x2000: RPM      @ 0..1 (U16 / 1)
-//   0x2001: OilPres  @ 6..7 (U16 / 10.0 kPa)
-//   0x2002: OilTemp  @ 2..3 (U16 / 10.0 °C) ; Voltage @ 4..5 (U16 / 10.0 V)
+// The screen and the CAN map are in dashui.cpp.
+//   raspi_dash [ifname]                          frames from SocketCAN (can0)
+//   raspi_dash -r log [-s speed | -m] [-l]       frames from a candump/ASC/binary log
+//     -s  replay speed factor, 2 is twice as fast (default: the log's own timing)
+//     -m  no timing: up to MAX_CAN_PER_FRAME frames every loop, as fast as they decode
+//     -l  loop the log
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstdint>
+#include <cerrno>
+#include <csignal>
 #include <cmath>
 #include <algorithm>
 #include <vector>
 #include <SDL2/SDL.h>
 #include <cstring>
+#include <ctime>
+#include <atomic>
+#include <thread>
 #include <iostream>   // LED test includes
 #include <unistd.h>   // LED test includes (sleep/usleep)
 #include <ws2811.h>   // LED test includes
 
 extern "C" {
   #include "lvgl.h"
-  #include "ui.h"
 }
 
 #include "socketcan.hpp"
-#include "config.h"     // must provide RPM_MAX, etc.
+#include "cantrace.hpp"
+#include "canlog.hpp"
+#include "shiftlight.hpp"
+#include "shiftpoint.hpp"
+#include "dashui.hpp"
+#include "latency.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
+#include "dashconfig.hpp"
+#include "alarms.hpp"
+#include "fixedpoint.hpp"
 
 // =================== Display config ===================
 static constexpr int SCR_W = 800;
@@ -31,13 +48,88 @@ static constexpr int SCR_H = 480;
 // =================== CAN throttle =====================
 static constexpr int MAX_CAN_PER_FRAME = 300;
 
+// =================== Latency ==========================
+// CAN-to-photon latency of the rpm (latency.hpp) on stdout every N seconds and
+// at exit; 0 turns the tracing off.
+static constexpr uint32_t LATENCY_REPORT_S = 10;
+
+// =================== Trace ============================
+// With DASH_TRACE the loop stages and LVGL's refresh and draw calls are traced
+// (trace.hpp); the last few seconds of every thread go to TRACE_PATH as Chrome
+// trace JSON on SIGUSR1 (kill -USR1 $(pidof raspi_dash)) and at exit.
+static constexpr const char *TRACE_PATH = "/tmp/dash-trace.json";
+static volatile std::sig_atomic_t g_trace_dump = 0;
+
+static void on_sigusr1(int){ g_trace_dump = 1; }
+
+static void trace_dump(){
+#if LV_USE_TRACE
+  if (lv_trace_dump(TRACE_PATH) == LV_RES_OK) std::printf("trace: wrote %s\n", TRACE_PATH);
+  else std::fprintf(stderr, "trace: %s: %s\n", TRACE_PATH, std::strerror(errno));
+#endif
+}
+
+// =================== Metrics ==========================
+// Frame times, CAN rates, drops, LED renders and lv_mem (metrics.hpp), served
+// on METRICS_SOCKET ("" for none) and drawn as an overlay toggled by 'm' or by
+// a DASH_CMD_ID frame: data[0] 0x01 = overlay, data[1] 0 off, 1 on, 2 toggle.
+static constexpr const char *METRICS_SOCKET = "/tmp/dash-metrics.sock";
+static constexpr uint32_t    DASH_CMD_ID = 0x2100;
+
+static void handle_command(const CanFrame &fr){
+  if (fr.dlc >= 2 && fr.data[0] == 0x01) metrics_overlay(fr.data[1] == 2 ? -1 : fr.data[1] ? 1 : 0);
+}
+
+// =================== Config ===========================
+// Shift points, rpm range and warning thresholds (dashconfig.hpp), read at
+// start (-c overrides the path) and again whenever the file is saved. Without
+// the file the defaults of config.h apply.
+static constexpr const char *CONFIG_PATH = "/etc/dash.conf";
+
+// =================== CAN log ==========================
+// Every frame read from the bus goes to a ring of mmap'd segment files
+// (canlog.hpp); replays are not logged. "" turns the logger off.
+static constexpr const char *CAN_LOG_DIR = "/var/log/dash";
+static CanLog g_canlog;
+
 // =================== LED strip (ws281x) ===============
 // Use rpi_ws281x (no spi_ws2812.hpp). Supported pins for WS281X: 18,12,13,19.
 static constexpr int   LED_PIN = 18;                 // <-- set your GPIO here
 static constexpr int   LED_COUNT = 19;
 static constexpr int   LED_BRIGHTNESS = 128;         // 0..255
-static constexpr uint32_t FLICKER_INTERVAL_MS = 20;  // flash cadence for ≥85%
 static constexpr uint32_t RPM_TIMEOUT_MS      = 400; // blank if no RPM frame
+// Drive the strip from its own thread instead of the UI loop. Flash timing is
+// identical either way (see shiftlight.hpp); the thread only decouples LED
+// refreshes from render stalls.
+static constexpr bool     LED_THREAD          = false;
+static constexpr uint32_t LED_THREAD_TICK_MS  = 10;  // max sleep between refreshes
+
+// =================== Alarms ===========================
+// Alarm edges (alarms.hpp) are logged to stdout. While any alarm is on, the
+// two end LEDs of the strip blink over the rpm bar in the colour of the
+// top-priority one, even with the engine off.
+struct LedRgb { uint8_t r, g, b; };
+static constexpr LedRgb ALARM_LED_RGB[ALARM_COUNT] = {
+  /* ALARM_TEMP_HIGH        */ { 255, 80, 0 },
+  /* ALARM_OIL_PRESSURE_LOW */ { 255, 0,  0 },
+  /* ALARM_VOLTAGE_LOW      */ { 0,   0,  255 },
+};
+static constexpr FlashPattern ALARM_LED_PATTERN = { 500, 250 };
+static std::atomic<int> g_led_alarm{-1};  // alarms_top(), read by the LED thread
+
+static void on_alarm(const AlarmEvent &ev, void *){
+  const AlarmDef &d = alarm_def(ev.id);
+  char buf[FX_FORMAT_MAX];
+  fx_format(buf, ev.value, DASH_CHANNEL_DECIMALS[d.ch]);
+  std::printf("[ALARM] %s %s, %s=%s\n", d.name, ev.active ? "on" : "off", DASH_CHANNEL_NAMES[d.ch], buf);
+  g_led_alarm.store(alarms_top(), std::memory_order_relaxed);
+}
+
+// =================== RPM bar ==========================
+// Draw the rpm bar with one widget (rpmbar.h) instead of the SquareLine stack of
+// buttons + lv_bar; it redraws only the columns the rpm moved over.
+// false brings the composite back.
+static constexpr bool RPMBAR_WIDGET = true;
 
 // ws281x controller
 static ws2811_t g_leds;
@@ -48,22 +140,33 @@ static inline uint32_t grb(uint8_t r, uint8_t g, uint8_t b){
 }
 
 static bool     g_leds_on   = false;
-static bool     g_flash_on  = true;
-static uint32_t g_last_flash_ms    = 0;
+static uint32_t g_leds_shown[LED_COUNT];  // last frame sent to the strip
 static uint32_t g_last_rpm_framems = 0;
 
+// LED thread (LED_THREAD only): the UI loop publishes rpm, the thread renders.
+static std::atomic<uint16_t> g_led_rpm{0};
+static std::atomic<bool>     g_led_run{false};
+static std::thread           g_led_thread;
+
 // LED helpers
 static inline void leds_clear_all(){
   for (int i=0;i<LED_COUNT;++i) g_leds.channel[0].leds[i] = 0;
 }
 static inline void leds_show(){
+  // Skip the DMA round trip when the frame has not changed.
+  if (g_leds_on && std::memcmp(g_leds_shown, g_leds.channel[0].leds, sizeof(g_leds_shown)) == 0) return;
+  TRACE_SCOPE("led render");
   ws2811_render(&g_leds);
+  metrics_led_render();
+  std::memcpy(g_leds_shown, g_leds.channel[0].leds, sizeof(g_leds_shown));
   g_leds_on = true;
 }
 static inline void leds_off(){
   if (!g_leds_on) return;
   leds_clear_all();
+  TRACE_SCOPE("led render");
   ws2811_render(&g_leds);
+  metrics_led_render();
   g_leds_on = false;
 }
 static inline void leds_set_rgb(int i, uint8_t r, uint8_t g, uint8_t b){
@@ -72,186 +175,54 @@ static inline void leds_set_rgb(int i, uint8_t r, uint8_t g, uint8_t b){
 }
 
 // Progressive RPM LEDs:
-// 0–50%  = GREEN
-// 50–75% = AMBER
-// 75–85% = RED
-// ≥85%   = PURPLE and the whole lit section flashes (F1 style)
-static void updateRPMLEDs_progress(uint16_t rpm, uint32_t now_ms){
-  if (rpm == 0) { leds_off(); return; }
-
-  const float max_rpm = float(RPM_MAX);
-  if (max_rpm <= 0.0f) { leds_off(); return; }
-
-  float pct = std::min(1.0f, rpm / (float)RPM_DISPLAY_MAX);      // 0..1
-  int   lit = int(std::round(pct * LED_COUNT));   // LEDs to light (0..LED_COUNT)
-
-  const bool should_flash = (pct >= 0.85);
-  if (should_flash) {
-    if (now_ms - g_last_flash_ms >= FLICKER_INTERVAL_MS) {
-      g_last_flash_ms = now_ms;
-      g_flash_on = !g_flash_on;
-    }
-    if (!g_flash_on) { leds_off(); return; }      // flash OFF frame
-  }
+// up to the gear's shift-up point = RED
+// past it                         = PURPLE
+// The whole lit section flashes fast while the shift-point engine
+// (shiftpoint.hpp) says shift up (F1 style), slowly for shift down.
+static void updateRPMLEDs_progress(uint16_t rpm, uint64_t now_ns){
+  const int alarm = g_led_alarm.load(std::memory_order_relaxed);
+  const bool alarm_lit = alarm >= 0 && flash_lit(ALARM_LED_PATTERN, now_ns);
+  // rpm / rpm_display_max in 16.16 from the config's reciprocal: no divide or
+  // float on this path, which runs on every frame (or on the LED thread).
+  const DashConfig &cfg = dashcfg();
+  uint32_t pct = cfg.rpm_frac_q16(rpm);                     // 0..1.0
+  int      lit = int((pct * LED_COUNT + 0x8000) >> 16);     // LEDs to light (0..LED_COUNT)
+
+  const ShiftState shift = shiftpoint_state();
+  if (rpm == 0 || !shift_flash_lit(shift.flash, now_ns)) lit = 0;  // off, or the flash's OFF phase
+  const uint32_t up = cfg.rpm_frac_q16(shift.up);         // the purple starts here
+  if (lit == 0 && !alarm_lit) { leds_off(); return; }
 
   leds_clear_all();
   for (int i = 0; i < lit; ++i) {
-    float pos = float(i + 1) / float(LED_COUNT);  // position 0..1 across strip
+    uint32_t pos = uint32_t(i + 1) << 16;       // position across strip, x LED_COUNT
     uint8_t r=0,g=0,b=0;
-    if      (pos <= 0.85){ g=0;   r=255; b=0;   } // red
-    else                   { g=0; r=128;   b=128; } // PURPLE
+    if (pos <= up * LED_COUNT){ g=0; r=255; b=0;   } // red
+    else                      { g=0; r=128; b=128; } // PURPLE
     leds_set_rgb(i, g, r, b);
   }
-  leds_show();
-}
-
-// ===================== CAN parsing =====================
-static uint16_t last_rpm_raw=0xFFFF, last_speed_raw=0xFFFF,last_oilp_raw=0xFFFF, last_oilt_raw=0xFFFF, last_volt_raw=0xFFFF;
-
-static inline uint16_t u16_le(const uint8_t *d){ return uint16_t(d[0] | (uint16_t(d[1])<<8)); }
-static inline uint16_t u16_be(const uint8_t *d){ return uint16_t((uint16_t(d[0])<<8) | d[1]); }
-static inline uint16_t u16_auto(const uint8_t *d, const char *name, bool *used_be) {
-  uint16_t le=u16_le(d);
-  if (le != 0){ if(used_be) *used_be=false; return le; }
-  uint16_t be=u16_be(d);
-#if 1
-  std::printf("[CAN] %s: LE=0 using BE=%u\n", name, (unsigned)be);
-#endif
-  if(used_be) *used_be=true;
-  return be;
-}
-
-// extern UI objects
-extern "C" lv_obj_t *ui_erpmbar;
-extern "C" lv_obj_t *ui_erpm;
-extern "C" lv_obj_t *ui_erpmbackswitchup;
-extern "C" lv_obj_t *ui_erpmbackswitchdown;
-extern "C" lv_obj_t *ui_eoilpressure;
-extern "C" lv_obj_t *ui_oilpressuredu;
-extern "C" lv_obj_t *ui_eoilpressureback;
-extern "C" lv_obj_t *ui_eoiltemperature;
-extern "C" lv_obj_t *ui_oiltemperaturedu;
-extern "C" lv_obj_t *ui_eoiltemperatureback;
-extern "C" lv_obj_t *ui_evoltage;
-extern "C" lv_obj_t *ui_voltagedu;
-extern "C" lv_obj_t *ui_evoltageback;
-extern "C" lv_obj_t *ui_egear;
-
-
-//0x2000 rpm
-static void handle_2000(const CanFrame &fr){
-  bool used_be=false;
-  uint16_t rpm = u16_auto(&fr.data[0], "rpm", &used_be);
-  
-
-#if 1
-  std::printf("[CAN] 2000 rpm=%u%s\n", (unsigned)rpm, used_be?" (BE)":"");
-#endif
-
-  if (last_rpm_raw == 0xFFFF || std::abs(int(rpm) - int(last_rpm_raw)) >= 1) {
-    last_rpm_raw = rpm;
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%u",(unsigned)rpm);
-    lv_label_set_text(ui_erpm, buf32);
-    lv_bar_set_value(ui_erpmbar, rpm, LV_ANIM_OFF);
-  }
-
-  uint16_t raw_t = u16_auto(&fr.data[4], "coolT", &used_be);
-  double c = raw_t;
-#if 1
-  std::printf("[CAN] 2000 coolt_raw=%u C=%.1f%s\n",(unsigned)raw_t,c,used_be?" (BE)":"");
-#endif
-  if (raw_t != last_oilt_raw){
-    last_oilt_raw = raw_t;
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%.1f",c);
-    lv_label_set_text(ui_eoiltemperature, buf32);
-    lv_obj_set_style_text_color(ui_eoiltemperature,  lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_color(ui_oiltemperaturedu, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_add_flag(ui_eoiltemperatureback, LV_OBJ_FLAG_HIDDEN); // visible already
-  }
-
-  // Update LEDs based on CAN RPM moved to main loop
- 
-}
-static void speed(const CanFrame &fr) {
-  bool used_be = false;
-  uint16_t raw = u16_auto(&fr.data[4], "speed kph", &used_be);
-  double speed = raw / 10.0;
-  #if 1
-    std::printf("[CAN] 2001 oilP_raw=%u kPa=%.1f%s\n",(unsigned)raw,speed,used_be?" (BE)":"");
-  #endif
-  if (last_speed_raw != raw) {
-    last_speed_raw = raw;
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%u",(unsigned)speed);
-    lv_label_set_text(ui_espeed, buf32);
-    lv_arc_set_value(ui_espeedarc, speed);
-  }
-
-}
-
-//0x2001 pressure
-static void handle_2001(const CanFrame &fr){
-  speed(fr);
-  bool used_be = false;
-  uint16_t raw = u16_auto(&fr.data[6], "oilP", &used_be);
-  double kpa = raw/100.0;
-  static bool avg_init = false;
-  static double oilp_avg = 0.0;
-
-  constexpr double alpha = 0.01; // tune this (0.05–0.2 typical)
-
-  if (!avg_init) {
-      oilp_avg = kpa;   // first sample
-      avg_init = true;
-  } else {
-      oilp_avg += alpha * (kpa - oilp_avg);
-  }
-
-#if 1
-  std::printf("[CAN] 2001 oilP_raw=%u kPa=%.1f%s\n",(unsigned)raw,oilp_avg,used_be?" (BE)":"");
-#endif
-  if (true){
-    last_oilp_raw = raw;
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%.1f",oilp_avg);
-    lv_label_set_text(ui_eoilpressure, buf32);
-    lv_obj_set_style_text_color(ui_eoilpressure,  lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_color(ui_oilpressuredu, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_add_flag(ui_eoilpressureback, LV_OBJ_FLAG_HIDDEN);
-  }
-}
-
-//0x2002 temperature voltage
-static void handle_2002(const CanFrame &fr){
-  bool used_be=false;
-  uint16_t raw_v = u16_auto(&fr.data[4], "volt", &used_be);
-  double v = raw_v / 10.0;
-#if 1
-  std::printf("[CAN] 2002 volt_raw=%u V=%.1f%s\n",(unsigned)raw_v,v,used_be?" (BE)":"");
-#endif
-  if (raw_v != last_volt_raw){
-    last_volt_raw = raw_v;
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%.1f",v);
-    lv_label_set_text(ui_evoltage, buf32);
-    lv_obj_set_style_text_color(ui_evoltage,  lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_color(ui_voltagedu, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_add_flag(ui_evoltageback, LV_OBJ_FLAG_HIDDEN);
+  if (alarm_lit) {
+    const LedRgb &c = ALARM_LED_RGB[alarm];
+    leds_set_rgb(0, c.g, c.r, c.b);               // same channel order as the bar
+    leds_set_rgb(LED_COUNT - 1, c.g, c.r, c.b);
   }
+  leds_show();
+  if (lit) latency_leds(rpm);
 }
 
-// 0x2003 — Gear
-static void handle_2003(const CanFrame &fr){
-  uint8_t g0 = fr.data[0];
-  uint8_t g1 = fr.data[1];
-  uint8_t g  = g0 ? g0 : g1;
-  if (g == 0) lv_label_set_text(ui_egear, "N");
-  else {
-    char buf32[32];
-    std::snprintf(buf32,sizeof(buf32),"%u",(unsigned)g);
-    lv_label_set_text(ui_egear, buf32);
+// Sleeps until the next flash edge (or LED_THREAD_TICK_MS) on absolute deadlines.
+static void led_thread_main(){
+  TRACE_THREAD("leds");
+  while (g_led_run.load(std::memory_order_relaxed)) {
+    uint16_t rpm = g_led_rpm.load(std::memory_order_relaxed);
+    uint64_t now = mono_ns();
+    updateRPMLEDs_progress(rpm, now);
+    uint64_t wake = std::min<uint64_t>(shift_flash_next_edge(shiftpoint_state().flash, now),
+                                       now + uint64_t(LED_THREAD_TICK_MS) * 1000000ull);
+    if (g_led_alarm.load(std::memory_order_relaxed) >= 0)
+      wake = std::min(wake, flash_next_edge(ALARM_LED_PATTERN, now));
+    timespec ts{ time_t(wake / 1000000000ull), long(wake % 1000000000ull) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
   }
 }
 
@@ -265,14 +236,48 @@ static SDL_Texture*  g_tex = nullptr;
 static bool g_need_present = false;
 
 static void sdl_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p){
+  TRACE_SCOPE("sdl_flush");
   int w = area->x2 - area->x1 + 1;
   SDL_Rect rect{ area->x1, area->y1, w, area->y2 - area->y1 + 1 };
   SDL_UpdateTexture(g_tex, &rect, color_p, w * (int)sizeof(lv_color_t));
+  latency_flush(area);
   g_need_present = true;
   lv_disp_flush_ready(drv);
 }
 
 int main(int argc, char *argv[]){
+  const char *replay_path = nullptr;
+  double replay_speed = 1.0;
+  bool replay_loop = false;
+  const char *config_path = CONFIG_PATH;
+  for (int c; (c = getopt(argc, argv, "r:s:mlc:")) != -1;) {
+    switch (c) {
+      case 'r': replay_path = optarg; break;
+      case 's': replay_speed = std::atof(optarg); break;
+      case 'm': replay_speed = 0; break;
+      case 'l': replay_loop = true; break;
+      case 'c': config_path = optarg; break;
+      default:
+        std::fprintf(stderr, "usage: %s [-c config] [ifname] | -r log [-s speed | -m] [-l]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  // Before the LEDs and the screen: a log that can't be read is an error, not
+  // an idle dash.
+  std::vector<TraceFrame> trace;
+  if (replay_path) {
+    bool ok = canlog_is_log(replay_path) ? canlog_load(replay_path, trace) : cantrace_load(replay_path, trace);
+    if (!ok) {
+      std::fprintf(stderr, "can't read %s\n", replay_path);
+      return 1;
+    }
+  }
+
+  dashcfg_load(config_path);
+  if (!dashcfg_watch(config_path))
+    std::fprintf(stderr, "config: can't watch %s: %s\n", config_path, std::strerror(errno));
+
   // ---------- ws281x init ----------
   std::memset(&g_leds, 0, sizeof(ws2811_t));
   g_leds.freq                 = WS2811_TARGET_FREQ;
@@ -316,44 +321,75 @@ int main(int argc, char *argv[]){
   disp_drv.draw_buf = &g_draw_buf; disp_drv.flush_cb = sdl_flush;
   lv_disp_drv_register(&disp_drv);
 
-  ui_init();
-  lv_obj_add_flag(ui_erpmbackswitchup,   LV_OBJ_FLAG_HIDDEN);
-  lv_obj_add_flag(ui_erpmbackswitchdown, LV_OBJ_FLAG_HIDDEN);
+  alarms_listen(on_alarm, nullptr);
+  dashui_init(RPMBAR_WIDGET);
 
   // ---------- CAN ----------
   char ifname[64];
-  if (argc > 1) std::strncpy(ifname, argv[1], sizeof(ifname)-1), ifname[sizeof(ifname)-1]=0;
+  if (optind < argc) std::strncpy(ifname, argv[optind], sizeof(ifname)-1), ifname[sizeof(ifname)-1]=0;
   else std::strcpy(ifname, "can0");
   SocketCan can(ifname);
-  can.open();
+  std::optional<CanReplay> replay;
+  if (replay_path) {
+    std::printf("replaying %zu frames of %s\n", trace.size(), replay_path);
+    replay.emplace(std::move(trace), replay_speed, replay_loop);
+  } else {
+    can.open();
+    CanLogOptions log_opt;
+    log_opt.dir = CAN_LOG_DIR;
+    if (CAN_LOG_DIR[0] && !g_canlog.open(log_opt))
+      std::fprintf(stderr, "canlog: %s: %s, not logging\n", CAN_LOG_DIR, std::strerror(errno));
+  }
 
   bool quit=false;
   uint32_t last_tick=SDL_GetTicks();
+  uint32_t last_report=last_tick;
+  latency_enable(LATENCY_REPORT_S > 0);
   g_last_rpm_framems = last_tick;
 
+  TRACE_THREAD("ui");
+  std::signal(SIGUSR1, on_sigusr1);
+  if (METRICS_SOCKET[0] && !metrics_serve(METRICS_SOCKET))
+    std::fprintf(stderr, "metrics: %s: %s\n", METRICS_SOCKET, std::strerror(errno));
+
+  if (LED_THREAD) {
+    g_led_run = true;
+    g_led_thread = std::thread(led_thread_main);
+  }
+
   // ---------- Main loop ----------
   while(!quit){
     SDL_Event e;
     while(SDL_PollEvent(&e)){
       if(e.type==SDL_QUIT) quit=true;
       if(e.type==SDL_KEYDOWN && (e.key.keysym.sym==SDLK_ESCAPE || e.key.keysym.sym==SDLK_q)) quit=true;
+      if(e.type==SDL_KEYDOWN && e.key.keysym.sym==SDLK_m) metrics_overlay(-1);
     }
-
-    for(int i=0;i<MAX_CAN_PER_FRAME;++i){
-      auto fr = can.read_nonblock();
-      if(!fr) break;
-      uint32_t id = fr->id & 0x1FFFFFFF;
-      switch(id){
-        case 0x2000: handle_2000(*fr); break;
-        case 0x2001: handle_2001(*fr); break;
-        case 0x2002: handle_2002(*fr); break;
-        case 0x2003: handle_2003(*fr); break;
-        default: break;
+    if (dashcfg_poll()) dashui_apply_config();
+
+    {
+      TRACE_SCOPE("can drain");
+      for(int i=0;i<MAX_CAN_PER_FRAME;++i){
+        auto fr = replay ? replay->read_nonblock() : can.read_nonblock();
+        if(!fr) break;
+        if (g_canlog.is_open()) g_canlog.frame(*fr);
+        if (fr->id == 0x2000) latency_rx(fr->rx_ns);
+        TRACE_SCOPE("decode");
+        uint64_t t0 = mono_ns();
+        if (fr->id == DASH_CMD_ID) handle_command(*fr);
+        else dashui_handle_can(*fr);
+        metrics_can(fr->id, mono_ns() - t0);
       }
-
+    }
+    {
+      TRACE_SCOPE("derived");
+      uint64_t t0 = mono_ns();
+      uint32_t n = dashui_update_derived();
+      metrics_derived(n, mono_ns() - t0);
     }
     g_last_rpm_framems = SDL_GetTicks();
-    updateRPMLEDs_progress(last_rpm_raw, SDL_GetTicks());
+    if (LED_THREAD) g_led_rpm.store(dashui_rpm(), std::memory_order_relaxed);
+    else            updateRPMLEDs_progress(dashui_rpm(), mono_ns());
 
     // LED watchdog: blank strip if no RPM frames recently
     uint32_t now = SDL_GetTicks();
@@ -365,19 +401,46 @@ int main(int argc, char *argv[]){
     uint32_t delta = now - last_tick; last_tick = now;
     if (delta > 30) delta = 30;
     lv_tick_inc(delta);
-    lv_task_handler();
+    uint64_t frame_t0 = mono_ns();
+    {
+      TRACE_SCOPE("lv_timer_handler");
+      lv_task_handler();
+    }
 
     if (g_need_present){
+      TRACE_SCOPE("present");
       SDL_RenderCopy(g_ren, g_tex, nullptr, nullptr);
       SDL_RenderPresent(g_ren);
+      latency_present();
+      metrics_frame(mono_ns() - frame_t0);
       g_need_present = false;
     }
+    metrics_dropped(DROP_SOCKET, can.dropped());
+    metrics_dropped(DROP_CANLOG, g_canlog.stats().dropped);
+    metrics_tick(mono_ns());
+    if (LATENCY_REPORT_S && now - last_report >= LATENCY_REPORT_S * 1000) {
+      latency_report(stdout, true);
+      last_report = now;
+    }
+    if (g_trace_dump) {
+      g_trace_dump = 0;
+      trace_dump();
+    }
     SDL_Delay(1);
   }
 
   // ---------- Shutdown ----------
+  if (LATENCY_REPORT_S) latency_report(stdout, false);
+  trace_dump();
+  metrics_stop();
+  dashcfg_unwatch();
+  if (g_led_thread.joinable()) {
+    g_led_run = false;
+    g_led_thread.join();
+  }
   leds_off();
   ws2811_fini(&g_leds);
+  g_canlog.close();
 
   SDL_DestroyTexture(g_tex); SDL_DestroyRenderer(g_ren);
   SDL_DestroyWindow(g_win); SDL_Quit();
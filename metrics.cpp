@@ -0,0 +1,468 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+extern "C" {
+  #include "lvgl.h"
+}
+
+static constexpr uint64_t WINDOW_NS  = 1000000000ull;
+static constexpr uint32_t ID_SLOTS   = 64;           // distinct ids counted, the rest go to "other"
+static constexpr uint32_t OTHER_ID   = 0xFFFFFFFFu;
+static constexpr int      REQUEST_MS = 100;          // wait for the client to say what it wants
+static constexpr int      SEND_TIMEOUT_S = 1;
+static constexpr char     BIN_MAGIC[8] = { 'D', 'A', 'S', 'H', 'M', 'E', 'T', '2' };
+static const char *const  DROP_NAMES[METRICS_DROPS] = { "socket", "canlog" };
+
+// BUCKETS buckets of width, then the overflow bucket.
+struct Histogram {
+  static constexpr uint32_t BUCKETS = 2000;
+  uint64_t width;
+  uint32_t bucket[BUCKETS + 1];
+  uint64_t count, max;
+
+  explicit Histogram(uint64_t w) : width(w) { clear(); }
+  void clear(){ std::memset(bucket, 0, sizeof(bucket)); count = max = 0; }
+  void add(uint64_t v){
+    uint64_t b = v / width;
+    ++bucket[b < BUCKETS ? b : BUCKETS];
+    ++count;
+    if (v > max) max = v;
+  }
+  // Upper edge of the bucket holding the p-th sample, at most the max.
+  uint64_t percentile(double p) const {
+    if (!count) return 0;
+    uint64_t want = uint64_t(p * double(count - 1)) + 1, seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; ++i) {
+      seen += bucket[i];
+      if (seen >= want) return std::min((i + 1) * width, max);
+    }
+    return max;
+  }
+};
+
+struct IdCount {
+  uint32_t id;
+  bool     used;
+  uint32_t window;
+  uint64_t total;
+};
+
+struct IdRate {
+  uint32_t id;
+  double   per_s;
+  uint64_t total;
+};
+
+// One closed window plus the running totals.
+struct Snapshot {
+  uint64_t t_ns = 0;
+  double   window_s = 0;
+  uint64_t frames_total = 0;
+  double   fps = 0, frame_sum_s = 0;
+  uint64_t frame_ns[4] = {};   // p50, p90, p99, max
+  uint64_t can_total = 0;
+  double   can_per_s = 0, decode_sum_s = 0;
+  uint64_t decode_ns[3] = {};  // p50, p99, max
+  uint64_t derived_total = 0, derived_frames = 0;
+  double   derived_per_frame = 0, derived_sum_s = 0;
+  uint64_t derived_ns[3] = {}; // p50, p99, max, per frame
+  uint64_t dropped[METRICS_DROPS] = {};
+  uint64_t led_total = 0;
+  double   led_per_s = 0;
+  uint32_t mem_total = 0, mem_used = 0, mem_max_used = 0, mem_frag_pct = 0;
+  std::vector<IdRate> ids;
+};
+
+// UI thread
+static Histogram g_frame_hist(50000);  // 50 us buckets up to 100 ms
+static Histogram g_decode_hist(50);    // 50 ns buckets up to 100 us
+static Histogram g_derived_hist(50);   // the same, per frame
+static IdCount   g_ids[ID_SLOTS + 1];  // open addressing; the last one is "other"
+static uint64_t  g_frames_total, g_frame_sum_ns, g_window_frames;
+static uint64_t  g_can_total, g_decode_sum_ns, g_window_can;
+static uint64_t  g_derived_total, g_derived_frames, g_derived_sum_ns, g_window_derived;
+static uint64_t  g_dropped[METRICS_DROPS];
+static uint64_t  g_window_start_ns, g_led_last;
+static lv_obj_t *g_overlay;
+
+static std::atomic<uint64_t> g_led_renders{0};
+
+// Read by the socket thread.
+static std::mutex g_snap_mutex;
+static Snapshot   g_snap;
+
+static std::thread g_server;
+static int         g_listen_fd = -1, g_wake_fd = -1;
+static std::string g_path;
+
+static IdCount &id_slot(uint32_t id){
+  uint32_t h = (id * 2654435761u) % ID_SLOTS;
+  for (uint32_t i = 0; i < ID_SLOTS; ++i) {
+    IdCount &c = g_ids[(h + i) % ID_SLOTS];
+    if (c.used && c.id == id) return c;
+    if (!c.used) {
+      c.used = true;
+      c.id = id;
+      return c;
+    }
+  }
+  g_ids[ID_SLOTS].id = OTHER_ID;
+  g_ids[ID_SLOTS].used = true;
+  return g_ids[ID_SLOTS];
+}
+
+void metrics_frame(uint64_t render_ns){
+  g_frame_hist.add(render_ns);
+  g_frame_sum_ns += render_ns;
+  ++g_frames_total;
+  ++g_window_frames;
+}
+
+void metrics_can(uint32_t id, uint64_t decode_ns){
+  IdCount &c = id_slot(id);
+  ++c.window;
+  ++c.total;
+  g_decode_hist.add(decode_ns);
+  g_decode_sum_ns += decode_ns;
+  ++g_can_total;
+  ++g_window_can;
+}
+
+void metrics_derived(uint32_t nodes, uint64_t ns){
+  g_derived_hist.add(ns);
+  g_derived_sum_ns += ns;
+  ++g_derived_frames;
+  g_derived_total += nodes;
+  g_window_derived += nodes;
+}
+
+void metrics_dropped(MetricsDrop where, uint64_t total){ g_dropped[where] = total; }
+
+void metrics_led_render(){ g_led_renders.fetch_add(1, std::memory_order_relaxed); }
+
+void metrics_tick(uint64_t now_ns){
+  if (!g_window_start_ns) {
+    g_window_start_ns = now_ns;
+    return;
+  }
+  if (now_ns - g_window_start_ns < WINDOW_NS) return;
+
+  Snapshot s;
+  double secs = double(now_ns - g_window_start_ns) / 1e9;
+  s.t_ns = now_ns;
+  s.window_s = secs;
+  s.frames_total = g_frames_total;
+  s.fps = g_window_frames / secs;
+  s.frame_sum_s = g_frame_sum_ns / 1e9;
+  s.frame_ns[0] = g_frame_hist.percentile(0.5);
+  s.frame_ns[1] = g_frame_hist.percentile(0.9);
+  s.frame_ns[2] = g_frame_hist.percentile(0.99);
+  s.frame_ns[3] = g_frame_hist.max;
+  s.can_total = g_can_total;
+  s.can_per_s = g_window_can / secs;
+  s.decode_sum_s = g_decode_sum_ns / 1e9;
+  s.decode_ns[0] = g_decode_hist.percentile(0.5);
+  s.decode_ns[1] = g_decode_hist.percentile(0.99);
+  s.decode_ns[2] = g_decode_hist.max;
+  s.derived_total = g_derived_total;
+  s.derived_frames = g_derived_frames;
+  s.derived_sum_s = g_derived_sum_ns / 1e9;
+  s.derived_per_frame = g_derived_hist.count ? double(g_window_derived) / double(g_derived_hist.count) : 0;
+  s.derived_ns[0] = g_derived_hist.percentile(0.5);
+  s.derived_ns[1] = g_derived_hist.percentile(0.99);
+  s.derived_ns[2] = g_derived_hist.max;
+  std::copy(g_dropped, g_dropped + METRICS_DROPS, s.dropped);
+  s.led_total = g_led_renders.load(std::memory_order_relaxed);
+  s.led_per_s = (s.led_total - g_led_last) / secs;
+  for (IdCount &c : g_ids) {
+    if (!c.used) continue;
+    s.ids.push_back(IdRate{ c.id, c.window / secs, c.total });
+    c.window = 0;
+  }
+  std::sort(s.ids.begin(), s.ids.end(), [](const IdRate &a, const IdRate &b){ return a.id < b.id; });
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  s.mem_total = mon.total_size;
+  s.mem_used = mon.total_size - mon.free_size;
+  s.mem_max_used = mon.max_used;
+  s.mem_frag_pct = mon.frag_pct;
+
+  g_frame_hist.clear();
+  g_decode_hist.clear();
+  g_derived_hist.clear();
+  g_window_frames = g_window_can = g_window_derived = 0;
+  g_led_last = s.led_total;
+  g_window_start_ns = now_ns;
+  {
+    std::lock_guard<std::mutex> lock(g_snap_mutex);
+    g_snap = std::move(s);
+  }
+
+  if (metrics_overlay_visible()) lv_label_set_text(g_overlay, metrics_text().c_str());
+}
+
+// ---------- overlay ----------
+
+void metrics_overlay(int on){
+  bool show = on < 0 ? !metrics_overlay_visible() : on > 0;
+  if (show && !g_overlay) {
+    g_overlay = lv_label_create(lv_layer_sys());
+    lv_obj_set_style_bg_opa(g_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_bg_color(g_overlay, lv_color_black(), 0);
+    lv_obj_set_style_text_color(g_overlay, lv_color_white(), 0);
+    lv_obj_set_style_text_font(g_overlay, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_pad_all(g_overlay, 4, 0);
+    lv_obj_align(g_overlay, LV_ALIGN_TOP_LEFT, 4, 4);
+  }
+  if (!g_overlay) return;
+  if (show) {
+    lv_label_set_text(g_overlay, metrics_text().c_str());
+    lv_obj_clear_flag(g_overlay, LV_OBJ_FLAG_HIDDEN);
+  } else {
+    lv_obj_add_flag(g_overlay, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+bool metrics_overlay_visible(){ return g_overlay && !lv_obj_has_flag(g_overlay, LV_OBJ_FLAG_HIDDEN); }
+
+// ---------- formats ----------
+
+static Snapshot snapshot(){
+  std::lock_guard<std::mutex> lock(g_snap_mutex);
+  return g_snap;
+}
+
+static void appendf(std::string &out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void appendf(std::string &out, const char *fmt, ...){
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = std::vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n > 0) out.append(buf, std::min<size_t>(size_t(n), sizeof(buf) - 1));
+}
+
+static std::string id_label(uint32_t id){
+  if (id == OTHER_ID) return "other";
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "0x%X", id);
+  return buf;
+}
+
+std::string metrics_text(){
+  Snapshot s = snapshot();
+  std::string out;
+  appendf(out, "frame  %.1f / %.1f / %.1f ms  p50/p99/max  %.1f fps\n", s.frame_ns[0] / 1e6, s.frame_ns[2] / 1e6,
+          s.frame_ns[3] / 1e6, s.fps);
+  appendf(out, "can  %.0f/s  decode %.2f / %.2f us  p50/p99\n", s.can_per_s, s.decode_ns[0] / 1e3,
+          s.decode_ns[1] / 1e3);
+  for (const IdRate &r : s.ids) appendf(out, "  %-8s %6.0f/s\n", id_label(r.id).c_str(), r.per_s);
+  appendf(out, "derived  %.1f/frame  %.2f / %.2f us  p50/p99\n", s.derived_per_frame, s.derived_ns[0] / 1e3,
+          s.derived_ns[1] / 1e3);
+  appendf(out, "dropped  socket %llu  canlog %llu\n", (unsigned long long)s.dropped[DROP_SOCKET],
+          (unsigned long long)s.dropped[DROP_CANLOG]);
+  appendf(out, "leds  %.0f renders/s\n", s.led_per_s);
+  appendf(out, "lv_mem  %u / %u kB  peak %u kB  frag %u%%", s.mem_used / 1024, s.mem_total / 1024,
+          s.mem_max_used / 1024, s.mem_frag_pct);
+  return out;
+}
+
+std::string metrics_prometheus(){
+  Snapshot s = snapshot();
+  std::string out;
+  out += "# HELP dash_frame_seconds lv_timer_handler() to SDL_RenderPresent() of the frames of the last second.\n"
+         "# TYPE dash_frame_seconds summary\n";
+  static const char *const FRAME_Q[3] = { "0.5", "0.9", "0.99" };
+  for (int i = 0; i < 3; ++i)
+    appendf(out, "dash_frame_seconds{quantile=\"%s\"} %.6f\n", FRAME_Q[i], s.frame_ns[i] / 1e9);
+  appendf(out, "dash_frame_seconds_sum %.6f\ndash_frame_seconds_count %llu\n", s.frame_sum_s,
+          (unsigned long long)s.frames_total);
+  appendf(out, "# TYPE dash_frame_max_seconds gauge\ndash_frame_max_seconds %.6f\n", s.frame_ns[3] / 1e9);
+  appendf(out, "# TYPE dash_frames_per_second gauge\ndash_frames_per_second %.2f\n", s.fps);
+
+  out += "# HELP dash_can_frames_total CAN frames handled, by id.\n# TYPE dash_can_frames_total counter\n";
+  for (const IdRate &r : s.ids)
+    appendf(out, "dash_can_frames_total{id=\"%s\"} %llu\n", id_label(r.id).c_str(), (unsigned long long)r.total);
+  out += "# TYPE dash_can_frames_per_second gauge\n";
+  for (const IdRate &r : s.ids)
+    appendf(out, "dash_can_frames_per_second{id=\"%s\"} %.2f\n", id_label(r.id).c_str(), r.per_s);
+  out += "# HELP dash_can_decode_seconds Time in the CAN handlers per frame.\n# TYPE dash_can_decode_seconds summary\n";
+  appendf(out, "dash_can_decode_seconds{quantile=\"0.5\"} %.9f\n", s.decode_ns[0] / 1e9);
+  appendf(out, "dash_can_decode_seconds{quantile=\"0.99\"} %.9f\n", s.decode_ns[1] / 1e9);
+  appendf(out, "dash_can_decode_seconds_sum %.6f\ndash_can_decode_seconds_count %llu\n", s.decode_sum_s,
+          (unsigned long long)s.can_total);
+  appendf(out, "# TYPE dash_can_decode_max_seconds gauge\ndash_can_decode_max_seconds %.9f\n", s.decode_ns[2] / 1e9);
+  out += "# HELP dash_derived_total Derived channels computed.\n# TYPE dash_derived_total counter\n";
+  appendf(out, "dash_derived_total %llu\n", (unsigned long long)s.derived_total);
+  out += "# HELP dash_derived_seconds Time computing derived channels per frame.\n# TYPE dash_derived_seconds summary\n";
+  appendf(out, "dash_derived_seconds{quantile=\"0.5\"} %.9f\n", s.derived_ns[0] / 1e9);
+  appendf(out, "dash_derived_seconds{quantile=\"0.99\"} %.9f\n", s.derived_ns[1] / 1e9);
+  appendf(out, "dash_derived_seconds_sum %.6f\ndash_derived_seconds_count %llu\n", s.derived_sum_s,
+          (unsigned long long)s.derived_frames);
+  appendf(out, "# TYPE dash_derived_max_seconds gauge\ndash_derived_max_seconds %.9f\n", s.derived_ns[2] / 1e9);
+  out += "# HELP dash_can_dropped_total CAN frames lost by the socket or the logger.\n"
+         "# TYPE dash_can_dropped_total counter\n";
+  for (int i = 0; i < METRICS_DROPS; ++i)
+    appendf(out, "dash_can_dropped_total{where=\"%s\"} %llu\n", DROP_NAMES[i], (unsigned long long)s.dropped[i]);
+
+  appendf(out, "# TYPE dash_led_renders_total counter\ndash_led_renders_total %llu\n",
+          (unsigned long long)s.led_total);
+  appendf(out, "# TYPE dash_led_renders_per_second gauge\ndash_led_renders_per_second %.2f\n", s.led_per_s);
+
+  out += "# TYPE dash_lv_mem_bytes gauge\n";
+  appendf(out, "dash_lv_mem_bytes{kind=\"total\"} %u\n", s.mem_total);
+  appendf(out, "dash_lv_mem_bytes{kind=\"used\"} %u\n", s.mem_used);
+  appendf(out, "dash_lv_mem_bytes{kind=\"max_used\"} %u\n", s.mem_max_used);
+  appendf(out, "# TYPE dash_lv_mem_frag_ratio gauge\ndash_lv_mem_frag_ratio %.2f\n", s.mem_frag_pct / 100.0);
+  return out;
+}
+
+template <typename T> static void put(std::vector<uint8_t> &out, T v){
+  uint8_t b[sizeof(T)];
+  std::memcpy(b, &v, sizeof(T));
+  out.insert(out.end(), b, b + sizeof(T));
+}
+
+static uint32_t milli(double v){ return uint32_t(std::min(v * 1000.0 + 0.5, 4294967295.0)); }
+static uint32_t u32(uint64_t v){ return uint32_t(std::min<uint64_t>(v, 0xFFFFFFFFu)); }
+
+std::vector<uint8_t> metrics_binary(){
+  Snapshot s = snapshot();
+  std::vector<uint8_t> out(BIN_MAGIC, BIN_MAGIC + 8);
+  put<uint32_t>(out, 0);  // size, set below
+  put<uint32_t>(out, uint32_t(s.ids.size()));
+  put<uint64_t>(out, s.t_ns);
+  put<uint32_t>(out, u32(uint64_t(s.window_s * 1e6)));
+  put<uint64_t>(out, s.frames_total);
+  put<uint32_t>(out, milli(s.fps));
+  for (uint64_t ns : s.frame_ns) put<uint32_t>(out, u32(ns / 1000));
+  put<uint64_t>(out, s.can_total);
+  put<uint32_t>(out, milli(s.can_per_s));
+  for (uint64_t ns : s.decode_ns) put<uint32_t>(out, u32(ns));
+  put<uint64_t>(out, s.derived_total);
+  for (uint64_t ns : s.derived_ns) put<uint32_t>(out, u32(ns));
+  for (uint64_t d : s.dropped) put<uint64_t>(out, d);
+  put<uint64_t>(out, s.led_total);
+  put<uint32_t>(out, milli(s.led_per_s));
+  put<uint32_t>(out, s.mem_total);
+  put<uint32_t>(out, s.mem_used);
+  put<uint32_t>(out, s.mem_max_used);
+  put<uint32_t>(out, s.mem_frag_pct);
+  for (const IdRate &r : s.ids) {
+    put<uint32_t>(out, r.id);
+    put<uint32_t>(out, milli(r.per_s));
+    put<uint64_t>(out, r.total);
+  }
+  uint32_t size = uint32_t(out.size());
+  std::memcpy(&out[8], &size, 4);
+  return out;
+}
+
+// ---------- socket ----------
+
+static void send_all(int fd, const void *p, size_t n){
+  const char *c = static_cast<const char *>(p);
+  while (n) {
+    ssize_t w = send(fd, c, n, MSG_NOSIGNAL);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return;
+    c += w;
+    n -= size_t(w);
+  }
+}
+
+static void serve_client(int fd){
+  char req[256] = {};
+  pollfd p{ fd, POLLIN, 0 };
+  if (poll(&p, 1, REQUEST_MS) > 0) recv(fd, req, sizeof(req) - 1, 0);
+  timeval tv{ SEND_TIMEOUT_S, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+  if (std::strncmp(req, "bin", 3) == 0) {
+    std::vector<uint8_t> b = metrics_binary();
+    send_all(fd, b.data(), b.size());
+    return;
+  }
+  std::string body = metrics_prometheus();
+  if (std::strncmp(req, "GET ", 4) == 0) {
+    char hdr[128];
+    int n = std::snprintf(hdr, sizeof(hdr),
+                          "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+                          body.size());
+    send_all(fd, hdr, size_t(n));
+  }
+  send_all(fd, body.data(), body.size());
+}
+
+static void server_main(){
+  for (;;) {
+    pollfd p[2] = { { g_listen_fd, POLLIN, 0 }, { g_wake_fd, POLLIN, 0 } };
+    if (poll(p, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    if (p[1].revents) return;
+    if (!(p[0].revents & POLLIN)) continue;
+    int c = accept4(g_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (c < 0) continue;
+    serve_client(c);
+    close(c);
+  }
+}
+
+bool metrics_serve(const char *path){
+  if (g_server.joinable()) return false;
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (std::strlen(path) >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  std::strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  unlink(path);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+    int e = errno;
+    close(fd);
+    errno = e;
+    return false;
+  }
+  g_wake_fd = eventfd(0, EFD_CLOEXEC);
+  if (g_wake_fd < 0) {
+    int e = errno;
+    close(fd);
+    unlink(path);
+    errno = e;
+    return false;
+  }
+  g_listen_fd = fd;
+  g_path = path;
+  g_server = std::thread(server_main);
+  return true;
+}
+
+void metrics_stop(){
+  if (!g_server.joinable()) return;
+  uint64_t one = 1;
+  if (write(g_wake_fd, &one, sizeof(one)) < 0) std::perror("metrics");
+  g_server.join();
+  close(g_listen_fd);
+  close(g_wake_fd);
+  g_listen_fd = g_wake_fd = -1;
+  unlink(g_path.c_str());
+}
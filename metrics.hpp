@@ -0,0 +1,67 @@
+#pragma once
+// Runtime metrics of the dash:
+// - frame times and frames per second;
+// - CAN frames per second per id and the decode time;
+// - the derived channels computed per frame and the time it took;
+// - frames dropped by the socket and by the CAN logger;
+// - LED renders per second;
+// - lv_mem usage.
+// The loop feeds them, and metrics_tick() closes a window about once a second.
+// Percentiles and rates cover the last window; the _total counters run from
+// the start. The last window is shown two ways:
+//   overlay  a label on lv_layer_sys(), see metrics_overlay()
+//   socket   metrics_serve(path): a thread answering on a Unix socket
+// On the socket, a client that sends "bin" gets the binary form below. One
+// that sends an HTTP GET gets Prometheus text in an HTTP/1.0 reply. Anything
+// else, or nothing within 100 ms, gets the bare Prometheus text:
+//   socat - UNIX-CONNECT:/tmp/dash-metrics.sock
+//   curl --unix-socket /tmp/dash-metrics.sock http://dash/metrics
+//
+// Binary, little endian:
+//   "DASHMET2", u32 bytes in total, u32 ids
+//   u64 t_ns (CLOCK_MONOTONIC at the end of the window), u32 window_us
+//   u64 frames_total, u32 fps_milli
+//   u32 frame_us p50, p90, p99, max
+//   u64 can_total, u32 can_per_s_milli
+//   u32 decode_ns p50, p99, max
+//   u64 derived_total, u32 derived_ns p50, p99, max
+//   u64 dropped_total[METRICS_DROPS]
+//   u64 led_renders_total, u32 led_per_s_milli
+//   u32 lv_mem total, used, max_used (bytes), frag_pct
+//   ids x { u32 id, u32 per_s_milli, u64 total }
+// Everything is called from the UI thread, except metrics_led_render() which
+// any thread may call.
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum MetricsDrop { DROP_SOCKET, DROP_CANLOG, METRICS_DROPS };
+
+// A frame presented: lv_timer_handler() to SDL_RenderPresent() returning.
+void metrics_frame(uint64_t render_ns);
+// A CAN frame read and handled in decode_ns.
+void metrics_can(uint32_t id, uint64_t decode_ns);
+// dashui_update_derived() computed nodes channels in ns, once per frame.
+void metrics_derived(uint32_t nodes, uint64_t ns);
+// Running total of frames lost at `where`.
+void metrics_dropped(MetricsDrop where, uint64_t total);
+// The LED strip was rendered. From any thread.
+void metrics_led_render();
+
+// Closes the window once a second has passed, reads lv_mem, and publishes
+// the result to the overlay and the socket.
+void metrics_tick(uint64_t now_ns);
+
+// 1 shows the overlay, 0 hides it, -1 toggles it.
+void metrics_overlay(int on);
+bool metrics_overlay_visible();
+
+// Starts the socket thread on path (replacing a stale socket). False if it
+// can't listen.
+bool metrics_serve(const char *path);
+void metrics_stop();
+
+// The last window in the three forms.
+std::string metrics_text();        // the overlay's lines
+std::string metrics_prometheus();
+std::vector<uint8_t> metrics_binary();
@@ -0,0 +1,313 @@
+/**
+ * @file rpmbar.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "rpmbar.h"
+#include "ui.h"
+#include "config.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &rpmbar_class
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rpmbar_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void rpmbar_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void draw_main(lv_event_t * e);
+static void draw_span(lv_draw_ctx_t * draw_ctx, lv_draw_rect_dsc_t * dsc, lv_coord_t x1, lv_coord_t y1,
+                      lv_coord_t x2, lv_coord_t y2, lv_color_t color);
+static lv_coord_t value_to_x(const lv_obj_t * obj, int32_t value);
+static void get_fill_rows(const lv_obj_t * obj, lv_coord_t * y1, lv_coord_t * y2);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t rpmbar_class = {
+    .base_class = &lv_obj_class,
+    .constructor_cb = rpmbar_constructor,
+    .event_cb = rpmbar_event,
+    .width_def = LV_PCT(100),
+    .height_def = LV_DPI_DEF / 2,
+    .instance_size = sizeof(rpmbar_t),
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * rpmbar_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+lv_obj_t * rpmbar_replace_ui_composite(void)
+{
+    /*Take the geometry and colors from the SquareLine design so that changing it there still works*/
+    lv_obj_update_layout(ui_Screen1);
+
+    lv_area_t coords = ui_rpmbackblue->coords;
+    _lv_area_join(&coords, &coords, &ui_rpmbackgreen->coords);
+    _lv_area_join(&coords, &coords, &ui_rpmbackred->coords);
+
+    lv_obj_t * obj = rpmbar_create(ui_Screen1);
+    lv_obj_set_pos(obj, coords.x1 - ui_Screen1->coords.x1, coords.y1 - ui_Screen1->coords.y1);
+    lv_obj_set_size(obj, lv_area_get_width(&coords), lv_area_get_height(&coords));
+    lv_obj_set_style_pad_top(obj, LV_MAX(ui_erpmbar->coords.y1 - coords.y1, 0), 0);
+    lv_obj_set_style_pad_bottom(obj, LV_MAX(coords.y2 - ui_erpmbar->coords.y2, 0), 0);
+
+    rpmbar_set_range(obj, lv_bar_get_min_value(ui_erpmbar), lv_bar_get_max_value(ui_erpmbar));
+    rpmbar_set_shift_points(obj, RPM_MIN, RPM_MAX);
+    rpmbar_set_value(obj, lv_bar_get_value(ui_erpmbar));
+    rpmbar_set_zone_color(obj, RPMBAR_ZONE_LOW, lv_obj_get_style_bg_color(ui_rpmbackblue, LV_PART_MAIN));
+    rpmbar_set_zone_color(obj, RPMBAR_ZONE_MID, lv_obj_get_style_bg_color(ui_rpmbackgreen, LV_PART_MAIN));
+    rpmbar_set_zone_color(obj, RPMBAR_ZONE_HIGH, lv_obj_get_style_bg_color(ui_rpmbackred, LV_PART_MAIN));
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    bar->fill_opa = lv_obj_get_style_bg_opa(ui_rpmfrontgreen, LV_PART_MAIN);
+
+    /*The composite was at the bottom, below the labels*/
+    lv_obj_move_to_index(obj, lv_obj_get_index(ui_rpmbackgreen));
+
+    lv_obj_t ** replaced[] = {
+        &ui_rpmbackgreen, &ui_rpmbackblue, &ui_rpmbackred,
+        &ui_erpmbackswitchup, &ui_erpmbackswitchdown, &ui_erpmbar,
+        &ui_rpmfrontgreen, &ui_rpmfrontblue, &ui_rpmfrontred,
+    };
+    uint32_t i;
+    for(i = 0; i < sizeof(replaced) / sizeof(replaced[0]); i++) {
+        lv_obj_del(*replaced[i]);
+        *replaced[i] = NULL;
+    }
+
+    return obj;
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+void rpmbar_set_value(lv_obj_t * obj, int32_t value)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    value = LV_CLAMP(bar->min_value, value, bar->max_value);
+    if(bar->value == value) return;
+
+    lv_coord_t x_old = value_to_x(obj, bar->value);
+    bar->value = value;
+    lv_coord_t x_new = value_to_x(obj, value);
+    if(x_old == x_new) return;
+
+    /*Only the columns between the old and the new end of the fill change*/
+    lv_area_t a;
+    a.x1 = LV_MIN(x_old, x_new);
+    a.x2 = LV_MAX(x_old, x_new) - 1;
+    get_fill_rows(obj, &a.y1, &a.y2);
+    lv_obj_invalidate_area(obj, &a);
+}
+
+void rpmbar_set_range(lv_obj_t * obj, int32_t min, int32_t max)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    if(max <= min) max = min + 1;
+    if(bar->min_value == min && bar->max_value == max) return;
+
+    bar->min_value = min;
+    bar->max_value = max;
+    bar->value = LV_CLAMP(min, bar->value, max);
+    lv_obj_invalidate(obj);
+}
+
+void rpmbar_set_shift_points(lv_obj_t * obj, int32_t down, int32_t up)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    if(up < down) up = down;
+    if(bar->shift_down == down && bar->shift_up == up) return;
+
+    bar->shift_down = down;
+    bar->shift_up = up;
+    lv_obj_invalidate(obj);
+}
+
+void rpmbar_set_zone_color(lv_obj_t * obj, rpmbar_zone_t zone, lv_color_t color)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    if(zone >= _RPMBAR_ZONE_NUM || bar->colors[zone].full == color.full) return;
+
+    bar->colors[zone] = color;
+    lv_obj_invalidate(obj);
+}
+
+void rpmbar_set_shift(lv_obj_t * obj, rpmbar_shift_t shift)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    if(bar->shift == shift) return;
+
+    bar->shift = shift;
+    lv_obj_invalidate(obj);
+}
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+int32_t rpmbar_get_value(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    return ((rpmbar_t *)obj)->value;
+}
+
+rpmbar_shift_t rpmbar_get_shift(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    return (rpmbar_shift_t)((rpmbar_t *)obj)->shift;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void rpmbar_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+    LV_TRACE_OBJ_CREATE("begin");
+
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    bar->min_value = 0;
+    bar->max_value = 100;
+    bar->value = 0;
+    bar->shift_down = 15;
+    bar->shift_up = 85;
+    bar->colors[RPMBAR_ZONE_LOW] = lv_color_hex(0x1100F6);
+    bar->colors[RPMBAR_ZONE_MID] = lv_color_hex(0x00FF36);
+    bar->colors[RPMBAR_ZONE_HIGH] = lv_color_hex(0xF60000);
+    bar->fill_opa = 100;
+    bar->shift = RPMBAR_SHIFT_NONE;
+
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICK_FOCUSABLE);
+
+    LV_TRACE_OBJ_CREATE("finished");
+}
+
+static void rpmbar_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    LV_UNUSED(class_p);
+
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t * obj = lv_event_get_target(e);
+
+    /*Every pixel is drawn here with plain fills, so the base class' background is not needed*/
+    if(code == LV_EVENT_COVER_CHECK) {
+        lv_cover_check_info_t * info = lv_event_get_param(e);
+        if(info->res == LV_COVER_RES_MASKED) return;
+        if(!_lv_area_is_in(info->area, &obj->coords, 0) || lv_obj_get_style_opa(obj, LV_PART_MAIN) < LV_OPA_MAX) {
+            info->res = LV_COVER_RES_NOT_COVER;
+        }
+        return;
+    }
+    else if(code == LV_EVENT_DRAW_MAIN) {
+        draw_main(e);
+        return;
+    }
+
+    lv_obj_event_base(MY_CLASS, e);
+}
+
+static void draw_main(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    rpmbar_t * bar = (rpmbar_t *)obj;
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    lv_coord_t fill_y1;
+    lv_coord_t fill_y2;
+    get_fill_rows(obj, &fill_y1, &fill_y2);
+    lv_coord_t fill_x = value_to_x(obj, bar->value);
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+
+    /*Every zone in one pass without overlaps: bright above the value, dim (the fill) up to it
+     *on the fill rows, and fully dim if it's the darkened shift zone*/
+    lv_coord_t zone_x1 = obj->coords.x1;
+    uint32_t z;
+    for(z = 0; z < _RPMBAR_ZONE_NUM; z++) {
+        lv_coord_t zone_x2;
+        if(z == RPMBAR_ZONE_LOW) zone_x2 = value_to_x(obj, bar->shift_down) - 1;
+        else if(z == RPMBAR_ZONE_MID) zone_x2 = value_to_x(obj, bar->shift_up) - 1;
+        else zone_x2 = obj->coords.x2;
+
+        lv_color_t bright = bar->colors[z];
+        lv_color_t dim = lv_color_mix(bright, lv_color_black(), bar->fill_opa);
+        bool dark = (z == RPMBAR_ZONE_LOW && bar->shift == RPMBAR_SHIFT_DOWN) ||
+                    (z == RPMBAR_ZONE_HIGH && bar->shift == RPMBAR_SHIFT_UP);
+
+        if(dark) {
+            draw_span(draw_ctx, &dsc, zone_x1, obj->coords.y1, zone_x2, obj->coords.y2, dim);
+        }
+        else {
+            lv_coord_t filled_x2 = LV_MIN(zone_x2, fill_x - 1);
+            if(filled_x2 >= zone_x1) {
+                draw_span(draw_ctx, &dsc, zone_x1, obj->coords.y1, filled_x2, fill_y1 - 1, bright);
+                draw_span(draw_ctx, &dsc, zone_x1, fill_y1, filled_x2, fill_y2, dim);
+                draw_span(draw_ctx, &dsc, zone_x1, fill_y2 + 1, filled_x2, obj->coords.y2, bright);
+            }
+            draw_span(draw_ctx, &dsc, LV_MAX(zone_x1, fill_x), obj->coords.y1, zone_x2, obj->coords.y2, bright);
+        }
+
+        zone_x1 = LV_MAX(zone_x1, zone_x2 + 1);
+    }
+}
+
+static void draw_span(lv_draw_ctx_t * draw_ctx, lv_draw_rect_dsc_t * dsc, lv_coord_t x1, lv_coord_t y1,
+                      lv_coord_t x2, lv_coord_t y2, lv_color_t color)
+{
+    if(x1 > x2 || y1 > y2) return;
+
+    lv_area_t a;
+    lv_area_set(&a, x1, y1, x2, y2);
+    dsc->bg_color = color;
+    lv_draw_rect(draw_ctx, dsc, &a);
+}
+
+/**
+ * Get the first column which is not filled at a value
+ * @param obj       pointer to an rpm bar
+ * @param value     a value, clamped to the range
+ * @return          absolute x coordinate, `coords.x2 + 1` at the max. value
+ */
+static lv_coord_t value_to_x(const lv_obj_t * obj, int32_t value)
+{
+    const rpmbar_t * bar = (const rpmbar_t *)obj;
+    value = LV_CLAMP(bar->min_value, value, bar->max_value);
+    int64_t w = lv_area_get_width(&obj->coords);
+    return obj->coords.x1 + (lv_coord_t)(((int64_t)(value - bar->min_value) * w) /
+                                         (bar->max_value - bar->min_value));
+}
+
+static void get_fill_rows(const lv_obj_t * obj, lv_coord_t * y1, lv_coord_t * y2)
+{
+    *y1 = obj->coords.y1 + lv_obj_get_style_pad_top(obj, LV_PART_MAIN);
+    *y2 = obj->coords.y2 - lv_obj_get_style_pad_bottom(obj, LV_PART_MAIN);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file rpmbar.h
+ * The rpm bar of the dash as one LVGL widget: three colored zones split at
+ * the shift points, the part up to the current rpm drawn darker, and a shift
+ * zone that can be blacked out while the driver should shift.
+ * It replaces the stacked SquareLine buttons + lv_bar of ui_Screen1.
+ */
+
+#ifndef RPMBAR_H
+#define RPMBAR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    RPMBAR_SHIFT_NONE,
+    RPMBAR_SHIFT_UP,    /**< Darken the zone above the up shift point*/
+    RPMBAR_SHIFT_DOWN,  /**< Darken the zone below the down shift point*/
+} rpmbar_shift_t;
+
+typedef enum {
+    RPMBAR_ZONE_LOW,
+    RPMBAR_ZONE_MID,
+    RPMBAR_ZONE_HIGH,
+    _RPMBAR_ZONE_NUM,
+} rpmbar_zone_t;
+
+/*Data of rpm bar*/
+typedef struct {
+    lv_obj_t obj;
+    int32_t min_value;
+    int32_t max_value;
+    int32_t value;
+    int32_t shift_down;                     /**< Start of the middle zone*/
+    int32_t shift_up;                       /**< Start of the high zone*/
+    lv_color_t colors[_RPMBAR_ZONE_NUM];
+    lv_opa_t fill_opa;                      /**< Brightness of the zone colors up to the value*/
+    uint8_t shift;                          /**< rpmbar_shift_t*/
+} rpmbar_t;
+
+extern const lv_obj_class_t rpmbar_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create an rpm bar.
+ * The fill is drawn between the top and bottom padding, the zones on the whole height.
+ * @param parent    pointer to an object, it will be the parent of the new bar
+ * @return          pointer to the created bar
+ */
+lv_obj_t * rpmbar_create(lv_obj_t * parent);
+
+/**
+ * Replace the rpm composite of ui_Screen1 (back/front buttons, shift overlays and erpmbar)
+ * with an rpm bar at the same place. The replaced `ui_` objects are deleted and set to NULL.
+ * @return          the new rpm bar
+ */
+lv_obj_t * rpmbar_replace_ui_composite(void);
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * Set the current value. Only the columns between the old and the new value are redrawn.
+ * @param obj       pointer to an rpm bar
+ * @param value     the new value, clamped to the range
+ */
+void rpmbar_set_value(lv_obj_t * obj, int32_t value);
+
+/**
+ * Set the range of the bar
+ * @param obj       pointer to an rpm bar
+ * @param min       value at the left edge
+ * @param max       value at the right edge
+ */
+void rpmbar_set_range(lv_obj_t * obj, int32_t min, int32_t max);
+
+/**
+ * Set where the zones change
+ * @param obj       pointer to an rpm bar
+ * @param down      the low zone is below this value
+ * @param up        the high zone starts at this value
+ */
+void rpmbar_set_shift_points(lv_obj_t * obj, int32_t down, int32_t up);
+
+/**
+ * Set the color of a zone
+ * @param obj       pointer to an rpm bar
+ * @param zone      the zone to change
+ * @param color     its color
+ */
+void rpmbar_set_zone_color(lv_obj_t * obj, rpmbar_zone_t zone, lv_color_t color);
+
+/**
+ * Darken a shift zone, or none
+ * @param obj       pointer to an rpm bar
+ * @param shift     RPMBAR_SHIFT_NONE/UP/DOWN
+ */
+void rpmbar_set_shift(lv_obj_t * obj, rpmbar_shift_t shift);
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+/**
+ * Get the current value
+ * @param obj       pointer to an rpm bar
+ * @return          the value
+ */
+int32_t rpmbar_get_value(const lv_obj_t * obj);
+
+/**
+ * Get the darkened shift zone
+ * @param obj       pointer to an rpm bar
+ * @return          RPMBAR_SHIFT_NONE/UP/DOWN
+ */
+rpmbar_shift_t rpmbar_get_shift(const lv_obj_t * obj);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*RPMBAR_H*/
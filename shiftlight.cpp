@@ -0,0 +1,43 @@
+#include "shiftlight.hpp"
+#include <ctime>
+
+static constexpr uint64_t NS_PER_MS = 1000000ull;
+
+// UP keeps the old 20 ms on / 20 ms off cadence; DOWN is slow enough to tell apart.
+static constexpr FlashPattern PATTERNS[] = {
+  /* NONE */ { 0,   0   },
+  /* UP   */ { 40,  20  },
+  /* DOWN */ { 250, 125 },
+};
+
+uint64_t mono_ns(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+const FlashPattern &flash_pattern(ShiftFlash f){
+  return PATTERNS[static_cast<uint8_t>(f)];
+}
+
+bool shift_flash_lit(ShiftFlash f, uint64_t now_ns){
+  return flash_lit(flash_pattern(f), now_ns);
+}
+
+uint64_t shift_flash_next_edge(ShiftFlash f, uint64_t now_ns){
+  return flash_next_edge(flash_pattern(f), now_ns);
+}
+
+bool flash_lit(const FlashPattern &p, uint64_t now_ns){
+  if (p.period_ms == 0) return true;
+  uint64_t phase = now_ns % (p.period_ms * NS_PER_MS);
+  return phase < p.on_ms * NS_PER_MS;
+}
+
+uint64_t flash_next_edge(const FlashPattern &p, uint64_t now_ns){
+  if (p.period_ms == 0) return UINT64_MAX;
+  const uint64_t period = p.period_ms * NS_PER_MS;
+  const uint64_t on     = p.on_ms * NS_PER_MS;
+  uint64_t start = now_ns - now_ns % period;       // start of current cycle
+  return (now_ns - start < on) ? start + on : start + period;
+}
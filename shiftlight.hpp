@@ -0,0 +1,34 @@
+#pragma once
+// Shift-light flash patterns.
+// The flash phase is a pure function of CLOCK_MONOTONIC, so the cadence does
+// not depend on how often (or from which thread) the LEDs are refreshed: a late
+// refresh only delays an edge, it never shifts the ones after it.
+#include <cstdint>
+
+// Monotonic time in ns (CLOCK_MONOTONIC), safe to call from any thread.
+uint64_t mono_ns();
+
+// Which one applies is up to the shift-point engine (shiftpoint.hpp).
+enum class ShiftFlash : uint8_t {
+  NONE,   // steady bar
+  UP,     // at the gear's shift-up point   : fast flash, shift up
+  DOWN,   // below its shift-down point     : slow flash, shift down
+};
+
+struct FlashPattern {
+  uint32_t period_ms;  // full on+off cycle
+  uint32_t on_ms;      // lit part of the cycle, starting at phase 0
+};
+
+// Pattern table, indexed by ShiftFlash.
+const FlashPattern &flash_pattern(ShiftFlash f);
+
+// True if the pattern is in its lit phase at now_ns. Always true for NONE.
+bool shift_flash_lit(ShiftFlash f, uint64_t now_ns);
+
+// Absolute time (ns) of the next on/off edge after now_ns, or UINT64_MAX for NONE.
+uint64_t shift_flash_next_edge(ShiftFlash f, uint64_t now_ns);
+
+// The same for any pattern (e.g. the alarm blink of main.cpp); period 0 is steady.
+bool flash_lit(const FlashPattern &p, uint64_t now_ns);
+uint64_t flash_next_edge(const FlashPattern &p, uint64_t now_ns);
@@ -0,0 +1,106 @@
+#include "shiftpoint.hpp"
+#include <atomic>
+#include "dashconfig.hpp"
+
+static constexpr int32_t  SHIFT_HYSTERESIS_RPM = 150;
+static constexpr int32_t  RATE_MAX = 30000;              // rpm/s, past it is noise or a missed frame
+static constexpr uint64_t RATE_MAX_GAP_NS = 250000000;   // a longer gap restarts the rate
+// The rate is taken over at least this long, not frame to frame: 20 rpm of
+// noise 10 ms apart would read as 2000 rpm/s and move the prediction by
+// more than the hysteresis.
+static constexpr uint64_t RATE_WINDOW_NS = 50000000;
+// A shift or the clutch drops the rpm faster than any pull: no lead until the
+// rpm of the new gear has settled, or every upshift would ask for a downshift.
+static constexpr uint64_t GEAR_SETTLE_NS = 300000000;
+
+static const DashConfig *g_cfg = nullptr;
+static int32_t  g_rpm = 0;
+static int32_t  g_gear = -1;
+static int32_t  g_rate = 0;         // rpm/s, smoothed
+static uint64_t g_rpm_ns = 0;       // of g_rpm
+static int32_t  g_ref_rpm = 0;      // start of the rate window
+static uint64_t g_ref_ns = 0;
+static bool     g_have_ref = false;
+static bool     g_have_rpm = false;
+static uint64_t g_settle_ns = 0;    // no lead before
+static ShiftFlash g_flash = ShiftFlash::NONE;
+
+// flash | gear << 8 | down << 16 | up << 32
+static std::atomic<uint64_t> g_state{0xFF00};
+
+static uint64_t pack(ShiftFlash f, int32_t gear, uint16_t down, uint16_t up){
+  return uint64_t(f) | uint64_t(uint8_t(gear)) << 8 | uint64_t(down) << 16 | uint64_t(up) << 32;
+}
+
+ShiftState shiftpoint_state(){
+  uint64_t s = g_state.load(std::memory_order_relaxed);
+  return { ShiftFlash(s & 0xFF), int8_t(s >> 8), uint16_t(s >> 16), uint16_t(s >> 32) };
+}
+
+int32_t shiftpoint_rate(){ return g_rate; }
+
+static bool evaluate(uint64_t t_ns){
+  const DashConfig &c = g_cfg ? *g_cfg : dashcfg();
+  const int idx = g_gear >= 1 && g_gear <= DASH_GEARS ? g_gear : 0;
+  const int32_t down = c.shift_down[idx], up = c.shift_up[idx];
+
+  ShiftFlash f = ShiftFlash::NONE;
+  if (g_rpm > 0 && g_gear != 0) {
+    int32_t lead = t_ns >= g_settle_ns ? int32_t(int64_t(g_rate) * c.shift_lead_ms / 1000) : 0;
+    int32_t pred = g_rpm + lead;
+    bool can_up   = g_gear < 0 || g_gear < c.top_gear;
+    bool can_down = g_gear < 0 || g_gear > 1;
+    if (can_up && pred >= (g_flash == ShiftFlash::UP ? up - SHIFT_HYSTERESIS_RPM : up))
+      f = ShiftFlash::UP;
+    else if (can_down && pred < (g_flash == ShiftFlash::DOWN ? down + SHIFT_HYSTERESIS_RPM : down))
+      f = ShiftFlash::DOWN;
+  }
+  g_flash = f;
+
+  uint64_t s = pack(f, g_gear, uint16_t(down), uint16_t(up));
+  if (s == g_state.load(std::memory_order_relaxed)) return false;
+  g_state.store(s, std::memory_order_relaxed);
+  return true;
+}
+
+bool shiftpoint_configure(const DashConfig &c){
+  g_cfg = &c;
+  return evaluate(g_rpm_ns);
+}
+
+bool shiftpoint_rpm(int32_t rpm, uint64_t t_ns){
+  if (g_have_ref && t_ns > g_ref_ns) {
+    uint64_t dt = t_ns - g_ref_ns;
+    if (dt > RATE_MAX_GAP_NS) {
+      g_rate = 0;
+      g_have_ref = false;
+    } else if (dt >= RATE_WINDOW_NS) {
+      int64_t r = int64_t(rpm - g_ref_rpm) * 1000000000 / int64_t(dt);
+      if (r > RATE_MAX) r = RATE_MAX;
+      if (r < -RATE_MAX) r = -RATE_MAX;
+      g_rate += (int32_t(r) - g_rate) / 4;
+      g_have_ref = false;
+    }
+  }
+  if (!g_have_ref) {
+    g_ref_rpm = rpm;
+    g_ref_ns = t_ns;
+    g_have_ref = true;
+  }
+  if (!g_have_rpm || t_ns > g_rpm_ns) g_rpm_ns = t_ns;
+  g_have_rpm = true;
+  g_rpm = rpm;
+  return evaluate(t_ns);
+}
+
+bool shiftpoint_gear(int32_t gear, uint64_t t_ns){
+  if (gear > DASH_GEARS) gear = -1;   // not one we have points for
+  if (gear == g_gear) return false;
+  if (g_gear >= 0) {
+    g_rate = 0;
+    g_have_ref = false;
+    g_settle_ns = t_ns + GEAR_SETTLE_NS;
+  }
+  g_gear = gear;
+  return evaluate(t_ns);
+}
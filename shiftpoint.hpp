@@ -0,0 +1,37 @@
+#pragma once
+// Shift points: the one state the shift lights are drawn from. dashui.cpp
+// feeds it the rpm and the gear as their frames arrive; the rpm bar's shift
+// overlays and the LED strip (main.cpp, possibly from the LED thread) read it.
+//   - the points are the gear's (rpm_min.<gear>/rpm_max.<gear> of
+//     dashconfig.hpp), or rpm_min/rpm_max until a gear frame came in
+//   - the rpm is predicted shift_lead_ms ahead at the rate it moves (over
+//     50 ms or more, so sensor noise doesn't swing it), so the light comes
+//     on early enough for the driver to react at the point
+//   - no shift up in top_gear, no shift down in 1st, nothing in neutral or
+//     with the engine off
+// A light goes off only once the prediction is SHIFT_HYSTERESIS_RPM back.
+// Each sample is O(1) with no allocation; the state is published as one
+// 64-bit atomic.
+#include <cstdint>
+#include "shiftlight.hpp"
+
+struct DashConfig;
+
+struct ShiftState {
+  ShiftFlash flash;
+  int8_t     gear;        // -1 before the first gear frame, 0 neutral
+  uint16_t   down, up;    // shift points of that gear
+};
+
+// UI thread. Takes the points of c (a snapshot of dashcfg(), kept) and
+// re-evaluates. True if the state changed.
+bool shiftpoint_configure(const DashConfig &c);
+// A new rpm (filtered as shown) or gear at t_ns. True if the state changed.
+bool shiftpoint_rpm(int32_t rpm, uint64_t t_ns);
+bool shiftpoint_gear(int32_t gear, uint64_t t_ns);
+
+// The rpm rate the prediction uses, rpm/s. UI thread.
+int32_t shiftpoint_rate();
+
+// From any thread.
+ShiftState shiftpoint_state();
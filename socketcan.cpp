@@ -7,6 +7,7 @@
 #include <net/if.h>
 #include <sys/ioctl.h>
 #include <cstdio>
+#include <ctime>
 
 
 SocketCan::SocketCan(const char* ifname) : ifname_(ifname) {}
@@ -19,14 +20,45 @@ bool SocketCan::open(){
   if (ioctl(s, SIOCGIFINDEX, &ifr) < 0) { close(s); return false; }
   sockaddr_can addr{}; addr.can_family = AF_CAN; addr.can_ifindex = ifr.ifr_ifindex;
   if (bind(s, (sockaddr*)&addr, sizeof(addr)) < 0) { close(s); return false; }
+  int on = 1;
+  setsockopt(s, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));  // rx time for the latency trace
+  setsockopt(s, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));     // drop count for the metrics
   sock_ = s; return true;
 }
 
+static uint64_t clock_ns(clockid_t id){
+  timespec ts{};
+  clock_gettime(id, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
 std::optional<CanFrame> SocketCan::read_nonblock(){
   can_frame f{};
-  int n = ::recv(sock_, &f, sizeof(f), MSG_DONTWAIT);
+  iovec iov{ &f, sizeof(f) };
+  alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t))];
+  msghdr msg{};
+  msg.msg_iov = &iov; msg.msg_iovlen = 1;
+  msg.msg_control = ctrl; msg.msg_controllen = sizeof(ctrl);
+  int n = ::recvmsg(sock_, &msg, MSG_DONTWAIT);
   if (n <= 0) return std::nullopt;
   CanFrame out{}; out.id = f.can_id & CAN_EFF_MASK; out.dlc = f.can_dlc;
   std::memcpy(out.data, f.data, 8);
+
+  // The kernel stamps CLOCK_REALTIME; move it to CLOCK_MONOTONIC by the age.
+  uint64_t mono = clock_ns(CLOCK_MONOTONIC);
+  out.rx_ns = mono;
+  for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+    if (c->cmsg_level != SOL_SOCKET) continue;
+    if (c->cmsg_type == SO_RXQ_OVFL) {
+      std::memcpy(&dropped_, CMSG_DATA(c), sizeof(dropped_));
+      continue;
+    }
+    if (c->cmsg_type != SCM_TIMESTAMPNS) continue;
+    timespec ts;
+    std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+    uint64_t rx_real = uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+    uint64_t real = clock_ns(CLOCK_REALTIME);
+    if (rx_real <= real && real - rx_real < mono) out.rx_ns = mono - (real - rx_real);
+  }
   return out;
 }
@@ -6,6 +6,7 @@ struct CanFrame {
   uint32_t id;
   uint8_t  dlc;
   uint8_t  data[8];
+  uint64_t rx_ns = 0;  // receive time on CLOCK_MONOTONIC (kernel timestamp), 0 if unknown
 };
 
 class SocketCan {
@@ -14,7 +15,10 @@ public:
   ~SocketCan();
   bool open();
   std::optional<CanFrame> read_nonblock();
+  // Frames the kernel dropped because the socket's queue was full.
+  uint32_t dropped() const { return dropped_; }
 private:
   int sock_ = -1;
+  uint32_t dropped_ = 0;
   const char* ifname_;
 };
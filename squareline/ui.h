@@ -17,6 +17,8 @@ extern "C" {
 
 // SCREEN: ui_Screen1
 void ui_Screen1_screen_init(void);
+// Resizes the rpm zones and the bar range for a new config (dashconfig.hpp).
+void ui_Screen1_set_rpm_zones(int32_t display_min, int32_t display_max, int32_t rpm_min, int32_t rpm_max);
 extern lv_obj_t * ui_Screen1;
 extern lv_obj_t * ui_rpmbackgreen;
 extern lv_obj_t * ui_rpmbackblue;
@@ -7,19 +7,45 @@
 #include "config.h"
 // const uint16_t RPM_DISPLAY_MIN = 0;     // Minimum RPM value that can be shown on the slider.
 // const uint16_t RPM_DISPLAY_MAX = 900;   // Maximum RPM value that can be shown on the slider.
-const float OLD_RANGE = RPM_DISPLAY_MAX - RPM_DISPLAY_MIN;
 const float NEW_RANGE = 800;
-const float MULTIPLIER = NEW_RANGE / OLD_RANGE;
 const int OFFSET = 400;
 
-const int greenWidth = (RPM_MAX - RPM_MIN) * MULTIPLIER;
-const int greenX = (MULTIPLIER * RPM_MIN) + (greenWidth/2) - OFFSET;
+// Width and x of the blue, green and red zones behind the bar; set from the
+// runtime config by ui_Screen1_set_rpm_zones().
+static int greenWidth, greenX, blueWidth, blueX, redWidth, redX;
 
-const int blueWidth = (RPM_MIN - RPM_DISPLAY_MIN) * MULTIPLIER;
-const int blueX = (MULTIPLIER * RPM_DISPLAY_MIN) + (blueWidth/2) - OFFSET;
+static void rpm_zones_compute(int32_t display_min, int32_t display_max, int32_t rpm_min, int32_t rpm_max)
+{
+    const float MULTIPLIER = NEW_RANGE / (float)(display_max - display_min);
+
+    greenWidth = (rpm_max - rpm_min) * MULTIPLIER;
+    greenX = (MULTIPLIER * (rpm_min - display_min)) + (greenWidth/2) - OFFSET;
+
+    blueWidth = (rpm_min - display_min) * MULTIPLIER;
+    blueX = (blueWidth/2) - OFFSET;
+
+    redWidth = (display_max - rpm_max) * MULTIPLIER;
+    redX = (MULTIPLIER * (rpm_max - display_min)) + (redWidth/2) - OFFSET;
+}
 
-const int redWidth = (RPM_DISPLAY_MAX - RPM_MAX) * MULTIPLIER;
-const int redX = (MULTIPLIER * RPM_MAX) + (redWidth/2) - OFFSET;
+static void rpm_zone_set(lv_obj_t * obj, int width, int x)
+{
+    if(obj == NULL) return;     // deleted when rpmbar.c replaces the composite
+    lv_obj_set_width(obj, width);
+    lv_obj_set_x(obj, x);
+}
+
+void ui_Screen1_set_rpm_zones(int32_t display_min, int32_t display_max, int32_t rpm_min, int32_t rpm_max)
+{
+    rpm_zones_compute(display_min, display_max, rpm_min, rpm_max);
+    rpm_zone_set(ui_rpmbackgreen, greenWidth, greenX);
+    rpm_zone_set(ui_rpmfrontgreen, greenWidth, greenX);
+    rpm_zone_set(ui_rpmbackblue, blueWidth, blueX);
+    rpm_zone_set(ui_rpmfrontblue, blueWidth, blueX);
+    rpm_zone_set(ui_rpmbackred, redWidth, redX);
+    rpm_zone_set(ui_rpmfrontred, redWidth, redX);
+    if(ui_erpmbar) lv_bar_set_range(ui_erpmbar, display_min, display_max);
+}
 
 // const uint16_t MID_RANGE = RANGE / 2 - 400;
 
@@ -29,6 +55,8 @@ const int redX = (MULTIPLIER * RPM_MAX) + (redWidth/2) - OFFSET;
 
 void ui_Screen1_screen_init(void)
 {
+    rpm_zones_compute(RPM_DISPLAY_MIN, RPM_DISPLAY_MAX, RPM_MIN, RPM_MAX);
+
     ui_Screen1 = lv_obj_create(NULL);
     lv_obj_clear_flag(ui_Screen1, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
 
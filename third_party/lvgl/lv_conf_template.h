@@ -59,6 +59,13 @@
         #undef LV_MEM_POOL_ALLOC
     #endif
 
+    /*Add a pool of this size with `malloc` every time the memory runs out (at most 16). Not larger than `LV_MEM_SIZE`.*/
+    #define LV_MEM_EXPAND_SIZE 0    /*[bytes], 0: the memory has a fixed size*/
+
+    /*Allocate the small memories (<= 128 bytes) from size class slabs of this total size, next to `LV_MEM_SIZE`.
+     *Label texts, styles, timers and animations come and go often, in the slabs they can't fragment the pool.*/
+    #define LV_MEM_SLAB_SIZE 0      /*[bytes], 0: disable*/
+
 #else       /*LV_MEM_CUSTOM*/
     #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
     #define LV_MEM_CUSTOM_ALLOC   malloc
@@ -70,6 +77,11 @@
  *You will see an error log message if there wasn't enough buffers. */
 #define LV_MEM_BUF_MAX_NUM 16
 
+/*Size of the arena every drawing thread takes the intermediate buffers and the layers from while refreshing.
+ *The arena is emptied at the end of each refresh, `lv_mem_alloc()` is used if it's full.
+ *Size it by `lv_mem_frame_get_stats()`'s high water mark.*/
+#define LV_MEM_FRAME_SIZE 0     /*[bytes], 0: use LV_MEM_BUF_MAX_NUM buffers and `lv_mem_alloc()`*/
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #define LV_MEMCPY_MEMSET_STD 0
 
@@ -118,7 +130,8 @@
 
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    * radius * 6 bytes are used per circle (the least recently used one is replaced)
+    * Can be changed with `lv_draw_mask_set_circle_cache_size()`
     * 0: to disable caching */
     #define LV_CIRCLE_CACHE_SIZE 4
 #endif /*LV_DRAW_COMPLEX*/
@@ -172,6 +185,33 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*Use SIMD kernels for the common software blend paths (RGB565 only, other formats fall back to C).
+ *LV_DRAW_SW_ASM_NONE: portable C
+ *LV_DRAW_SW_ASM_NEON: Arm NEON (AArch64 or ARMv7 with NEON)*/
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_NONE
+
+/*Draw the invalidated areas with several POSIX threads.
+ *Every area is cut into horizontal bands which are drawn in parallel into the draw buffer
+ *and flushed when all of them are ready. The result is the same as drawing on one thread.
+ *Requires the software renderer and `LV_ENABLE_GC == 0`.*/
+#define LV_USE_REFR_THREADS 0
+#if LV_USE_REFR_THREADS
+    /*Max. number of drawing threads including the one calling `lv_timer_handler()`.
+     *Can be lowered at runtime with `lv_refr_set_thread_cnt()`*/
+    #define LV_REFR_THREAD_CNT 4
+
+    /*Pin the helper threads to consecutive CPUs starting from this one. -1: don't pin*/
+    #define LV_REFR_THREAD_CPU_FIRST -1
+
+    /*Don't cut bands lower than this (rows)*/
+    #define LV_REFR_THREAD_MIN_ROWS 16
+#endif
+
+/*Don't draw the objects which are fully hidden by opaque siblings drawn after them.
+ *The siblings can hide an object together, e.g. several buttons side by side.
+ *`lv_refr_get_overdraw()` tells how many pixels were drawn and skipped in the last refresh.*/
+#define LV_USE_REFR_OCCLUSION 0
+
 /*-------------
  * GPU
  *-----------*/
@@ -294,6 +334,15 @@
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 0
 
+/*1: Record the refresh stages and the draw calls (and the application's own trace points)
+ *into per thread ring buffers which `lv_trace_dump()` writes as Chrome trace JSON.
+ *Needs `__thread` and `clock_gettime()`*/
+#define LV_USE_TRACE 0
+#if LV_USE_TRACE
+    #define LV_TRACE_BUF_EVENTS 16384   /*Last events kept per thread (16 bytes each), a power of 2*/
+    #define LV_TRACE_MAX_THREADS 8      /*Threads beyond this are not recorded*/
+#endif
+
 /*Change the built in (v)snprintf functions*/
 #define LV_SPRINTF_CUSTOM 0
 #if LV_SPRINTF_CUSTOM
@@ -32,6 +32,10 @@ fout.write(
 
 #include <stdint.h>
 
+/*Values for LV_USE_DRAW_SW_ASM*/
+#define LV_DRAW_SW_ASM_NONE 0
+#define LV_DRAW_SW_ASM_NEON 1
+
 /* Handle special Kconfig options */
 #ifndef LV_KCONFIG_IGNORE
     #include "lv_conf_kconfig.h"
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_indev.h"
+#include "../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -34,7 +35,7 @@ static bool event_is_bubbled(lv_event_t * e);
 /**********************
  *  STATIC VARIABLES
  **********************/
-static lv_event_t * event_head;
+static LV_THREAD_LOCAL lv_event_t * event_head; /*Events are sent from every drawing thread*/
 
 /**********************
  *      MACROS
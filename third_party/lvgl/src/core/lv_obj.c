@@ -199,6 +199,7 @@ void lv_deinit(void)
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
+    _lv_refr_deinit();
     lv_mem_deinit();
     lv_initialized = false;
 
@@ -6,6 +6,9 @@
 /*********************
  *      INCLUDES
  *********************/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE /*For pthread_setaffinity_np() with LV_USE_REFR_THREADS*/
+#endif
 #include <stddef.h>
 #include "lv_refr.h"
 #include "lv_disp.h"
@@ -18,6 +21,14 @@
 #include "../draw/lv_draw.h"
 #include "../font/lv_font_fmt_txt.h"
 #include "../extra/others/snapshot/lv_snapshot.h"
+#include "../misc/lv_thread.h"
+#include "../misc/lv_trace.h"
+#include "../misc/lv_printf.h"
+
+#if LV_USE_REFR_THREADS
+    #include <sched.h>
+    #include <unistd.h>
+#endif
 
 #if LV_USE_PERF_MONITOR || LV_USE_MEM_MONITOR
     #include "../widgets/lv_label.h"
@@ -26,10 +37,31 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_USE_REFR_THREADS
+    #define REFR_WORKER_MAX (LV_REFR_THREAD_CNT > 1 ? LV_REFR_THREAD_CNT - 1 : 1)
+#endif
+
+#if LV_USE_REFR_OCCLUSION
+    #define REFR_OCCLUDER_MAX       16  /*Max. number of opaque areas collected from the siblings*/
+    #define REFR_OCCLUSION_FRAG_MAX 16  /*Max. number of uncovered pieces tracked while testing an object*/
+    #define REFR_OCCLUSION_CHILD_MAX 128 /*Only the first children can be skipped*/
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_REFR_THREADS
+/*A helper thread drawing a band of the area being refreshed*/
+typedef struct {
+    pthread_t thread;
+    lv_draw_ctx_t * draw_ctx;   /*Own copy of the display's draw_ctx*/
+    uint32_t draw_ctx_size;
+    lv_area_t buf_area;
+    lv_area_t clip_area;        /*The band to draw*/
+    bool busy;                  /*A band is assigned and not drawn yet*/
+} refr_worker_t;
+#endif
+
 typedef struct {
     uint32_t    perf_last_time;
     uint32_t    elaps_sum;
@@ -43,6 +75,7 @@ typedef struct {
 
 typedef struct {
     uint32_t     mem_last_time;
+    uint32_t     mem_last_alloc_cnt;
 #if LV_USE_LABEL
     lv_obj_t  *  mem_label;
 #endif
@@ -56,13 +89,26 @@ static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
+static void refr_area_part_draw(lv_draw_ctx_t * draw_ctx);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj);
+static void refr_obj_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * parent, uint32_t first);
 static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+#if LV_USE_REFR_OCCLUSION
+    static void refr_find_occluded(const lv_area_t * clip_area, lv_obj_t * parent, uint32_t first, uint32_t * occluded);
+    static uint32_t get_opaque_areas(lv_obj_t * obj, const lv_area_t * clip_area, lv_area_t * areas, uint32_t max);
+    static bool area_is_covered(const lv_area_t * area, const lv_area_t * covers, uint32_t cover_cnt);
+#endif
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h);
 static void draw_buf_flush(lv_disp_t * disp);
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
 
+#if LV_USE_REFR_THREADS
+    static void refr_area_part_draw_bands(lv_draw_ctx_t * draw_ctx);
+    static uint32_t refr_workers_start(uint32_t cnt);
+    static void * refr_worker_main(void * p);
+    static void overdraw_add(lv_refr_overdraw_t * dst, const lv_refr_overdraw_t * src);
+#endif
 #if LV_USE_PERF_MONITOR
     static void perf_monitor_init(perf_monitor_t * perf_monitor);
 #endif
@@ -75,6 +121,20 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
  **********************/
 static uint32_t px_num;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
+static LV_THREAD_LOCAL lv_refr_overdraw_t overdraw_act;  /*Counted by the drawing thread*/
+static lv_refr_overdraw_t overdraw_last;                 /*Of the last refresh*/
+
+#if LV_USE_REFR_THREADS
+    static uint32_t refr_thread_cnt = LV_REFR_THREAD_CNT;
+    static refr_worker_t refr_workers[REFR_WORKER_MAX];
+    static uint32_t refr_worker_cnt;        /*Number of started helper threads*/
+    static uint32_t refr_worker_pending;    /*Number of bands not drawn yet*/
+    static pthread_mutex_t refr_worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t refr_worker_start_cond = PTHREAD_COND_INITIALIZER;
+    static pthread_cond_t refr_worker_done_cond = PTHREAD_COND_INITIALIZER;
+    static bool refr_worker_stop;           /*Set by `_lv_refr_deinit()` to end the helper threads*/
+    static lv_refr_overdraw_t refr_worker_overdraw;  /*Collected from the helper threads*/
+#endif
 
 #if LV_USE_PERF_MONITOR
     static perf_monitor_t   perf_monitor;
@@ -110,6 +170,30 @@ void _lv_refr_init(void)
 #endif
 }
 
+/**
+ * Deinitialize the screen refresh subsystem
+ */
+void _lv_refr_deinit(void)
+{
+#if LV_USE_REFR_THREADS
+    pthread_mutex_lock(&refr_worker_mutex);
+    refr_worker_stop = true;
+    pthread_cond_broadcast(&refr_worker_start_cond);
+    pthread_mutex_unlock(&refr_worker_mutex);
+
+    uint32_t i;
+    for(i = 0; i < refr_worker_cnt; i++) {
+        refr_worker_t * worker = &refr_workers[i];
+        pthread_join(worker->thread, NULL);
+        lv_mem_free(worker->draw_ctx);
+        worker->draw_ctx = NULL;
+        worker->draw_ctx_size = 0;
+    }
+    refr_worker_cnt = 0;
+    refr_worker_stop = false;
+#endif
+}
+
 void lv_refr_now(lv_disp_t * disp)
 {
     lv_anim_refr_now();
@@ -143,6 +227,7 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     bool should_draw = com_clip_res || lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
     if(should_draw) {
         draw_ctx->clip_area = &clip_coords_for_obj;
+        if(com_clip_res) overdraw_act.px_drawn += lv_area_get_size(&clip_coords_for_obj);
 
         lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
         lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
@@ -175,12 +260,7 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
 
     if(refr_children) {
         draw_ctx->clip_area = &clip_coords_for_children;
-        uint32_t i;
-        uint32_t child_cnt = lv_obj_get_child_cnt(obj);
-        for(i = 0; i < child_cnt; i++) {
-            lv_obj_t * child = obj->spec_attr->children[i];
-            refr_obj(draw_ctx, child);
-        }
+        refr_obj_children(draw_ctx, obj, 0);
     }
 
     /*If the object was visible on the clip area call the post draw events too*/
@@ -287,6 +367,7 @@ void _lv_refr_set_disp_refreshing(lv_disp_t * disp)
 void _lv_disp_refr_timer(lv_timer_t * tmr)
 {
     REFR_TRACE("begin");
+    LV_TRACE_BEGIN("lv_refr");
 
     uint32_t start = lv_tick_get();
     volatile uint32_t elaps = 0;
@@ -317,6 +398,7 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr->inv_p = 0;
         LV_LOG_WARN("there is no active screen");
         REFR_TRACE("finished");
+        LV_TRACE_END("lv_refr");
         return;
     }
 
@@ -354,12 +436,9 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     }
 
     lv_mem_buf_free_all();
+    lv_mem_frame_reset();
     _lv_font_clean_up_fmt_txt();
 
-#if LV_DRAW_COMPLEX
-    _lv_draw_mask_cleanup();
-#endif
-
 #if LV_USE_PERF_MONITOR && LV_USE_LABEL
     lv_obj_t * perf_label = perf_monitor.perf_label;
     if(perf_label == NULL) {
@@ -433,24 +512,48 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         mem_monitor.mem_label = mem_label;
     }
 
-    if(lv_tick_elaps(mem_monitor.mem_last_time) > 300) {
+    uint32_t elaps = lv_tick_elaps(mem_monitor.mem_last_time);
+    if(elaps > 300) {
         mem_monitor.mem_last_time = lv_tick_get();
         lv_mem_monitor_t mon;
         lv_mem_monitor(&mon);
         uint32_t used_size = mon.total_size - mon.free_size;;
         uint32_t used_kb = used_size / 1024;
         uint32_t used_kb_tenth = (used_size - (used_kb * 1024)) / 102;
+        uint32_t alloc_rate = (mon.alloc_cnt - mem_monitor.mem_last_alloc_cnt) * 1000 / elaps;
+        mem_monitor.mem_last_alloc_cnt = mon.alloc_cnt;
         lv_label_set_text_fmt(mem_label,
                               "%"LV_PRIu32 ".%"LV_PRIu32 " kB used (%d %%)\n"
-                              "%d%% frag.",
+                              "%d%% frag.\n"
+                              "%"LV_PRIu32 " kB peak, %"LV_PRIu32 " alloc/s",
                               used_kb, used_kb_tenth, mon.used_pct,
-                              mon.frag_pct);
+                              mon.frag_pct, mon.max_used / 1024, alloc_rate);
     }
 #endif
 
+    LV_TRACE_END("lv_refr");
     REFR_TRACE("finished");
 }
 
+#if LV_USE_REFR_THREADS
+void lv_refr_set_thread_cnt(uint32_t cnt)
+{
+    if(cnt < 1) cnt = 1;
+    if(cnt > LV_REFR_THREAD_CNT) cnt = LV_REFR_THREAD_CNT;
+    refr_thread_cnt = cnt;
+}
+
+uint32_t lv_refr_get_thread_cnt(void)
+{
+    return refr_thread_cnt;
+}
+#endif
+
+void lv_refr_get_overdraw(lv_refr_overdraw_t * overdraw)
+{
+    *overdraw = overdraw_last;
+}
+
 #if LV_USE_PERF_MONITOR
 void lv_refr_reset_fps_counter(void)
 {
@@ -590,6 +693,11 @@ static void refr_invalid_areas(void)
 
     if(disp_refr->inv_p == 0) return;
 
+    lv_memset_00(&overdraw_act, sizeof(overdraw_act));
+#if LV_USE_REFR_THREADS
+    lv_memset_00(&refr_worker_overdraw, sizeof(refr_worker_overdraw));
+#endif
+
     /*Find the last area which will be drawn*/
     int32_t i;
     int32_t last_i = 0;
@@ -622,6 +730,12 @@ static void refr_invalid_areas(void)
     }
 
     disp_refr->rendering_in_progress = false;
+
+    overdraw_last = overdraw_act;
+#if LV_USE_REFR_THREADS
+    overdraw_add(&overdraw_last, &refr_worker_overdraw);
+#endif
+    overdraw_last.px_shown = px_num;
 }
 
 /**
@@ -630,6 +744,8 @@ static void refr_invalid_areas(void)
  */
 static void refr_area(const lv_area_t * area_p)
 {
+    LV_TRACE_BEGIN("refr_area");
+
     lv_draw_ctx_t * draw_ctx = disp_refr->driver->draw_ctx;
     draw_ctx->buf = disp_refr->driver->draw_buf->buf_act;
 
@@ -650,6 +766,7 @@ static void refr_area(const lv_area_t * area_p)
             draw_ctx->clip_area = area_p;
             refr_area_part(draw_ctx);
         }
+        LV_TRACE_END("refr_area");
         return;
     }
 
@@ -693,6 +810,8 @@ static void refr_area(const lv_area_t * area_p)
         disp_refr->driver->draw_buf->last_part = 1;
         refr_area_part(draw_ctx);
     }
+
+    LV_TRACE_END("refr_area");
 }
 
 static void refr_area_part(lv_draw_ctx_t * draw_ctx)
@@ -725,6 +844,23 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
 #endif
     }
 
+#if LV_USE_REFR_THREADS
+    refr_area_part_draw_bands(draw_ctx);
+#else
+    refr_area_part_draw(draw_ctx);
+#endif
+
+    draw_buf_flush(disp_refr);
+}
+
+/**
+ * Draw the screens and the layers into the clip area of `draw_ctx`
+ * @param draw_ctx  draw context with the buffer and clip area to use
+ */
+static void refr_area_part_draw(lv_draw_ctx_t * draw_ctx)
+{
+    LV_TRACE_BEGIN("draw");
+
     lv_obj_t * top_act_scr = NULL;
     lv_obj_t * top_prev_scr = NULL;
 
@@ -795,8 +931,137 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_top(disp_refr));
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_sys(disp_refr));
 
-    draw_buf_flush(disp_refr);
+    LV_TRACE_END("draw");
+}
+
+#if LV_USE_REFR_THREADS
+/**
+ * Cut the clip area of `draw_ctx` into horizontal bands and draw them in parallel:
+ * the first one on this thread, the others on the helper threads.
+ * Every band is drawn into its own rows of the same buffer, so the result is the same as drawing serially.
+ * Returns only when all the bands are ready.
+ * @param draw_ctx  draw context with the buffer and clip area to use
+ */
+static void refr_area_part_draw_bands(lv_draw_ctx_t * draw_ctx)
+{
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    lv_coord_t h = lv_area_get_height(clip_area_ori);
+    uint32_t band_cnt = LV_MIN(refr_thread_cnt, (uint32_t)(h / LV_REFR_THREAD_MIN_ROWS));
+    if(band_cnt > 1) band_cnt = refr_workers_start(band_cnt - 1) + 1;
+    if(band_cnt <= 1) {
+        refr_area_part_draw(draw_ctx);
+        return;
+    }
+
+    uint32_t draw_ctx_size = disp_refr->driver->draw_ctx_size;
+    uint32_t i;
+    for(i = 1; i < band_cnt; i++) {
+        refr_worker_t * worker = &refr_workers[i - 1];
+        if(worker->draw_ctx_size != draw_ctx_size) {
+            lv_draw_ctx_t * new_ctx = lv_mem_realloc(worker->draw_ctx, draw_ctx_size);
+            LV_ASSERT_MALLOC(new_ctx);
+            if(new_ctx == NULL) {
+                band_cnt = i;
+                break;
+            }
+            worker->draw_ctx = new_ctx;
+            worker->draw_ctx_size = draw_ctx_size;
+        }
+    }
+
+    pthread_mutex_lock(&refr_worker_mutex);
+    for(i = 1; i < band_cnt; i++) {
+        refr_worker_t * worker = &refr_workers[i - 1];
+        lv_memcpy(worker->draw_ctx, draw_ctx, draw_ctx_size);
+        worker->buf_area = *draw_ctx->buf_area;
+        worker->clip_area = *clip_area_ori;
+        worker->clip_area.y1 = clip_area_ori->y1 + (h * i) / band_cnt;
+        worker->clip_area.y2 = clip_area_ori->y1 + (h * (i + 1)) / band_cnt - 1;
+        worker->draw_ctx->buf_area = &worker->buf_area;
+        worker->draw_ctx->clip_area = &worker->clip_area;
+        worker->busy = true;
+    }
+    refr_worker_pending = band_cnt - 1;
+    pthread_cond_broadcast(&refr_worker_start_cond);
+    pthread_mutex_unlock(&refr_worker_mutex);
+
+    lv_area_t band = *clip_area_ori;
+    band.y2 = clip_area_ori->y1 + h / band_cnt - 1;
+    draw_ctx->clip_area = &band;
+    refr_area_part_draw(draw_ctx);
+    draw_ctx->clip_area = clip_area_ori;
+
+    /*The buffer can be flushed only when all the bands are ready*/
+    pthread_mutex_lock(&refr_worker_mutex);
+    while(refr_worker_pending) pthread_cond_wait(&refr_worker_done_cond, &refr_worker_mutex);
+    pthread_mutex_unlock(&refr_worker_mutex);
+}
+
+/**
+ * Start helper threads until there are `cnt` of them
+ * @param cnt   required number of helper threads
+ * @return      number of running helper threads (less than `cnt` if a thread couldn't be started)
+ */
+static uint32_t refr_workers_start(uint32_t cnt)
+{
+    if(cnt > REFR_WORKER_MAX) cnt = REFR_WORKER_MAX;
+
+    while(refr_worker_cnt < cnt) {
+        refr_worker_t * worker = &refr_workers[refr_worker_cnt];
+        if(pthread_create(&worker->thread, NULL, refr_worker_main, worker) != 0) {
+            LV_LOG_WARN("couldn't start a drawing thread, using %d", (int)refr_worker_cnt + 1);
+            break;
+        }
+
+#if defined(__linux__) && LV_REFR_THREAD_CPU_FIRST >= 0
+        long cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+        if(cpu_num > 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET((LV_REFR_THREAD_CPU_FIRST + refr_worker_cnt) % cpu_num, &cpus);
+            pthread_setaffinity_np(worker->thread, sizeof(cpus), &cpus);
+        }
+#endif
+        refr_worker_cnt++;
+    }
+
+    return refr_worker_cnt;
+}
+
+static void * refr_worker_main(void * p)
+{
+    refr_worker_t * worker = p;
+
+#if LV_USE_TRACE
+    char name[16];
+    lv_snprintf(name, sizeof(name), "lv_refr %d", (int)(worker - refr_workers) + 1);
+    lv_trace_set_thread_name(name);
+#endif
+
+    pthread_mutex_lock(&refr_worker_mutex);
+    while(1) {
+        while(!worker->busy && !refr_worker_stop) pthread_cond_wait(&refr_worker_start_cond, &refr_worker_mutex);
+        if(refr_worker_stop) break;
+        pthread_mutex_unlock(&refr_worker_mutex);
+
+        refr_area_part_draw(worker->draw_ctx);
+
+        /*Release the temporal buffers of this thread as the refresh timer does for its own thread*/
+        lv_mem_buf_free_all();
+        lv_mem_frame_reset();
+
+        pthread_mutex_lock(&refr_worker_mutex);
+        overdraw_add(&refr_worker_overdraw, &overdraw_act);
+        lv_memset_00(&overdraw_act, sizeof(overdraw_act));
+        worker->busy = false;
+        refr_worker_pending--;
+        if(refr_worker_pending == 0) pthread_cond_signal(&refr_worker_done_cond);
+    }
+    pthread_mutex_unlock(&refr_worker_mutex);
+
+    return NULL;
 }
+#endif /*LV_USE_REFR_THREADS*/
 
 /**
  * Search the most top object which fully covers an area
@@ -863,19 +1128,8 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
 
     /*Do until not reach the screen*/
     while(parent != NULL) {
-        bool go = false;
-        uint32_t i;
-        uint32_t child_cnt = lv_obj_get_child_cnt(parent);
-        for(i = 0; i < child_cnt; i++) {
-            lv_obj_t * child = parent->spec_attr->children[i];
-            if(!go) {
-                if(child == border_p) go = true;
-            }
-            else {
-                /*Refresh the objects*/
-                refr_obj(draw_ctx, child);
-            }
-        }
+        /*Refresh the objects after `border_p`*/
+        refr_obj_children(draw_ctx, parent, lv_obj_get_index(border_p) + 1);
 
         /*Call the post draw draw function of the parents of the to object*/
         lv_event_send(parent, LV_EVENT_DRAW_POST_BEGIN, (void *)draw_ctx);
@@ -890,6 +1144,182 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
     }
 }
 
+/**
+ * Refresh the children of an object starting from an index.
+ * With `LV_USE_REFR_OCCLUSION` the children hidden by opaque younger siblings are skipped.
+ * @param draw_ctx  draw context, the children are drawn on its clip area
+ * @param parent    pointer to an object
+ * @param first     index of the first child to refresh
+ */
+static void refr_obj_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * parent, uint32_t first)
+{
+    uint32_t child_cnt = lv_obj_get_child_cnt(parent);
+#if LV_USE_REFR_OCCLUSION
+    uint32_t occluded[REFR_OCCLUSION_CHILD_MAX / 32];
+    refr_find_occluded(draw_ctx->clip_area, parent, first, occluded);
+#endif
+
+    uint32_t i;
+    for(i = first; i < child_cnt; i++) {
+#if LV_USE_REFR_OCCLUSION
+        if(i < REFR_OCCLUSION_CHILD_MAX && (occluded[i / 32] & (1UL << (i % 32)))) continue;
+#endif
+        refr_obj(draw_ctx, parent->spec_attr->children[i]);
+    }
+}
+
+#if LV_USE_REFR_OCCLUSION
+/**
+ * Mark the children which are fully hidden on the clip area by the opaque children drawn after them.
+ * The children are checked from the top, collecting the opaque areas on the way,
+ * so an object can be hidden by several siblings together.
+ * @param clip_area     the area where the children are drawn
+ * @param parent        pointer to an object
+ * @param first         index of the first child which will be drawn
+ * @param occluded      bit field of `REFR_OCCLUSION_CHILD_MAX` bits, set for the children not to draw
+ */
+static void refr_find_occluded(const lv_area_t * clip_area, lv_obj_t * parent, uint32_t first, uint32_t * occluded)
+{
+    lv_memset_00(occluded, REFR_OCCLUSION_CHILD_MAX / 8);
+
+    uint32_t child_cnt = lv_obj_get_child_cnt(parent);
+    if(child_cnt < first + 2) return;
+
+#if LV_DRAW_COMPLEX
+    /*The anti-aliased edges of a mask would let the hidden objects show through*/
+    if(lv_draw_mask_is_any(clip_area)) return;
+#endif
+
+    lv_area_t opaque_areas[REFR_OCCLUDER_MAX];
+    uint32_t opaque_cnt = 0;
+    uint32_t i = child_cnt;
+    while(i > first) {
+        i--;
+        lv_obj_t * child = parent->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+        /*Transformed or semi-transparent layers are drawn elsewhere than their coordinates*/
+        if(_lv_obj_get_layer_type(child) != LV_LAYER_TYPE_NONE) continue;
+
+        lv_area_t draw_area;
+        lv_obj_get_coords(child, &draw_area);
+        lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(child);
+        lv_area_increase(&draw_area, ext_draw_size, ext_draw_size);
+        if(!_lv_area_intersect(&draw_area, clip_area, &draw_area)) continue;
+
+        /*With overflow visible the grandchildren can be drawn out of `draw_area`*/
+        if(i < REFR_OCCLUSION_CHILD_MAX && !lv_obj_has_flag(child, LV_OBJ_FLAG_OVERFLOW_VISIBLE) &&
+           area_is_covered(&draw_area, opaque_areas, opaque_cnt)) {
+            occluded[i / 32] |= 1UL << (i % 32);
+            overdraw_act.px_culled += lv_area_get_size(&draw_area);
+            overdraw_act.obj_culled++;
+            continue;
+        }
+
+        opaque_cnt += get_opaque_areas(child, clip_area, &opaque_areas[opaque_cnt], REFR_OCCLUDER_MAX - opaque_cnt);
+    }
+}
+
+/**
+ * Get the areas where an object's background fully covers what is below it.
+ * @param obj           pointer to an object
+ * @param clip_area     only this area matters
+ * @param areas         store the areas here
+ * @param max           max. number of areas to store
+ * @return              number of areas stored (0..2)
+ */
+static uint32_t get_opaque_areas(lv_obj_t * obj, const lv_area_t * clip_area, lv_area_t * areas, uint32_t max)
+{
+    if(max == 0) return 0;
+
+    lv_cover_check_info_t info;
+    info.area = &areas[0];
+    if(!_lv_area_intersect(&areas[0], clip_area, &obj->coords)) return 0;
+    info.res = LV_COVER_RES_COVER;
+    lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+    if(info.res == LV_COVER_RES_COVER) return 1;
+
+    /*With rounded corners try the cross of two rectangles which leaves out the corners*/
+    lv_coord_t r = lv_obj_get_style_radius(obj, LV_PART_MAIN);
+    if(r <= 0 || max < 2) return 0;
+    if(2 * r + 2 >= lv_obj_get_width(obj) || 2 * r + 2 >= lv_obj_get_height(obj)) return 0;
+
+    uint32_t cnt = 0;
+    uint32_t k;
+    for(k = 0; k < 2; k++) {
+        lv_area_t cross = obj->coords;
+        if(k == 0) lv_area_set(&cross, cross.x1 + r + 1, cross.y1, cross.x2 - r - 1, cross.y2);
+        else lv_area_set(&cross, cross.x1, cross.y1 + r + 1, cross.x2, cross.y2 - r - 1);
+        if(!_lv_area_intersect(&areas[cnt], clip_area, &cross)) continue;
+
+        info.area = &areas[cnt];
+        info.res = LV_COVER_RES_COVER;
+        lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+        if(info.res == LV_COVER_RES_COVER) cnt++;
+    }
+
+    return cnt;
+}
+
+/**
+ * Tell whether the union of some areas covers an area
+ * @param area          the area to test
+ * @param covers        the covering areas
+ * @param cover_cnt     number of covering areas
+ * @return              true: `area` is fully covered; false: not covered or too fragmented to tell
+ */
+static bool area_is_covered(const lv_area_t * area, const lv_area_t * covers, uint32_t cover_cnt)
+{
+    if(cover_cnt == 0) return false;
+
+    /*Cut the covering areas out of `area` one by one and see if anything remains*/
+    lv_area_t frags[REFR_OCCLUSION_FRAG_MAX];
+    uint32_t frag_cnt = 1;
+    frags[0] = *area;
+
+    uint32_t c;
+    for(c = 0; c < cover_cnt && frag_cnt > 0; c++) {
+        const lv_area_t * cover = &covers[c];
+        uint32_t f = 0;
+        while(f < frag_cnt) {
+            lv_area_t fr = frags[f];
+            lv_area_t com;
+            if(!_lv_area_intersect(&com, &fr, cover)) {
+                f++;
+                continue;
+            }
+
+            /*Replace the fragment with its parts around `com`: top, bottom, left, right*/
+            lv_area_t parts[4];
+            uint32_t part_cnt = 0;
+            if(fr.y1 < com.y1) lv_area_set(&parts[part_cnt++], fr.x1, fr.y1, fr.x2, com.y1 - 1);
+            if(fr.y2 > com.y2) lv_area_set(&parts[part_cnt++], fr.x1, com.y2 + 1, fr.x2, fr.y2);
+            if(fr.x1 < com.x1) lv_area_set(&parts[part_cnt++], fr.x1, com.y1, com.x1 - 1, com.y2);
+            if(fr.x2 > com.x2) lv_area_set(&parts[part_cnt++], com.x2 + 1, com.y1, fr.x2, com.y2);
+
+            if(frag_cnt - 1 + part_cnt > REFR_OCCLUSION_FRAG_MAX) return false;
+
+            /*Move the last fragment here and append the parts. They don't intersect `cover`, so
+             *checking them again in this loop just steps over them*/
+            frag_cnt--;
+            frags[f] = frags[frag_cnt];
+            uint32_t p;
+            for(p = 0; p < part_cnt; p++) frags[frag_cnt++] = parts[p];
+        }
+    }
+
+    return frag_cnt == 0;
+}
+#endif /*LV_USE_REFR_OCCLUSION*/
+
+#if LV_USE_REFR_THREADS
+static void overdraw_add(lv_refr_overdraw_t * dst, const lv_refr_overdraw_t * src)
+{
+    dst->px_shown += src->px_shown;
+    dst->px_drawn += src->px_drawn;
+    dst->px_culled += src->px_culled;
+    dst->obj_culled += src->obj_culled;
+}
+#endif
 
 static lv_res_t layer_get_area(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj, lv_layer_type_t layer_type,
                                lv_area_t * layer_area_out)
@@ -1271,6 +1701,8 @@ static void draw_buf_rotate(lv_area_t * area, lv_color_t * color_p)
  */
 static void draw_buf_flush(lv_disp_t * disp)
 {
+    LV_TRACE_BEGIN("flush");
+
     lv_disp_draw_buf_t * draw_buf = lv_disp_get_draw_buf(disp_refr);
 
     /*Flush the rendered content to the display*/
@@ -1310,6 +1742,8 @@ static void draw_buf_flush(lv_disp_t * disp)
         else
             draw_buf->buf_act = draw_buf->buf1;
     }
+
+    LV_TRACE_END("flush");
 }
 
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
@@ -1345,6 +1779,7 @@ static void mem_monitor_init(mem_monitor_t * _mem_monitor)
 {
     LV_ASSERT_NULL(_mem_monitor);
     _mem_monitor->mem_last_time = 0;
+    _mem_monitor->mem_last_alloc_cnt = 0;
     _mem_monitor->mem_label = NULL;
 }
 #endif
@@ -26,6 +26,16 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * Pixel statistics of the last refresh. `px_drawn / px_shown` is the overdraw.
+ */
+typedef struct {
+    uint32_t px_shown;      /**< Pixels of the refreshed areas*/
+    uint32_t px_drawn;      /**< Pixels of the drawn objects (with their extra draw size), overlaps counted every time*/
+    uint32_t px_culled;     /**< Pixels of the objects skipped because opaque siblings hid them*/
+    uint32_t obj_culled;    /**< Number of objects skipped because opaque siblings hid them*/
+} lv_refr_overdraw_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -47,6 +57,12 @@ extern "C" {
  */
 void _lv_refr_init(void);
 
+/**
+ * Deinitialize the screen refresh subsystem.
+ * With LV_USE_REFR_THREADS it stops and joins the helper threads; they are started again when needed.
+ */
+void _lv_refr_deinit(void);
+
 /**
  * Redraw the invalidated areas now.
  * Normally the redrawing is periodically executed in `lv_timer_handler` but a long blocking process
@@ -98,6 +114,27 @@ void lv_refr_reset_fps_counter(void);
 uint32_t lv_refr_get_fps_avg(void);
 #endif
 
+/**
+ * Get the pixel statistics of the last refresh
+ * @param overdraw  store the statistics here
+ */
+void lv_refr_get_overdraw(lv_refr_overdraw_t * overdraw);
+
+#if LV_USE_REFR_THREADS
+/**
+ * Set the number of threads drawing the bands of an area.
+ * The helper threads are started when they are first needed.
+ * @param cnt   number of threads including the caller of `lv_timer_handler()`, 1..LV_REFR_THREAD_CNT
+ */
+void lv_refr_set_thread_cnt(uint32_t cnt);
+
+/**
+ * Get the number of threads drawing the bands of an area.
+ * @return the number of drawing threads
+ */
+uint32_t lv_refr_get_thread_cnt(void);
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param timer pointer to the timer itself
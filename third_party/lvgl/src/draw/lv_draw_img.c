@@ -13,6 +13,8 @@
 #include "../core/lv_refr.h"
 #include "../misc/lv_mem.h"
 #include "../misc/lv_math.h"
+#include "../misc/lv_thread.h"
+#include "../misc/lv_trace.h"
 
 /*********************
  *      DEFINES
@@ -35,6 +37,8 @@ static void draw_cleanup(_lv_img_cache_entry_t * cache);
 /**********************
  *  STATIC VARIABLES
  **********************/
+/*The image cache and the decoders are shared, so the drawing threads of LV_USE_REFR_THREADS decode one by one*/
+static lv_mutex_t decode_mutex = LV_MUTEX_INITIALIZER;
 
 /**********************
  *      MACROS
@@ -70,6 +74,7 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
 
     if(dsc->opa <= LV_OPA_MIN) return;
 
+    LV_TRACE_BEGIN("lv_draw_img");
     lv_res_t res = LV_RES_INV;
 
     if(draw_ctx->draw_img) {
@@ -77,13 +82,16 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
     }
 
     if(res != LV_RES_OK) {
+        lv_mutex_lock(&decode_mutex);
         res = decode_and_draw(draw_ctx, dsc, coords, src);
+        lv_mutex_unlock(&decode_mutex);
     }
 
     if(res != LV_RES_OK) {
         LV_LOG_WARN("Image draw error");
         show_error(draw_ctx, coords, "No\ndata");
     }
+    LV_TRACE_END("lv_draw_img");
 }
 
 /**
@@ -13,6 +13,7 @@
 #include "../core/lv_refr.h"
 #include "../misc/lv_bidi.h"
 #include "../misc/lv_assert.h"
+#include "../misc/lv_trace.h"
 
 /*********************
  *      DEFINES
@@ -34,6 +35,8 @@ typedef uint8_t cmd_state_t;
  *  STATIC PROTOTYPES
  **********************/
 
+static void draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_area_t * coords,
+                       const char * txt, lv_draw_label_hint_t * hint);
 static uint8_t hex_char_to_num(char hex);
 
 /**********************
@@ -76,6 +79,24 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label_dsc_init(lv_draw_label_dsc_t * dsc)
  */
 void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
                                          const lv_area_t * coords, const char * txt, lv_draw_label_hint_t * hint)
+{
+    LV_TRACE_BEGIN("lv_draw_label");
+    draw_label(draw_ctx, dsc, coords, txt, hint);
+    LV_TRACE_END("lv_draw_label");
+}
+
+void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
+                    uint32_t letter)
+{
+    draw_ctx->draw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void LV_ATTRIBUTE_FAST_MEM draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                                             const lv_area_t * coords, const char * txt, lv_draw_label_hint_t * hint)
 {
     if(dsc->opa <= LV_OPA_MIN) return;
     if(dsc->font == NULL) {
@@ -361,17 +382,6 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     LV_ASSERT_MEM_INTEGRITY();
 }
 
-void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
-                    uint32_t letter)
-{
-    draw_ctx->draw_letter(draw_ctx, dsc, pos_p, letter);
-}
-
-
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
 /**
  * Convert a hexadecimal characters to a number (0..15)
  * @param hex Pointer to a hexadecimal character (0..9, A..F)
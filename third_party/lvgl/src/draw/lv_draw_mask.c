@@ -12,12 +12,11 @@
 #include "../misc/lv_log.h"
 #include "../misc/lv_assert.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
  *********************/
-#define CIRCLE_CACHE_LIFE_MAX   1000
-#define CIRCLE_CACHE_AGING(life, r)   life = LV_MIN(life + (r < 16 ? 1 : (r >> 4)), 1000)
 
 /**********************
  *      TYPEDEFS
@@ -56,6 +55,8 @@ static void circ_init(lv_point_t * c, lv_coord_t * tmp, lv_coord_t radius);
 static bool circ_cont(lv_point_t * c);
 static void circ_next(lv_point_t * c, lv_coord_t * tmp);
 static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radius);
+static void circle_cache_resize(_lv_draw_mask_circle_cache_t * cache);
+static void circle_cache_free(_lv_draw_mask_circle_cache_t * cache);
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start);
 static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
@@ -63,6 +64,8 @@ static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, l
 /**********************
  *  STATIC VARIABLES
  **********************/
+static uint32_t circle_cache_size = LV_CIRCLE_CACHE_SIZE;
+static lv_draw_mask_circle_cache_stats_t circle_cache_stats;
 
 /**********************
  *      MACROS
@@ -214,7 +217,7 @@ void lv_draw_mask_free_param(void * p)
     if(pdsc->type == LV_DRAW_MASK_TYPE_RADIUS) {
         lv_draw_mask_radius_param_t * radius_p = (lv_draw_mask_radius_param_t *) p;
         if(radius_p->circle) {
-            if(radius_p->circle->life < 0) {
+            if(radius_p->circle->temp) {
                 lv_mem_free(radius_p->circle->cir_opa);
                 lv_mem_free(radius_p->circle);
             }
@@ -231,13 +234,27 @@ void lv_draw_mask_free_param(void * p)
 
 void _lv_draw_mask_cleanup(void)
 {
-    uint8_t i;
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).buf) {
-            lv_mem_free(LV_GC_ROOT(_lv_circle_cache[i]).buf);
-        }
-        lv_memset_00(&LV_GC_ROOT(_lv_circle_cache[i]), sizeof(LV_GC_ROOT(_lv_circle_cache[i])));
-    }
+    circle_cache_free(&LV_GC_ROOT(_lv_circle_cache));
+}
+
+void lv_draw_mask_set_circle_cache_size(uint32_t size)
+{
+    circle_cache_size = size;
+}
+
+uint32_t lv_draw_mask_get_circle_cache_size(void)
+{
+    return circle_cache_size;
+}
+
+void lv_draw_mask_get_circle_cache_stats(lv_draw_mask_circle_cache_stats_t * stats)
+{
+    *stats = circle_cache_stats;
+}
+
+void lv_draw_mask_reset_circle_cache_stats(void)
+{
+    lv_memset_00(&circle_cache_stats, sizeof(circle_cache_stats));
 }
 
 /**
@@ -491,37 +508,42 @@ void lv_draw_mask_radius_init(lv_draw_mask_radius_param_t * param, const lv_area
         return;
     }
 
-    uint32_t i;
+    _lv_draw_mask_circle_cache_t * cache = &LV_GC_ROOT(_lv_circle_cache);
+    circle_cache_resize(cache);
+    cache->use_stamp++;
 
     /*Try to reuse a circle cache entry*/
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).radius == radius) {
-            LV_GC_ROOT(_lv_circle_cache[i]).used_cnt++;
-            CIRCLE_CACHE_AGING(LV_GC_ROOT(_lv_circle_cache[i]).life, radius);
-            param->circle = &LV_GC_ROOT(_lv_circle_cache[i]);
+    uint32_t i;
+    for(i = 0; i < cache->entry_cnt; i++) {
+        if(cache->entries[i].buf && cache->entries[i].radius == radius) {
+            cache->entries[i].used_cnt++;
+            cache->entries[i].last_use = cache->use_stamp;
+            param->circle = &cache->entries[i];
+            lv_atomic_inc(&circle_cache_stats.hit);
             return;
         }
     }
 
-    /*If not found find a free entry with lowest life*/
+    /*If not found replace the least recently used free entry*/
     _lv_draw_mask_radius_circle_dsc_t * entry = NULL;
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).used_cnt == 0) {
-            if(!entry) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
-            else if(LV_GC_ROOT(_lv_circle_cache[i]).life < entry->life) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
+    for(i = 0; i < cache->entry_cnt; i++) {
+        if(cache->entries[i].used_cnt == 0) {
+            if(!entry || cache->entries[i].last_use < entry->last_use) entry = &cache->entries[i];
         }
     }
 
+    lv_atomic_inc(&circle_cache_stats.miss);
     if(!entry) {
         entry = lv_mem_alloc(sizeof(_lv_draw_mask_radius_circle_dsc_t));
         LV_ASSERT_MALLOC(entry);
         lv_memset_00(entry, sizeof(_lv_draw_mask_radius_circle_dsc_t));
-        entry->life = -1;
+        entry->temp = 1;
+        lv_atomic_inc(&circle_cache_stats.uncached);
     }
     else {
+        if(entry->buf) lv_atomic_inc(&circle_cache_stats.evict);
         entry->used_cnt++;
-        entry->life = 0;
-        CIRCLE_CACHE_AGING(entry->life, radius);
+        entry->last_use = cache->use_stamp;
     }
 
     param->circle = entry;
@@ -1510,6 +1532,42 @@ static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radi
     lv_mem_buf_release(cir_x);
 }
 
+/**
+ * Reallocate the circle cache if its size was changed and no mask uses it
+ * @param cache     the circle cache of the calling thread
+ */
+static void circle_cache_resize(_lv_draw_mask_circle_cache_t * cache)
+{
+    if(cache->size == circle_cache_size) return;
+
+    uint32_t i;
+    for(i = 0; i < cache->entry_cnt; i++) {
+        if(cache->entries[i].used_cnt) return;
+    }
+
+    circle_cache_free(cache);
+    cache->size = circle_cache_size;
+    if(cache->size == 0) return;
+
+    cache->entries = lv_mem_alloc(cache->size * sizeof(_lv_draw_mask_radius_circle_dsc_t));
+    if(cache->entries == NULL) {
+        LV_LOG_WARN("Not enough memory for %d cached circles", (int)cache->size);
+        return;
+    }
+    lv_memset_00(cache->entries, cache->size * sizeof(_lv_draw_mask_radius_circle_dsc_t));
+    cache->entry_cnt = cache->size;
+}
+
+static void circle_cache_free(_lv_draw_mask_circle_cache_t * cache)
+{
+    uint32_t i;
+    for(i = 0; i < cache->entry_cnt; i++) {
+        if(cache->entries[i].buf) lv_mem_free(cache->entries[i].buf);
+    }
+    if(cache->entries) lv_mem_free(cache->entries);
+    lv_memset_00(cache, sizeof(_lv_draw_mask_circle_cache_t));
+}
+
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start)
 {
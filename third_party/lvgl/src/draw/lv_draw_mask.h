@@ -158,12 +158,29 @@ typedef struct  {
     lv_opa_t * cir_opa;         /*Opacity of values on the circumference of an 1/4 circle*/
     uint16_t * x_start_on_y;        /*The x coordinate of the circle for each y value*/
     uint16_t * opa_start_on_y;      /*The index of `cir_opa` for each y value*/
-    int32_t life;               /*How many times the entry way used*/
+    uint32_t last_use;          /*Use stamp of the last use, the least recently used entry is replaced*/
     uint32_t used_cnt;          /*Like a semaphore to count the referencing masks*/
     lv_coord_t radius;          /*The radius of the entry*/
+    uint8_t temp : 1;           /*Not in the cache, freed with the mask*/
 } _lv_draw_mask_radius_circle_dsc_t;
 
-typedef _lv_draw_mask_radius_circle_dsc_t _lv_draw_mask_radius_circle_dsc_arr_t[LV_CIRCLE_CACHE_SIZE];
+/*Circles of the radius masks, kept between the refreshes. Every drawing thread has its own.*/
+typedef struct {
+    _lv_draw_mask_radius_circle_dsc_t * entries;
+    uint32_t entry_cnt;         /*Number of allocated entries*/
+    uint32_t size;              /*The cache size it was allocated for*/
+    uint32_t use_stamp;         /*Increased on every use*/
+} _lv_draw_mask_circle_cache_t;
+
+/**
+ * Statistics of the circle cache of the radius masks, summed for all drawing threads
+ */
+typedef struct {
+    uint32_t hit;               /**< A cached circle was used*/
+    uint32_t miss;              /**< A circle had to be calculated*/
+    uint32_t evict;             /**< A cached circle was replaced by an other*/
+    uint32_t uncached;          /**< All entries were in use, the circle was calculated just for one mask*/
+} lv_draw_mask_circle_cache_stats_t;
 
 typedef struct {
     /*The first element must be the common descriptor*/
@@ -289,11 +306,35 @@ void * lv_draw_mask_remove_custom(void * custom_id);
 void lv_draw_mask_free_param(void * p);
 
 /**
- * Called by LVGL the rendering of a screen is ready to clean up
- * the temporal (cache) data of the masks
+ * Free the circle cache of the radius masks of the calling thread
  */
 void _lv_draw_mask_cleanup(void);
 
+/**
+ * Set how many circles of radius masks can be cached.
+ * The circles are kept between the refreshes and the least recently used one is replaced.
+ * A circle takes `radius * 6 + 6` bytes. The new size is applied when no mask uses the cache.
+ * @param size      number of cached circles per drawing thread (default: `LV_CIRCLE_CACHE_SIZE`)
+ */
+void lv_draw_mask_set_circle_cache_size(uint32_t size);
+
+/**
+ * Get the number of circles which can be cached
+ * @return          number of cached circles per drawing thread
+ */
+uint32_t lv_draw_mask_get_circle_cache_size(void);
+
+/**
+ * Get the statistics of the circle cache since the start or the last reset
+ * @param stats     store the statistics here
+ */
+void lv_draw_mask_get_circle_cache_stats(lv_draw_mask_circle_cache_stats_t * stats);
+
+/**
+ * Reset the statistics of the circle cache
+ */
+void lv_draw_mask_reset_circle_cache_stats(void);
+
 //! @cond Doxygen_Suppress
 
 /**
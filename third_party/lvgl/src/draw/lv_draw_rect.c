@@ -9,6 +9,7 @@
 #include "lv_draw.h"
 #include "lv_draw_rect.h"
 #include "../misc/lv_assert.h"
+#include "../misc/lv_trace.h"
 
 /*********************
  *      DEFINES
@@ -63,7 +64,9 @@ void lv_draw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, cons
 {
     if(lv_area_get_height(coords) < 1 || lv_area_get_width(coords) < 1) return;
 
+    LV_TRACE_BEGIN("lv_draw_rect");
     draw_ctx->draw_rect(draw_ctx, dsc, coords);
+    LV_TRACE_END("lv_draw_rect");
 
     LV_ASSERT_MEM_INTEGRITY();
 }
@@ -7,9 +7,11 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_blend_neon.h"
 #include "../../misc/lv_math.h"
 #include "../../hal/lv_hal_disp.h"
 #include "../../core/lv_refr.h"
+#include "../../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -254,6 +256,17 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
     int32_t x;
     int32_t y;
 
+#if LV_DRAW_SW_BLEND_NEON
+    if(mask) {
+        lv_draw_sw_blend_neon_fill_mask(dest_buf, dest_stride, w, h, color, opa, mask, mask_stride);
+        return;
+    }
+    else if(opa >= LV_OPA_MAX) {
+        lv_draw_sw_blend_neon_fill(dest_buf, dest_stride, w, h, color);
+        return;
+    }
+#endif
+
     /*No mask*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
@@ -275,6 +288,11 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
             opa = opa << 3;
 #endif
 
+#if LV_DRAW_SW_BLEND_NEON
+            lv_draw_sw_blend_neon_fill_opa(dest_buf, dest_stride, w, h, color, opa);
+            return;
+#endif
+
             uint16_t color_premult[3];
             lv_color_premult(color, opa, color_premult);
             lv_opa_t opa_inv = 255 - opa;
@@ -409,10 +427,10 @@ static inline void set_px_argb(uint8_t * buf, lv_color_t color, lv_opa_t opa)
 static inline void set_px_argb_blend(uint8_t * buf, lv_color_t color, lv_opa_t opa, lv_color_t (*blend_fp)(lv_color_t,
                                                                                                            lv_color_t, lv_opa_t))
 {
-    static lv_color_t last_dest_color;
-    static lv_color_t last_src_color;
-    static lv_color_t last_res_color;
-    static uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
+    static LV_THREAD_LOCAL lv_color_t last_dest_color;
+    static LV_THREAD_LOCAL lv_color_t last_src_color;
+    static LV_THREAD_LOCAL lv_color_t last_res_color;
+    static LV_THREAD_LOCAL uint32_t last_opa = 0xffff; /*Set to an invalid value for first*/
 
     lv_color_t bg_color;
 
@@ -655,6 +673,13 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
     int32_t x;
     int32_t y;
 
+#if LV_DRAW_SW_BLEND_NEON
+    if(mask || opa < LV_OPA_MAX) {
+        lv_draw_sw_blend_neon_map(dest_buf, dest_stride, w, h, src_buf, src_stride, opa, mask, mask_stride);
+        return;
+    }
+#endif
+
     /*Simple fill (maybe with opacity), no masking*/
     if(mask == NULL) {
         if(opa >= LV_OPA_MAX) {
@@ -0,0 +1,242 @@
+/**
+ * @file lv_draw_sw_blend_neon.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_neon.h"
+
+#if LV_DRAW_SW_BLEND_NEON
+
+#include <arm_neon.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*RGB565 with G moved to the upper half-word. `lv_color_mix` mixes the 3 channels with one multiply in this layout*/
+#define SPREAD_MASK 0x07E0F81FU
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static inline uint16x8_t mix_x8(uint16x8_t fg, uint16x8_t bg, uint8x8_t opa);
+static inline uint16x4_t mix_x4(uint16x4_t fg, uint16x4_t bg, uint16x4_t mix);
+static inline uint16x8_t udiv255_x8(uint16x8_t x);
+static inline bool all_zero(uint8x8_t v);
+static inline bool all_cover(uint8x8_t v);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_sw_blend_neon_fill(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                lv_color_t color)
+{
+    uint16x8_t c = vdupq_n_u16(color.full);
+    int32_t x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        uint16_t * d = (uint16_t *)dest_buf;
+        for(x = 0; x <= w - 32; x += 32) {
+            vst1q_u16(d + x, c);
+            vst1q_u16(d + x + 8, c);
+            vst1q_u16(d + x + 16, c);
+            vst1q_u16(d + x + 24, c);
+        }
+        for(; x <= w - 8; x += 8) {
+            vst1q_u16(d + x, c);
+        }
+        for(; x < w; x++) {
+            d[x] = color.full;
+        }
+        dest_buf += dest_stride;
+    }
+}
+
+void lv_draw_sw_blend_neon_fill_opa(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                    lv_color_t color, lv_opa_t opa)
+{
+    /*Per channel: (fg * opa + bg * (255 - opa)) / 255, as `lv_color_mix_premult` does it*/
+    uint16_t color_premult[3];
+    lv_color_premult(color, opa, color_premult);
+    lv_opa_t opa_inv = 255 - opa;
+
+    uint16x8_t pre_r = vdupq_n_u16(color_premult[0]);
+    uint16x8_t pre_g = vdupq_n_u16(color_premult[1]);
+    uint16x8_t pre_b = vdupq_n_u16(color_premult[2]);
+    uint16x8_t mask_g = vdupq_n_u16(0x3F);
+    uint16x8_t mask_rb = vdupq_n_u16(0x1F);
+
+    int32_t x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        uint16_t * d = (uint16_t *)dest_buf;
+        for(x = 0; x <= w - 8; x += 8) {
+            uint16x8_t px = vld1q_u16(d + x);
+            uint16x8_t r = vshrq_n_u16(px, 11);
+            uint16x8_t g = vandq_u16(vshrq_n_u16(px, 5), mask_g);
+            uint16x8_t b = vandq_u16(px, mask_rb);
+            r = udiv255_x8(vmlaq_n_u16(pre_r, r, opa_inv));
+            g = udiv255_x8(vmlaq_n_u16(pre_g, g, opa_inv));
+            b = udiv255_x8(vmlaq_n_u16(pre_b, b, opa_inv));
+            vst1q_u16(d + x, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+        }
+        for(; x < w; x++) {
+            dest_buf[x] = lv_color_mix_premult(color_premult, dest_buf[x], opa_inv);
+        }
+        dest_buf += dest_stride;
+    }
+}
+
+void lv_draw_sw_blend_neon_fill_mask(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                     lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    uint16x8_t c = vdupq_n_u16(color.full);
+    uint8x8_t opa8 = vdup_n_u8(opa);
+    uint8x8_t cover8 = vdup_n_u8(LV_OPA_COVER);
+    bool only_mask = opa >= LV_OPA_MAX;
+
+    int32_t x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        uint16_t * d = (uint16_t *)dest_buf;
+        for(x = 0; x <= w - 8; x += 8) {
+            uint8x8_t m = vld1_u8(mask + x);
+            if(all_zero(m)) continue;
+            if(only_mask) {
+                if(all_cover(m)) {
+                    vst1q_u16(d + x, c);
+                    continue;
+                }
+            }
+            else {
+                /*A fully covering mask keeps `opa`, the rest is scaled by it*/
+                uint8x8_t scaled = vshrn_n_u16(vmull_u8(m, opa8), 8);
+                m = vbsl_u8(vceq_u8(m, cover8), opa8, scaled);
+            }
+            vst1q_u16(d + x, mix_x8(c, vld1q_u16(d + x), m));
+        }
+        for(; x < w; x++) {
+            if(mask[x] == LV_OPA_TRANSP) continue;
+            lv_opa_t opa_tmp;
+            if(only_mask) opa_tmp = mask[x];
+            else opa_tmp = mask[x] == LV_OPA_COVER ? opa : (uint32_t)((uint32_t)mask[x] * opa) >> 8;
+            dest_buf[x] = lv_color_mix(color, dest_buf[x], opa_tmp);
+        }
+        dest_buf += dest_stride;
+        mask += mask_stride;
+    }
+}
+
+void lv_draw_sw_blend_neon_map(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                               const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                               const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    uint8x8_t opa8 = vdup_n_u8(opa);
+    uint8x8_t max8 = vdup_n_u8(LV_OPA_MAX);
+    /*Note the `>`: it is what `map_normal` uses to ignore `opa`*/
+    bool only_mask = opa > LV_OPA_MAX;
+
+    int32_t x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        uint16_t * d = (uint16_t *)dest_buf;
+        const uint16_t * s = (const uint16_t *)src_buf;
+        for(x = 0; x <= w - 8; x += 8) {
+            uint8x8_t m;
+            if(mask == NULL) {
+                m = opa8;
+            }
+            else {
+                m = vld1_u8(mask + x);
+                if(all_zero(m)) continue;
+                if(only_mask) {
+                    if(all_cover(m)) {
+                        vst1q_u16(d + x, vld1q_u16(s + x));
+                        continue;
+                    }
+                }
+                else {
+                    uint8x8_t scaled = vshrn_n_u16(vmull_u8(m, opa8), 8);
+                    m = vbsl_u8(vcge_u8(m, max8), opa8, scaled);
+                }
+            }
+            vst1q_u16(d + x, mix_x8(vld1q_u16(s + x), vld1q_u16(d + x), m));
+        }
+        for(; x < w; x++) {
+            lv_opa_t opa_tmp;
+            if(mask == NULL) {
+                opa_tmp = opa;
+            }
+            else {
+                if(mask[x] == LV_OPA_TRANSP) continue;
+                if(only_mask) opa_tmp = mask[x];
+                else opa_tmp = mask[x] >= LV_OPA_MAX ? opa : ((opa * mask[x]) >> 8);
+            }
+            dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa_tmp);
+        }
+        dest_buf += dest_stride;
+        src_buf += src_stride;
+        if(mask) mask += mask_stride;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * `lv_color_mix(fg, bg, opa)` on 8 pixels.
+ * A mix of 0 keeps `bg` and 255 gives `fg`, so masked out pixels need no special care.
+ */
+static inline uint16x8_t mix_x8(uint16x8_t fg, uint16x8_t bg, uint8x8_t opa)
+{
+    /*`lv_color_mix` works with 5 bit precision: (opa + 4) >> 3*/
+    uint16x8_t mix = vshrq_n_u16(vaddw_u8(vdupq_n_u16(4), opa), 3);
+    uint16x4_t lo = mix_x4(vget_low_u16(fg), vget_low_u16(bg), vget_low_u16(mix));
+    uint16x4_t hi = mix_x4(vget_high_u16(fg), vget_high_u16(bg), vget_high_u16(mix));
+    return vcombine_u16(lo, hi);
+}
+
+/**
+ * The 16 bpp `lv_color_mix` on 4 pixels, keeping its exact 32 bit arithmetic
+ * (including the borrows between the channels) so the result matches the C path.
+ */
+static inline uint16x4_t mix_x4(uint16x4_t fg, uint16x4_t bg, uint16x4_t mix)
+{
+    uint32x4_t spread = vdupq_n_u32(SPREAD_MASK);
+    uint32x4_t f = vmovl_u16(fg);
+    uint32x4_t b = vmovl_u16(bg);
+    f = vandq_u32(vorrq_u32(f, vshlq_n_u32(f, 16)), spread);
+    b = vandq_u32(vorrq_u32(b, vshlq_n_u32(b, 16)), spread);
+    uint32x4_t res = vmulq_u32(vsubq_u32(f, b), vmovl_u16(mix));
+    res = vandq_u32(vaddq_u32(vshrq_n_u32(res, 5), b), spread);
+    return vmovn_u32(vorrq_u32(res, vshrq_n_u32(res, 16)));
+}
+
+/**
+ * `LV_UDIV255` in 16 bits: (x + 1 + (x >> 8)) >> 8 matches it for every x < 0xFFFF
+ * and `lv_color_mix_premult` never goes above 63 * 255.
+ */
+static inline uint16x8_t udiv255_x8(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+static inline bool all_zero(uint8x8_t v)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(v), 0) == 0;
+}
+
+static inline bool all_cover(uint8x8_t v)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(v), 0) == UINT64_MAX;
+}
+
+#endif /*LV_DRAW_SW_BLEND_NEON*/
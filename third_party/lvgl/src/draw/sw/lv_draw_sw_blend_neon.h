@@ -0,0 +1,102 @@
+/**
+ * @file lv_draw_sw_blend_neon.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_BLEND_NEON_H
+#define LV_DRAW_SW_BLEND_NEON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include "../../misc/lv_color.h"
+#include "../../misc/lv_area.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*The kernels reproduce the 16 bpp `lv_color_mix` bit by bit, so they are used only with that exact format*/
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_NEON && LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0 && \
+    LV_COLOR_MIX_ROUND_OFS == 0
+#define LV_DRAW_SW_BLEND_NEON 1
+#else
+#define LV_DRAW_SW_BLEND_NEON 0
+#endif
+
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_NEON && !defined(__ARM_NEON)
+#error "LV_USE_DRAW_SW_ASM is LV_DRAW_SW_ASM_NEON but the compiler does not target NEON"
+#endif
+
+#if LV_DRAW_SW_BLEND_NEON
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Fill an area with a color. The same as `lv_color_fill` row by row.
+ * @param dest_buf      pointer to the first pixel of the area
+ * @param dest_stride   width of the destination buffer in pixels
+ * @param w             width of the area
+ * @param h             height of the area
+ * @param color         fill color
+ */
+void lv_draw_sw_blend_neon_fill(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                lv_color_t color);
+
+/**
+ * Fill an area with a color and an opacity < `LV_OPA_MAX`, without a mask.
+ * @param dest_buf      pointer to the first pixel of the area
+ * @param dest_stride   width of the destination buffer in pixels
+ * @param w             width of the area
+ * @param h             height of the area
+ * @param color         fill color
+ * @param opa           opacity, already rounded the way `fill_normal` rounds it
+ */
+void lv_draw_sw_blend_neon_fill_opa(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                    lv_color_t color, lv_opa_t opa);
+
+/**
+ * Fill an area with a color through an opacity mask.
+ * @param dest_buf      pointer to the first pixel of the area
+ * @param dest_stride   width of the destination buffer in pixels
+ * @param w             width of the area
+ * @param h             height of the area
+ * @param color         fill color
+ * @param opa           overall opacity (>= `LV_OPA_MAX` means only the mask matters)
+ * @param mask          pointer to the first mask value of the area
+ * @param mask_stride   width of the mask buffer
+ */
+void lv_draw_sw_blend_neon_fill_mask(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                                     lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stride);
+
+/**
+ * Blend an image onto an area with an opacity and/or an opacity mask.
+ * A plain copy (no mask, `opa >= LV_OPA_MAX`) is left to `lv_memcpy`.
+ * @param dest_buf      pointer to the first pixel of the area
+ * @param dest_stride   width of the destination buffer in pixels
+ * @param w             width of the area
+ * @param h             height of the area
+ * @param src_buf       pointer to the first source pixel
+ * @param src_stride    width of the source buffer in pixels
+ * @param opa           overall opacity
+ * @param mask          pointer to the first mask value of the area or NULL
+ * @param mask_stride   width of the mask buffer
+ */
+void lv_draw_sw_blend_neon_map(lv_color_t * dest_buf, lv_coord_t dest_stride, int32_t w, int32_t h,
+                               const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                               const lv_opa_t * mask, lv_coord_t mask_stride);
+
+#endif /*LV_DRAW_SW_BLEND_NEON*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_NEON_H*/
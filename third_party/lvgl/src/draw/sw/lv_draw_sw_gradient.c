@@ -9,6 +9,7 @@
 #include "lv_draw_sw_gradient.h"
 #include "../../misc/lv_gc.h"
 #include "../../misc/lv_types.h"
+#include "../../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -51,8 +52,9 @@ static  uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h
 /**********************
  *   STATIC VARIABLE
  **********************/
-static size_t    grad_cache_size = 0;
-static uint8_t * grad_cache_end = 0;
+/*Every drawing thread has its own cache (see `_lv_grad_cache_mem` in lv_gc.h)*/
+static LV_THREAD_LOCAL size_t    grad_cache_size = 0;
+static LV_THREAD_LOCAL uint8_t * grad_cache_end = 0;
 
 /**********************
  *   STATIC FUNCTIONS
@@ -254,7 +256,7 @@ lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
     if(g->dir == LV_GRAD_DIR_NONE) return NULL;
 
     /* Step 0: Check if the cache exist (else create it) */
-    static bool inited = false;
+    static LV_THREAD_LOCAL bool inited = false;
     if(!inited) {
         lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
         inited = true;
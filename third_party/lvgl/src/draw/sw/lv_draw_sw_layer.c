@@ -54,12 +54,12 @@ struct _lv_draw_layer_ctx_t * lv_draw_sw_layer_create(struct _lv_draw_ctx_t * dr
         layer_sw_ctx->buf_size_bytes = LV_LAYER_SIMPLE_BUF_SIZE;
         uint32_t full_size = lv_area_get_size(&layer_sw_ctx->base_draw.area_full) * px_size;
         if(layer_sw_ctx->buf_size_bytes > full_size) layer_sw_ctx->buf_size_bytes = full_size;
-        layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+        layer_sw_ctx->base_draw.buf = lv_mem_frame_alloc(layer_sw_ctx->buf_size_bytes);
         if(layer_sw_ctx->base_draw.buf == NULL) {
             LV_LOG_WARN("Cannot allocate %"LV_PRIu32" bytes for layer buffer. Allocating %"LV_PRIu32" bytes instead. (Reduced performance)",
                         (uint32_t)layer_sw_ctx->buf_size_bytes, (uint32_t)LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE * px_size);
             layer_sw_ctx->buf_size_bytes = LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE;
-            layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+            layer_sw_ctx->base_draw.buf = lv_mem_frame_alloc(layer_sw_ctx->buf_size_bytes);
             if(layer_sw_ctx->base_draw.buf == NULL) {
                 return NULL;
             }
@@ -73,7 +73,7 @@ struct _lv_draw_layer_ctx_t * lv_draw_sw_layer_create(struct _lv_draw_ctx_t * dr
     else {
         layer_sw_ctx->base_draw.area_act = layer_sw_ctx->base_draw.area_full;
         layer_sw_ctx->buf_size_bytes = lv_area_get_size(&layer_sw_ctx->base_draw.area_full) * px_size;
-        layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+        layer_sw_ctx->base_draw.buf = lv_mem_frame_alloc(layer_sw_ctx->buf_size_bytes);
         lv_memset_00(layer_sw_ctx->base_draw.buf, layer_sw_ctx->buf_size_bytes);
         layer_sw_ctx->has_alpha = flags & LV_DRAW_LAYER_FLAG_HAS_ALPHA ? 1 : 0;
         if(layer_sw_ctx->base_draw.buf == NULL) {
@@ -141,7 +141,7 @@ void lv_draw_sw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * la
 {
     LV_UNUSED(draw_ctx);
 
-    lv_mem_free(layer_ctx->buf);
+    lv_mem_frame_free(layer_ctx->buf);
 }
 
 
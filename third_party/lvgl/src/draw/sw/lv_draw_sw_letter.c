@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_blend_neon.h"
 #include "../../hal/lv_hal_disp.h"
 #include "../../misc/lv_math.h"
 #include "../../misc/lv_assert.h"
@@ -14,10 +15,13 @@
 #include "../../misc/lv_style.h"
 #include "../../font/lv_font.h"
 #include "../../core/lv_refr.h"
+#include "../../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
  *********************/
+/*Pixels of a 4 bpp glyph row expanded to opacities at once by `draw_letter_direct`*/
+#define DIRECT_OPA_BUF_SIZE 64
 
 /**********************
  *      TYPEDEFS
@@ -29,7 +33,9 @@
 
 static void /* LV_ATTRIBUTE_FAST_MEM */ draw_letter_normal(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
                                                            const lv_point_t * pos, lv_font_glyph_dsc_t * g, const uint8_t * map_p);
-
+static bool draw_letter_direct(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
+                               const uint8_t * map_p, uint32_t bpp, int32_t box_w,
+                               int32_t col_start, int32_t col_end, int32_t row_start, int32_t row_end);
 
 #if LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX
 static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
@@ -218,9 +224,9 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
             return; /*Invalid bpp. Can't render the letter*/
     }
 
-    static lv_opa_t opa_table[256];
-    static lv_opa_t prev_opa = LV_OPA_TRANSP;
-    static uint32_t prev_bpp = 0;
+    static LV_THREAD_LOCAL lv_opa_t opa_table[256];
+    static LV_THREAD_LOCAL lv_opa_t prev_opa = LV_OPA_TRANSP;
+    static LV_THREAD_LOCAL uint32_t prev_bpp = 0;
     if(opa < LV_OPA_MAX) {
         if(prev_opa != opa || prev_bpp != bpp) {
             uint32_t i;
@@ -244,6 +250,8 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     int32_t row_start = pos->y >= draw_ctx->clip_area->y1 ? 0 : draw_ctx->clip_area->y1 - pos->y;
     int32_t row_end   = pos->y + box_h <= draw_ctx->clip_area->y2 ? box_h : draw_ctx->clip_area->y2 - pos->y + 1;
 
+    if(draw_letter_direct(draw_ctx, dsc, pos, map_p, bpp, box_w, col_start, col_end, row_start, row_end)) return;
+
     /*Move on the map too*/
     uint32_t bit_ofs = (row_start * width_bit) + (col_start * bpp);
     map_p += bit_ofs >> 3;
@@ -351,6 +359,112 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     lv_mem_buf_release(mask_buf);
 }
 
+/**
+ * Draw a 1 or 4 bpp letter by writing the color directly into the draw buffer,
+ * without expanding it into a mask and going through `lv_draw_sw_blend`.
+ * Used only in the plain case (full opacity, normal blending, no masks, simple buffer)
+ * where it gives exactly the same pixels as the generic path.
+ * @return true if the letter was drawn; false if the generic path has to draw it
+ */
+static bool LV_ATTRIBUTE_FAST_MEM draw_letter_direct(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                                                     const lv_point_t * pos, const uint8_t * map_p, uint32_t bpp, int32_t box_w,
+                                                     int32_t col_start, int32_t col_end, int32_t row_start, int32_t row_end)
+{
+    if(bpp != 1 && bpp != 4) return false;
+    if(dsc->opa < LV_OPA_MAX || dsc->blend_mode != LV_BLEND_MODE_NORMAL) return false;
+    if(((lv_draw_sw_ctx_t *)draw_ctx)->blend != lv_draw_sw_blend_basic) return false;
+
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp->driver->set_px_cb || disp->driver->screen_transp) return false;
+    /*Without anti-aliasing the blender rounds the mask to 0 or 255*/
+    if(bpp != 1 && disp->driver->antialiasing == 0) return false;
+
+    if(col_start >= col_end || row_start >= row_end) return true;
+
+    lv_area_t area;
+    area.x1 = pos->x + col_start;
+    area.x2 = pos->x + col_end - 1;
+    area.y1 = pos->y + row_start;
+    area.y2 = pos->y + row_end - 1;
+    if(lv_draw_mask_is_any(&area)) return false;
+
+    if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
+
+    lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    lv_color_t * dest_buf = draw_ctx->buf;
+    dest_buf += dest_stride * (area.y1 - draw_ctx->buf_area->y1) + (area.x1 - draw_ctx->buf_area->x1);
+
+    lv_color_t color = dsc->color;
+    int32_t w = col_end - col_start;
+    uint32_t width_bit = box_w * bpp;
+    uint32_t bit_ofs = row_start * width_bit + col_start * bpp;
+    int32_t row;
+    int32_t x;
+
+    if(bpp == 1) {
+        for(row = row_start; row < row_end; row++) {
+            const uint8_t * p = map_p + (bit_ofs >> 3);
+            uint32_t shift = bit_ofs & 0x7;
+            for(x = 0; x < w; x += 8) {
+                /*The next 8 pixels, the leftmost in the MSB. Read the next byte only if they reach into it*/
+                uint32_t bits = (uint32_t)p[0] << 8;
+                if(shift && w - x > (int32_t)(8 - shift)) bits |= p[1];
+                bits = ((bits << shift) >> 8) & 0xFF;
+                if(w - x < 8) bits &= (0xFF << (8 - (w - x))) & 0xFF;
+                p++;
+
+                lv_color_t * d = dest_buf + x;
+                if(bits == 0xFF) {
+                    d[0] = color; d[1] = color; d[2] = color; d[3] = color;
+                    d[4] = color; d[5] = color; d[6] = color; d[7] = color;
+                }
+                else {
+                    for(; bits; bits = (bits << 1) & 0xFF, d++) {
+                        if(bits & 0x80) *d = color;
+                    }
+                }
+            }
+            dest_buf += dest_stride;
+            bit_ofs += width_bit;
+        }
+        return true;
+    }
+
+    /*4 bpp: expand a part of the row to opacities then blend it like `fill_normal` does with a mask*/
+    lv_opa_t opa_buf[DIRECT_OPA_BUF_SIZE];
+    for(row = row_start; row < row_end; row++) {
+        const uint8_t * p = map_p + (bit_ofs >> 3);
+        bool high = (bit_ofs & 0x7) == 0;
+        for(x = 0; x < w; x += DIRECT_OPA_BUF_SIZE) {
+            int32_t n = LV_MIN(w - x, DIRECT_OPA_BUF_SIZE);
+            int32_t i;
+            for(i = 0; i < n; i++) {
+                if(high) {
+                    opa_buf[i] = _lv_bpp4_opa_table[*p >> 4];
+                }
+                else {
+                    opa_buf[i] = _lv_bpp4_opa_table[*p & 0xF];
+                    p++;
+                }
+                high = !high;
+            }
+
+#if LV_DRAW_SW_BLEND_NEON
+            lv_draw_sw_blend_neon_fill_mask(dest_buf + x, dest_stride, n, 1, color, LV_OPA_COVER, opa_buf, n);
+#else
+            lv_color_t * d = dest_buf + x;
+            for(i = 0; i < n; i++) {
+                if(opa_buf[i] == LV_OPA_COVER) d[i] = color;
+                else if(opa_buf[i]) d[i] = lv_color_mix(color, d[i], opa_buf[i]);
+            }
+#endif
+        }
+        dest_buf += dest_stride;
+        bit_ofs += width_bit;
+    }
+    return true;
+}
+
 #if LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX
 static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
                               lv_font_glyph_dsc_t * g, const uint8_t * map_p)
@@ -11,6 +11,7 @@
 #include "../../misc/lv_txt_ap.h"
 #include "../../core/lv_refr.h"
 #include "../../misc/lv_assert.h"
+#include "../../misc/lv_thread.h"
 #include "lv_draw_sw_dither.h"
 
 /*********************
@@ -19,6 +20,7 @@
 #define SHADOW_UPSCALE_SHIFT    6
 #define SHADOW_ENHANCE          1
 #define SPLIT_LIMIT             50
+#define SMALL_RADIUS_MAX        2   /*Up to this radius the corners of the background are set without masks*/
 
 
 /**********************
@@ -30,6 +32,10 @@
  **********************/
 static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
 static void draw_bg_img(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
+#if LV_DRAW_COMPLEX
+static void small_radius_line(lv_opa_t * mask_buf, lv_opa_t opa, int32_t rout, int32_t line,
+                              const lv_area_t * bg_coords, lv_coord_t x1, int32_t len);
+#endif
 static void draw_border(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
 
 static void draw_outline(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
@@ -53,9 +59,9 @@ static void draw_border_simple(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer
  *  STATIC VARIABLES
  **********************/
 #if defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
+    static LV_THREAD_LOCAL uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
+    static LV_THREAD_LOCAL int32_t sh_cache_size = -1;
+    static LV_THREAD_LOCAL int32_t sh_cache_r = -1;
 #endif
 
 /**********************
@@ -144,15 +150,19 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
     int32_t short_side = LV_MIN(coords_bg_w, coords_bg_h);
     int32_t rout = LV_MIN(dsc->radius, short_side >> 1);
 
-    /*Add a radius mask if there is radius*/
+    /*Add a radius mask if there is radius. A small radius changes only a few pixels
+     *of the first and last lines so those are set directly.*/
     int32_t clipped_w = lv_area_get_width(&clipped_coords);
     int16_t mask_rout_id = LV_MASK_ID_INV;
     lv_opa_t * mask_buf = NULL;
     lv_draw_mask_radius_param_t mask_rout_param;
+    bool small_radius = !mask_any && rout <= SMALL_RADIUS_MAX;
     if(rout > 0 || mask_any) {
         mask_buf = lv_mem_buf_get(clipped_w);
-        lv_draw_mask_radius_init(&mask_rout_param, &bg_coords, rout, false);
-        mask_rout_id = lv_draw_mask_add(&mask_rout_param, NULL);
+        if(!small_radius) {
+            lv_draw_mask_radius_init(&mask_rout_param, &bg_coords, rout, false);
+            mask_rout_id = lv_draw_mask_add(&mask_rout_param, NULL);
+        }
     }
 
     int32_t h;
@@ -247,9 +257,15 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
 
         /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
          * It saves calculating the final opa in lv_draw_sw_blend*/
-        lv_memset(mask_buf, opa, clipped_w);
-        blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, blend_area.x1, top_y, clipped_w);
-        if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        if(small_radius) {
+            small_radius_line(mask_buf, opa, rout, h, &bg_coords, blend_area.x1, clipped_w);
+            blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        }
+        else {
+            lv_memset(mask_buf, opa, clipped_w);
+            blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, blend_area.x1, top_y, clipped_w);
+            if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        }
 
         if(top_y >= clipped_coords.y1) {
             blend_area.y1 = top_y;
@@ -327,6 +343,42 @@ bg_clean_up:
 #endif
 }
 
+#if LV_DRAW_COMPLEX
+/**
+ * Set the mask of a line of a rectangle with small radius the same way as the radius mask would
+ * @param mask_buf      the mask of the line, `len` long
+ * @param opa           opacity of the rectangle
+ * @param rout          radius of the rectangle, 1..SMALL_RADIUS_MAX
+ * @param line          index of the line from the top or bottom edge, 0..rout - 1
+ * @param bg_coords     coordinates of the rectangle
+ * @param x1            the x coordinate of the first pixel of `mask_buf`
+ * @param len           length of `mask_buf`
+ */
+static void small_radius_line(lv_opa_t * mask_buf, lv_opa_t opa, int32_t rout, int32_t line,
+                              const lv_area_t * bg_coords, lv_coord_t x1, int32_t len)
+{
+    /*Opacity of the anti-aliased circle in a corner: [radius - 1][line][x from the edge]*/
+    static const lv_opa_t corner_opa[SMALL_RADIUS_MAX][SMALL_RADIUS_MAX][SMALL_RADIUS_MAX] = {
+        {{180, 255}, {255, 255}},
+        {{80, 224}, {224, 255}},
+    };
+
+    lv_memset(mask_buf, opa, len);
+
+    int32_t i;
+    for(i = 0; i < rout; i++) {
+        lv_opa_t c = corner_opa[rout - 1][line][i];
+        if(c >= LV_OPA_MAX) continue;
+        lv_opa_t m = LV_UDIV255(opa * c);
+
+        int32_t left = bg_coords->x1 + i - x1;
+        int32_t right = bg_coords->x2 - i - x1;
+        if(left >= 0 && left < len) mask_buf[left] = m;
+        if(right >= 0 && right < len) mask_buf[right] = m;
+    }
+}
+#endif
+
 static void draw_bg_img(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
 {
     if(dsc->bg_img_src == NULL) return;
@@ -14,6 +14,7 @@
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
 #include "../misc/lv_mem.h"
+#include "../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -50,14 +51,20 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
  *  STATIC VARIABLES
  **********************/
 #if LV_USE_FONT_COMPRESSED
-    static uint32_t rle_rdp;
-    static const uint8_t * rle_in;
-    static uint8_t rle_bpp;
-    static uint8_t rle_prev_v;
-    static uint8_t rle_cnt;
-    static rle_state_t rle_state;
+    static LV_THREAD_LOCAL uint32_t rle_rdp;
+    static LV_THREAD_LOCAL const uint8_t * rle_in;
+    static LV_THREAD_LOCAL uint8_t rle_bpp;
+    static LV_THREAD_LOCAL uint8_t rle_prev_v;
+    static LV_THREAD_LOCAL uint8_t rle_cnt;
+    static LV_THREAD_LOCAL rle_state_t rle_state;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_USE_REFR_THREADS
+    /*`fdsc->cache` is shared by the fonts' users so every drawing thread keeps its own last lookup*/
+    static LV_THREAD_LOCAL lv_font_fmt_txt_glyph_cache_t thread_cache;
+    static LV_THREAD_LOCAL const lv_font_fmt_txt_dsc_t * thread_cache_fdsc;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -92,7 +99,7 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     /*Handle compressed bitmap*/
     else {
 #if LV_USE_FONT_COMPRESSED
-        static size_t last_buf_size = 0;
+        static LV_THREAD_LOCAL size_t last_buf_size = 0;
         if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
 
         uint32_t gsize = gdsc->box_w * gdsc->box_h;
@@ -212,8 +219,19 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
+    lv_font_fmt_txt_glyph_cache_t * cache = fdsc->cache;
+#if LV_USE_REFR_THREADS
+    if(cache) {
+        if(thread_cache_fdsc != fdsc) {
+            thread_cache_fdsc = fdsc;
+            thread_cache.last_letter = 0;
+        }
+        cache = &thread_cache;
+    }
+#endif
+
     /*Check the cache first*/
-    if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
+    if(cache && letter == cache->last_letter) return cache->last_glyph_id;
 
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
@@ -252,16 +270,16 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
         }
 
         /*Update the cache*/
-        if(fdsc->cache) {
-            fdsc->cache->last_letter = letter;
-            fdsc->cache->last_glyph_id = glyph_id;
+        if(cache) {
+            cache->last_letter = letter;
+            cache->last_glyph_id = glyph_id;
         }
         return glyph_id;
     }
 
-    if(fdsc->cache) {
-        fdsc->cache->last_letter = letter;
-        fdsc->cache->last_glyph_id = 0;
+    if(cache) {
+        cache->last_letter = letter;
+        cache->last_glyph_id = 0;
     }
     return 0;
 
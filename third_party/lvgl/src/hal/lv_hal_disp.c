@@ -322,6 +322,9 @@ void lv_disp_remove(lv_disp_t * disp)
     if(disp->refr_timer) lv_timer_del(disp->refr_timer);
     lv_mem_free(disp);
 
+    /*Nothing left to draw: stop the drawing threads*/
+    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_disp_ll)) == NULL) _lv_refr_deinit();
+
     if(was_default) lv_disp_set_default(_lv_ll_get_head(&LV_GC_ROOT(_lv_disp_ll)));
 }
 
@@ -10,6 +10,10 @@
 
 #include <stdint.h>
 
+/*Values for LV_USE_DRAW_SW_ASM*/
+#define LV_DRAW_SW_ASM_NONE 0
+#define LV_DRAW_SW_ASM_NEON 1
+
 /* Handle special Kconfig options */
 #ifndef LV_KCONFIG_IGNORE
     #include "lv_conf_kconfig.h"
@@ -157,6 +161,25 @@
         #endif
     #endif
 
+    /*Add a pool of this size with `malloc` every time the memory runs out (at most 16). Not larger than `LV_MEM_SIZE`.*/
+    #ifndef LV_MEM_EXPAND_SIZE
+        #ifdef CONFIG_LV_MEM_EXPAND_SIZE
+            #define LV_MEM_EXPAND_SIZE CONFIG_LV_MEM_EXPAND_SIZE
+        #else
+            #define LV_MEM_EXPAND_SIZE 0    /*[bytes], 0: the memory has a fixed size*/
+        #endif
+    #endif
+
+    /*Allocate the small memories (<= 128 bytes) from size class slabs of this total size, next to `LV_MEM_SIZE`.
+     *Label texts, styles, timers and animations come and go often, in the slabs they can't fragment the pool.*/
+    #ifndef LV_MEM_SLAB_SIZE
+        #ifdef CONFIG_LV_MEM_SLAB_SIZE
+            #define LV_MEM_SLAB_SIZE CONFIG_LV_MEM_SLAB_SIZE
+        #else
+            #define LV_MEM_SLAB_SIZE 0      /*[bytes], 0: disable*/
+        #endif
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #ifndef LV_MEM_CUSTOM_INCLUDE
         #ifdef CONFIG_LV_MEM_CUSTOM_INCLUDE
@@ -198,6 +221,17 @@
     #endif
 #endif
 
+/*Size of the arena every drawing thread takes the intermediate buffers and the layers from while refreshing.
+ *The arena is emptied at the end of each refresh, `lv_mem_alloc()` is used if it's full.
+ *Size it by `lv_mem_frame_get_stats()`'s high water mark.*/
+#ifndef LV_MEM_FRAME_SIZE
+    #ifdef CONFIG_LV_MEM_FRAME_SIZE
+        #define LV_MEM_FRAME_SIZE CONFIG_LV_MEM_FRAME_SIZE
+    #else
+        #define LV_MEM_FRAME_SIZE 0     /*[bytes], 0: use LV_MEM_BUF_MAX_NUM buffers and `lv_mem_alloc()`*/
+    #endif
+#endif
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #ifndef LV_MEMCPY_MEMSET_STD
     #ifdef CONFIG_LV_MEMCPY_MEMSET_STD
@@ -304,7 +338,8 @@
 
     /* Set number of maximally cached circle data.
     * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    * radius * 6 bytes are used per circle (the least recently used one is replaced)
+    * Can be changed with `lv_draw_mask_set_circle_cache_size()`
     * 0: to disable caching */
     #ifndef LV_CIRCLE_CACHE_SIZE
         #ifdef CONFIG_LV_CIRCLE_CACHE_SIZE
@@ -412,6 +447,69 @@
     #endif
 #endif
 
+/*Use SIMD kernels for the common software blend paths (RGB565 only, other formats fall back to C).
+ *LV_DRAW_SW_ASM_NONE: portable C
+ *LV_DRAW_SW_ASM_NEON: Arm NEON (AArch64 or ARMv7 with NEON)*/
+#ifndef LV_USE_DRAW_SW_ASM
+    #ifdef CONFIG_LV_USE_DRAW_SW_ASM
+        #define LV_USE_DRAW_SW_ASM CONFIG_LV_USE_DRAW_SW_ASM
+    #else
+        #define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_NONE
+    #endif
+#endif
+
+/*Draw the invalidated areas with several POSIX threads.
+ *Every area is cut into horizontal bands which are drawn in parallel into the draw buffer
+ *and flushed when all of them are ready. The result is the same as drawing on one thread.
+ *Requires the software renderer and `LV_ENABLE_GC == 0`.*/
+#ifndef LV_USE_REFR_THREADS
+    #ifdef CONFIG_LV_USE_REFR_THREADS
+        #define LV_USE_REFR_THREADS CONFIG_LV_USE_REFR_THREADS
+    #else
+        #define LV_USE_REFR_THREADS 0
+    #endif
+#endif
+#if LV_USE_REFR_THREADS
+    /*Max. number of drawing threads including the one calling `lv_timer_handler()`.
+     *Can be lowered at runtime with `lv_refr_set_thread_cnt()`*/
+    #ifndef LV_REFR_THREAD_CNT
+        #ifdef CONFIG_LV_REFR_THREAD_CNT
+            #define LV_REFR_THREAD_CNT CONFIG_LV_REFR_THREAD_CNT
+        #else
+            #define LV_REFR_THREAD_CNT 4
+        #endif
+    #endif
+
+    /*Pin the helper threads to consecutive CPUs starting from this one. -1: don't pin*/
+    #ifndef LV_REFR_THREAD_CPU_FIRST
+        #ifdef CONFIG_LV_REFR_THREAD_CPU_FIRST
+            #define LV_REFR_THREAD_CPU_FIRST CONFIG_LV_REFR_THREAD_CPU_FIRST
+        #else
+            #define LV_REFR_THREAD_CPU_FIRST -1
+        #endif
+    #endif
+
+    /*Don't cut bands lower than this (rows)*/
+    #ifndef LV_REFR_THREAD_MIN_ROWS
+        #ifdef CONFIG_LV_REFR_THREAD_MIN_ROWS
+            #define LV_REFR_THREAD_MIN_ROWS CONFIG_LV_REFR_THREAD_MIN_ROWS
+        #else
+            #define LV_REFR_THREAD_MIN_ROWS 16
+        #endif
+    #endif
+#endif
+
+/*Don't draw the objects which are fully hidden by opaque siblings drawn after them.
+ *The siblings can hide an object together, e.g. several buttons side by side.
+ *`lv_refr_get_overdraw()` tells how many pixels were drawn and skipped in the last refresh.*/
+#ifndef LV_USE_REFR_OCCLUSION
+    #ifdef CONFIG_LV_USE_REFR_OCCLUSION
+        #define LV_USE_REFR_OCCLUSION CONFIG_LV_USE_REFR_OCCLUSION
+    #else
+        #define LV_USE_REFR_OCCLUSION 0
+    #endif
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -796,6 +894,33 @@
     #endif
 #endif
 
+/*1: Record the refresh stages and the draw calls (and the application's own trace points)
+ *into per thread ring buffers which `lv_trace_dump()` writes as Chrome trace JSON.
+ *Needs `__thread` and `clock_gettime()`*/
+#ifndef LV_USE_TRACE
+    #ifdef CONFIG_LV_USE_TRACE
+        #define LV_USE_TRACE CONFIG_LV_USE_TRACE
+    #else
+        #define LV_USE_TRACE 0
+    #endif
+#endif
+#if LV_USE_TRACE
+    #ifndef LV_TRACE_BUF_EVENTS
+        #ifdef CONFIG_LV_TRACE_BUF_EVENTS
+            #define LV_TRACE_BUF_EVENTS CONFIG_LV_TRACE_BUF_EVENTS
+        #else
+            #define LV_TRACE_BUF_EVENTS 16384   /*Last events kept per thread (16 bytes each), a power of 2*/
+        #endif
+    #endif
+    #ifndef LV_TRACE_MAX_THREADS
+        #ifdef CONFIG_LV_TRACE_MAX_THREADS
+            #define LV_TRACE_MAX_THREADS CONFIG_LV_TRACE_MAX_THREADS
+        #else
+            #define LV_TRACE_MAX_THREADS 8      /*Threads beyond this are not recorded*/
+        #endif
+    #endif
+#endif
+
 /*Change the built in (v)snprintf functions*/
 #ifndef LV_SPRINTF_CUSTOM
     #ifdef CONFIG_LV_SPRINTF_CUSTOM
@@ -19,6 +19,7 @@ extern "C" {
 #include "lv_ll.h"
 #include "lv_timer.h"
 #include "lv_types.h"
+#include "lv_thread.h"
 #include "../draw/lv_img_cache.h"
 #include "../draw/lv_draw_mask.h"
 #include "../core/lv_obj_pos.h"
@@ -41,6 +42,10 @@ extern "C" {
 #define LV_DISPATCH11(f, t, n)          LV_DISPATCH(f, t, n)
 
 #define LV_ITERATE_ROOTS(f)                                                                            \
+    LV_ITERATE_SHARED_ROOTS(f)                                                                         \
+    LV_ITERATE_THREAD_ROOTS(f)
+
+#define LV_ITERATE_SHARED_ROOTS(f)                                                                     \
     LV_DISPATCH(f, lv_ll_t, _lv_timer_ll) /*Linked list to store the lv_timers*/                       \
     LV_DISPATCH(f, lv_ll_t, _lv_disp_ll)  /*Linked list of display device*/                            \
     LV_DISPATCH(f, lv_ll_t, _lv_indev_ll) /*Linked list of input device*/                              \
@@ -53,27 +58,37 @@ extern "C" {
     LV_DISPATCH_COND(f, _lv_img_cache_entry_t*, _lv_img_cache_array, LV_IMG_CACHE_DEF, 1)              \
     LV_DISPATCH_COND(f, _lv_img_cache_entry_t, _lv_img_cache_single, LV_IMG_CACHE_DEF, 0)              \
     LV_DISPATCH(f, lv_timer_t*, _lv_timer_act)                                                         \
-    LV_DISPATCH(f, lv_mem_buf_arr_t , lv_mem_buf)                                                      \
-    LV_DISPATCH_COND(f, _lv_draw_mask_radius_circle_dsc_arr_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)  \
-    LV_DISPATCH_COND(f, _lv_draw_mask_saved_arr_t , _lv_draw_mask_list, LV_DRAW_COMPLEX, 1)            \
     LV_DISPATCH(f, void * , _lv_theme_default_styles)                                                  \
     LV_DISPATCH(f, void * , _lv_theme_basic_styles)                                                  \
-    LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
-    LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)                                                     \
     LV_DISPATCH(f, uint8_t * , _lv_style_custom_prop_flag_lookup_table)
 
+/*Roots used while drawing. With `LV_USE_REFR_THREADS` every drawing thread has its own copy.*/
+#define LV_ITERATE_THREAD_ROOTS(f)                                                                     \
+    LV_DISPATCH(f, lv_mem_buf_arr_t , lv_mem_buf)                                                      \
+    LV_DISPATCH(f, lv_mem_frame_t , _lv_mem_frame)                                                     \
+    LV_DISPATCH_COND(f, _lv_draw_mask_circle_cache_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)           \
+    LV_DISPATCH_COND(f, _lv_draw_mask_saved_arr_t , _lv_draw_mask_list, LV_DRAW_COMPLEX, 1)            \
+    LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
+    LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)
+
 #define LV_DEFINE_ROOT(root_type, root_name) root_type root_name;
-#define LV_ROOTS LV_ITERATE_ROOTS(LV_DEFINE_ROOT)
+#define LV_DEFINE_THREAD_ROOT(root_type, root_name) LV_THREAD_LOCAL root_type root_name;
+#define LV_ROOTS LV_ITERATE_SHARED_ROOTS(LV_DEFINE_ROOT) LV_ITERATE_THREAD_ROOTS(LV_DEFINE_THREAD_ROOT)
 
 #if LV_ENABLE_GC == 1
 #if LV_MEM_CUSTOM != 1
 #error "GC requires CUSTOM_MEM"
 #endif /*LV_MEM_CUSTOM*/
+#if LV_USE_REFR_THREADS
+#error "LV_USE_REFR_THREADS requires LV_ENABLE_GC == 0"
+#endif /*LV_USE_REFR_THREADS*/
 #include LV_GC_INCLUDE
 #else  /*LV_ENABLE_GC*/
 #define LV_GC_ROOT(x) x
 #define LV_EXTERN_ROOT(root_type, root_name) extern root_type root_name;
-LV_ITERATE_ROOTS(LV_EXTERN_ROOT)
+#define LV_EXTERN_THREAD_ROOT(root_type, root_name) extern LV_THREAD_LOCAL root_type root_name;
+LV_ITERATE_SHARED_ROOTS(LV_EXTERN_ROOT)
+LV_ITERATE_THREAD_ROOTS(LV_EXTERN_THREAD_ROOT)
 #endif /*LV_ENABLE_GC*/
 
 /**********************
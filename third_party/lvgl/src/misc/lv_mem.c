@@ -12,6 +12,7 @@
 #include "lv_gc.h"
 #include "lv_assert.h"
 #include "lv_log.h"
+#include "lv_thread.h"
 
 #if LV_MEM_CUSTOM != 0
     #include LV_MEM_CUSTOM_INCLUDE
@@ -21,6 +22,10 @@
     #include LV_MEM_POOL_INCLUDE
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_EXPAND_SIZE
+    #include <stdlib.h>
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -39,16 +44,55 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_EXPAND_SIZE
+    #if LV_MEM_EXPAND_SIZE > LV_MEM_SIZE
+        #error "LV_MEM_EXPAND_SIZE can't be larger than LV_MEM_SIZE"
+    #endif
+    #define EXPAND_POOL_MAX  16
+#endif
+
+#if LV_MEM_FRAME_SIZE
+    #define FRAME_NONE       UINT32_MAX
+#endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    #define SLAB_PAGE_SIZE   1024   /*Pages are given to a size class as needed and kept by it*/
+    #define SLAB_PAGE_CNT    (LV_MEM_SLAB_SIZE / SLAB_PAGE_SIZE)
+    #define SLAB_CLASS_CNT   (sizeof(slab_class_size) / sizeof(slab_class_size[0]))
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+typedef struct _slab_block_t {
+    struct _slab_block_t * next;
+} slab_block_t;
+#endif
+
+#if LV_MEM_FRAME_SIZE
+/*In front of every block of the frame arena. 8 bytes to keep the blocks aligned.*/
+typedef struct {
+    uint32_t prev;      /*Start of the previous block, FRAME_NONE for the first*/
+    uint32_t freed;
+} frame_hdr_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_MEM_CUSTOM == 0
+    static void * pool_alloc(size_t size);
+    static void * pool_realloc(void * data, size_t new_size);
+    static bool pool_expand(size_t size);
+    static size_t block_size(void * data);
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    static void * slab_alloc(size_t size);
+    static void slab_free(void * data);
+    static bool slab_has(const void * data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -57,6 +101,24 @@
     static lv_tlsf_t tlsf;
     static uint32_t cur_used;
     static uint32_t max_used;
+    static lv_mutex_t mem_mutex = LV_MUTEX_INITIALIZER; /*The drawing threads of LV_USE_REFR_THREADS allocate too*/
+#endif
+#if LV_MEM_CUSTOM == 0 && LV_MEM_EXPAND_SIZE
+    static lv_pool_t expand_pools[EXPAND_POOL_MAX];     /*Also the `malloc`ed memory of the pool*/
+    static uint32_t expand_pool_cnt;
+#endif
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    static const uint16_t slab_class_size[] = {16, 32, 48, 64, 96, 128};
+    static LV_ATTRIBUTE_LARGE_RAM_ARRAY MEM_UNIT slab_mem[SLAB_PAGE_CNT * SLAB_PAGE_SIZE / sizeof(MEM_UNIT)];
+    static uint8_t slab_page_class[SLAB_PAGE_CNT];
+    static uint32_t slab_page_cnt;                      /*Pages given to a size class, from the start*/
+    static slab_block_t * slab_free_list[SLAB_CLASS_CNT];
+    static uint32_t slab_used;
+#endif
+static uint32_t alloc_cnt;
+#if LV_MEM_FRAME_SIZE
+    static lv_mem_frame_stats_t frame_stats = {.size = LV_MEM_FRAME_SIZE};
+    static lv_mutex_t frame_stats_mutex = LV_MUTEX_INITIALIZER;
 #endif
 
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
@@ -113,6 +175,18 @@ void lv_mem_deinit(void)
 {
 #if LV_MEM_CUSTOM == 0
     lv_tlsf_destroy(tlsf);
+#if LV_MEM_EXPAND_SIZE
+    for(uint32_t i = 0; i < expand_pool_cnt; i++) free(expand_pools[i]);
+    expand_pool_cnt = 0;
+#endif
+#if LV_MEM_SLAB_SIZE
+    slab_page_cnt = 0;
+    slab_used = 0;
+    lv_memset_00(slab_free_list, sizeof(slab_free_list));
+#endif
+    cur_used = 0;
+    max_used = 0;
+    alloc_cnt = 0;
     lv_mem_init();
 #endif
 }
@@ -131,9 +205,21 @@ void * lv_mem_alloc(size_t size)
     }
 
 #if LV_MEM_CUSTOM == 0
-    void * alloc = lv_tlsf_malloc(tlsf, size);
+    lv_mutex_lock(&mem_mutex);
+    void * alloc = NULL;
+#if LV_MEM_SLAB_SIZE
+    alloc = slab_alloc(size);
+#endif
+    if(alloc == NULL) alloc = pool_alloc(size);
+    if(alloc) {
+        alloc_cnt++;
+        cur_used += block_size(alloc);
+        max_used = LV_MAX(cur_used, max_used);
+    }
+    lv_mutex_unlock(&mem_mutex);
 #else
     void * alloc = LV_MEM_CUSTOM_ALLOC(size);
+    if(alloc) lv_atomic_inc(&alloc_cnt);
 #endif
 
     if(alloc == NULL) {
@@ -153,10 +239,6 @@ void * lv_mem_alloc(size_t size)
 #endif
 
     if(alloc) {
-#if LV_MEM_CUSTOM == 0
-        cur_used += size;
-        max_used = LV_MAX(cur_used, max_used);
-#endif
         MEM_TRACE("allocated at %p", alloc);
     }
     return alloc;
@@ -173,12 +255,19 @@ void lv_mem_free(void * data)
     if(data == NULL) return;
 
 #if LV_MEM_CUSTOM == 0
+    lv_mutex_lock(&mem_mutex);
+    size_t size = block_size(data);
 #  if LV_MEM_ADD_JUNK
-    lv_memset(data, 0xbb, lv_tlsf_block_size(data));
+    lv_memset(data, 0xbb, size);
 #  endif
-    size_t size = lv_tlsf_free(tlsf, data);
+#if LV_MEM_SLAB_SIZE
+    if(slab_has(data)) slab_free(data);
+    else
+#endif
+        lv_tlsf_free(tlsf, data);
     if(cur_used > size) cur_used -= size;
     else cur_used = 0;
+    lv_mutex_unlock(&mem_mutex);
 #else
     LV_MEM_CUSTOM_FREE(data);
 #endif
@@ -200,12 +289,22 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
         return &zero_mem;
     }
 
-    if(data_p == &zero_mem) return lv_mem_alloc(new_size);
+    if(data_p == &zero_mem || data_p == NULL) return lv_mem_alloc(new_size);
 
 #if LV_MEM_CUSTOM == 0
-    void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+    lv_mutex_lock(&mem_mutex);
+    size_t old_size = block_size(data_p);
+    void * new_p = pool_realloc(data_p, new_size);
+    if(new_p) {
+        alloc_cnt++;
+        cur_used = cur_used > old_size ? cur_used - old_size : 0;
+        cur_used += block_size(new_p);
+        max_used = LV_MAX(cur_used, max_used);
+    }
+    lv_mutex_unlock(&mem_mutex);
 #else
     void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+    if(new_p) lv_atomic_inc(&alloc_cnt);
 #endif
     if(new_p == NULL) {
         LV_LOG_ERROR("couldn't allocate memory");
@@ -224,12 +323,20 @@ lv_res_t lv_mem_test(void)
     }
 
 #if LV_MEM_CUSTOM == 0
-    if(lv_tlsf_check(tlsf)) {
+    lv_mutex_lock(&mem_mutex);
+    int tlsf_res = lv_tlsf_check(tlsf);
+    int pool_res = lv_tlsf_check_pool(lv_tlsf_get_pool(tlsf));
+#if LV_MEM_EXPAND_SIZE
+    for(uint32_t i = 0; i < expand_pool_cnt; i++) pool_res |= lv_tlsf_check_pool(expand_pools[i]);
+#endif
+    lv_mutex_unlock(&mem_mutex);
+
+    if(tlsf_res) {
         LV_LOG_WARN("failed");
         return LV_RES_INV;
     }
 
-    if(lv_tlsf_check_pool(lv_tlsf_get_pool(tlsf))) {
+    if(pool_res) {
         LV_LOG_WARN("pool failed");
         return LV_RES_INV;
     }
@@ -250,9 +357,25 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 #if LV_MEM_CUSTOM == 0
     MEM_TRACE("begin");
 
+    lv_mutex_lock(&mem_mutex);
     lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf), lv_mem_walker, mon_p);
-
     mon_p->total_size = LV_MEM_SIZE;
+    mon_p->pool_cnt = 1;
+#if LV_MEM_EXPAND_SIZE
+    for(uint32_t i = 0; i < expand_pool_cnt; i++) {
+        lv_tlsf_walk_pool(expand_pools[i], lv_mem_walker, mon_p);
+    }
+    mon_p->total_size += expand_pool_cnt * LV_MEM_EXPAND_SIZE;
+    mon_p->pool_cnt += expand_pool_cnt;
+#endif
+#if LV_MEM_SLAB_SIZE
+    mon_p->slab_size = slab_page_cnt * SLAB_PAGE_SIZE;
+    mon_p->slab_used = slab_used;
+#endif
+    mon_p->max_used = max_used;
+    mon_p->alloc_cnt = alloc_cnt;
+    lv_mutex_unlock(&mem_mutex);
+
     mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
     if(mon_p->free_size > 0) {
         mon_p->frag_pct = mon_p->free_biggest_size * 100U / mon_p->free_size;
@@ -262,9 +385,9 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
         mon_p->frag_pct = 0; /*no fragmentation if all the RAM is used*/
     }
 
-    mon_p->max_used = max_used;
-
     MEM_TRACE("finished");
+#else
+    mon_p->alloc_cnt = alloc_cnt;
 #endif
 }
 
@@ -279,6 +402,10 @@ void * lv_mem_buf_get(uint32_t size)
 
     MEM_TRACE("begin, getting %d bytes", size);
 
+#if LV_MEM_FRAME_SIZE
+    return lv_mem_frame_alloc(size);
+#endif
+
     /*Try to find a free buffer with suitable size*/
     int8_t i_guess = -1;
     for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
@@ -333,6 +460,11 @@ void lv_mem_buf_release(void * p)
 {
     MEM_TRACE("begin (address: %p)", p);
 
+#if LV_MEM_FRAME_SIZE
+    lv_mem_frame_free(p);
+    return;
+#endif
+
     for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
         if(LV_GC_ROOT(lv_mem_buf[i]).p == p) {
             LV_GC_ROOT(lv_mem_buf[i]).used = 0;
@@ -358,6 +490,121 @@ void lv_mem_buf_free_all(void)
     }
 }
 
+/**
+ * Allocate from the arena of the calling thread
+ * @param size  size of the memory in bytes
+ * @return      pointer to the memory, NULL if `size` is 0 or there is no memory
+ */
+void * lv_mem_frame_alloc(uint32_t size)
+{
+    if(size == 0) return NULL;
+
+#if LV_MEM_FRAME_SIZE
+    lv_mem_frame_t * frame = &LV_GC_ROOT(_lv_mem_frame);
+    if(frame->buf == NULL) {
+        frame->buf = lv_mem_alloc(LV_MEM_FRAME_SIZE);
+        LV_ASSERT_MALLOC(frame->buf);
+        frame->top = 0;
+        frame->last = FRAME_NONE;
+    }
+
+    uint32_t block_size = sizeof(frame_hdr_t) + ((size + 7) & ~7U);
+    if(frame->buf == NULL || block_size > LV_MEM_FRAME_SIZE - frame->top) {
+        MEM_TRACE("the frame arena is full, using lv_mem_alloc");
+        lv_mutex_lock(&frame_stats_mutex);
+        frame_stats.overflow++;
+        lv_mutex_unlock(&frame_stats_mutex);
+        return lv_mem_alloc(size);
+    }
+
+    frame_hdr_t * hdr = (frame_hdr_t *)(frame->buf + frame->top);
+    hdr->prev = frame->last;
+    hdr->freed = 0;
+    frame->last = frame->top;
+    frame->top += block_size;
+    if(frame->top > frame->high_water) frame->high_water = frame->top;
+    return hdr + 1;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
+/**
+ * Free a memory of `lv_mem_frame_alloc()`
+ * @param p     pointer to the memory, can be NULL
+ */
+void lv_mem_frame_free(void * p)
+{
+    if(p == NULL) return;
+
+#if LV_MEM_FRAME_SIZE
+    lv_mem_frame_t * frame = &LV_GC_ROOT(_lv_mem_frame);
+    uint8_t * p8 = p;
+    if(frame->buf == NULL || p8 < frame->buf || p8 >= frame->buf + LV_MEM_FRAME_SIZE) {
+        lv_mem_free(p);
+        return;
+    }
+
+    frame_hdr_t * hdr = (frame_hdr_t *)p - 1;
+    hdr->freed = 1;
+
+    /*Give back the freed blocks from the top*/
+    while(frame->last != FRAME_NONE) {
+        hdr = (frame_hdr_t *)(frame->buf + frame->last);
+        if(!hdr->freed) break;
+        frame->top = frame->last;
+        frame->last = hdr->prev;
+    }
+#else
+    lv_mem_free(p);
+#endif
+}
+
+/**
+ * Empty the arena of the calling thread
+ */
+void lv_mem_frame_reset(void)
+{
+#if LV_MEM_FRAME_SIZE
+    lv_mem_frame_t * frame = &LV_GC_ROOT(_lv_mem_frame);
+    lv_mutex_lock(&frame_stats_mutex);
+    frame_stats.high_water = LV_MAX(frame->high_water, frame_stats.high_water);
+    lv_mutex_unlock(&frame_stats_mutex);
+
+    frame->top = 0;
+    frame->last = FRAME_NONE;
+    frame->high_water = 0;
+#endif
+}
+
+/**
+ * Get the statistics of the arenas of all threads
+ * @param stats     store the statistics here
+ */
+void lv_mem_frame_get_stats(lv_mem_frame_stats_t * stats)
+{
+#if LV_MEM_FRAME_SIZE
+    lv_mutex_lock(&frame_stats_mutex);
+    *stats = frame_stats;
+    lv_mutex_unlock(&frame_stats_mutex);
+#else
+    lv_memset_00(stats, sizeof(lv_mem_frame_stats_t));
+#endif
+}
+
+/**
+ * Clear the high water mark and the overflow count
+ */
+void lv_mem_frame_reset_stats(void)
+{
+#if LV_MEM_FRAME_SIZE
+    lv_mutex_lock(&frame_stats_mutex);
+    frame_stats.high_water = 0;
+    frame_stats.overflow = 0;
+    lv_mutex_unlock(&frame_stats_mutex);
+#endif
+}
+
 #if LV_MEMCPY_MEMSET_STD == 0
 /**
  * Same as `memcpy` but optimized for 4 byte operation.
@@ -548,6 +795,91 @@ void LV_ATTRIBUTE_FAST_MEM lv_memset_ff(void * dst, size_t len)
  **********************/
 
 #if LV_MEM_CUSTOM == 0
+/**
+ * Allocate from the TLSF pools and add a pool if they are full
+ * @param size      size of the memory in bytes
+ * @return          pointer to the memory or NULL
+ */
+static void * pool_alloc(size_t size)
+{
+    void * alloc = lv_tlsf_malloc(tlsf, size);
+    if(alloc == NULL && pool_expand(size)) alloc = lv_tlsf_malloc(tlsf, size);
+    return alloc;
+}
+
+/**
+ * Resize a memory of the pools or of the slabs.
+ * A slab block is kept if it's large enough, else the data is moved to a new slab block or to the pools.
+ * @param data      pointer to an allocated memory
+ * @param new_size  the new size in bytes
+ * @return          pointer to the new memory or NULL (`data` is kept then)
+ */
+static void * pool_realloc(void * data, size_t new_size)
+{
+#if LV_MEM_SLAB_SIZE
+    if(slab_has(data)) {
+        size_t old_size = block_size(data);
+        if(new_size <= old_size) return data;
+
+        void * new_p = slab_alloc(new_size);
+        if(new_p == NULL) new_p = pool_alloc(new_size);
+        if(new_p == NULL) return NULL;
+        lv_memcpy(new_p, data, old_size);
+        slab_free(data);
+        return new_p;
+    }
+#endif
+
+    void * new_p = lv_tlsf_realloc(tlsf, data, new_size);
+    if(new_p == NULL && pool_expand(new_size)) new_p = lv_tlsf_realloc(tlsf, data, new_size);
+    return new_p;
+}
+
+/**
+ * Add a `LV_MEM_EXPAND_SIZE` pool from `malloc` to TLSF
+ * @param size      the allocation which didn't fit
+ * @return          true: a pool was added
+ */
+static bool pool_expand(size_t size)
+{
+#if LV_MEM_EXPAND_SIZE
+    if(expand_pool_cnt >= EXPAND_POOL_MAX) return false;
+    if(size + lv_tlsf_pool_overhead() + lv_tlsf_alloc_overhead() > LV_MEM_EXPAND_SIZE) return false;
+
+    void * mem = malloc(LV_MEM_EXPAND_SIZE);
+    if(mem == NULL) return false;
+    lv_pool_t pool = lv_tlsf_add_pool(tlsf, mem, LV_MEM_EXPAND_SIZE);
+    if(pool == NULL) {
+        free(mem);
+        return false;
+    }
+
+    expand_pools[expand_pool_cnt] = pool;
+    expand_pool_cnt++;
+    LV_LOG_INFO("added pool %"LV_PRIu32" (%lu bytes)", expand_pool_cnt, (unsigned long)LV_MEM_EXPAND_SIZE);
+    return true;
+#else
+    LV_UNUSED(size);
+    return false;
+#endif
+}
+
+/**
+ * Get the real size of an allocated memory
+ * @param data      pointer to memory of the slabs or the pools
+ * @return          the size of the slab block or TLSF block
+ */
+static size_t block_size(void * data)
+{
+#if LV_MEM_SLAB_SIZE
+    if(slab_has(data)) {
+        uint32_t page = ((uint8_t *)data - (uint8_t *)slab_mem) / SLAB_PAGE_SIZE;
+        return slab_class_size[slab_page_class[page]];
+    }
+#endif
+    return lv_tlsf_block_size(data);
+}
+
 static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
 {
     LV_UNUSED(ptr);
@@ -564,3 +896,60 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
     }
 }
 #endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+/**
+ * Allocate from the smallest size class `size` fits in. Give a new page to the class if it has no free block.
+ * @param size      size of the memory in bytes
+ * @return          pointer to the block, NULL if `size` is too large or the slabs are full
+ */
+static void * slab_alloc(size_t size)
+{
+    uint32_t c;
+    for(c = 0; c < SLAB_CLASS_CNT; c++) {
+        if(size <= slab_class_size[c]) break;
+    }
+    if(c == SLAB_CLASS_CNT) return NULL;
+
+    if(slab_free_list[c] == NULL) {
+        if(slab_page_cnt >= SLAB_PAGE_CNT) return NULL;
+
+        uint8_t * page = (uint8_t *)slab_mem + slab_page_cnt * SLAB_PAGE_SIZE;
+        slab_page_class[slab_page_cnt] = c;
+        slab_page_cnt++;
+
+        /*Chain the blocks of the page backwards so they are given out in address order*/
+        uint32_t block_cnt = SLAB_PAGE_SIZE / slab_class_size[c];
+        for(uint32_t i = block_cnt; i > 0; i--) {
+            slab_block_t * b = (slab_block_t *)(page + (i - 1) * slab_class_size[c]);
+            b->next = slab_free_list[c];
+            slab_free_list[c] = b;
+        }
+    }
+
+    slab_block_t * b = slab_free_list[c];
+    slab_free_list[c] = b->next;
+    slab_used += slab_class_size[c];
+    return b;
+}
+
+/**
+ * Put a block back to the free list of its size class
+ * @param data      pointer to a block of the slabs
+ */
+static void slab_free(void * data)
+{
+    uint32_t page = ((uint8_t *)data - (uint8_t *)slab_mem) / SLAB_PAGE_SIZE;
+    uint8_t c = slab_page_class[page];
+    slab_block_t * b = data;
+    b->next = slab_free_list[c];
+    slab_free_list[c] = b;
+    slab_used -= slab_class_size[c];
+}
+
+static bool slab_has(const void * data)
+{
+    const uint8_t * p = data;
+    return p >= (const uint8_t *)slab_mem && p < (const uint8_t *)slab_mem + sizeof(slab_mem);
+}
+#endif
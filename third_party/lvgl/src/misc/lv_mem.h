@@ -41,6 +41,10 @@ typedef struct {
     uint32_t max_used; /**< Max size of Heap memory used*/
     uint8_t used_pct; /**< Percentage used*/
     uint8_t frag_pct; /**< Amount of fragmentation*/
+    uint32_t alloc_cnt; /**< Allocations and reallocations since `lv_mem_init()`. Its change over time is the rate*/
+    uint32_t pool_cnt; /**< Number of pools, more than 1 if `LV_MEM_EXPAND_SIZE` added some*/
+    uint32_t slab_size; /**< Bytes of the `LV_MEM_SLAB_SIZE` slabs given to a size class*/
+    uint32_t slab_used; /**< Bytes of the slab blocks in use*/
 } lv_mem_monitor_t;
 
 typedef struct {
@@ -51,6 +55,22 @@ typedef struct {
 
 typedef lv_mem_buf_t lv_mem_buf_arr_t[LV_MEM_BUF_MAX_NUM];
 
+/**
+ * Bump allocator of a drawing thread, see `LV_MEM_FRAME_SIZE`
+ */
+typedef struct {
+    uint8_t * buf;
+    uint32_t top;           /**< End of the last block*/
+    uint32_t last;          /**< Start of the last block*/
+    uint32_t high_water;    /**< Largest `top` since the last `lv_mem_frame_reset()`*/
+} lv_mem_frame_t;
+
+typedef struct {
+    uint32_t size;          /**< Size of the arena of a thread, `LV_MEM_FRAME_SIZE`*/
+    uint32_t high_water;    /**< Most bytes a thread used in a refresh*/
+    uint32_t overflow;      /**< Allocations which didn't fit and were given by `lv_mem_alloc()`*/
+} lv_mem_frame_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -95,7 +115,9 @@ void * lv_mem_realloc(void * data_p, size_t new_size);
 lv_res_t lv_mem_test(void);
 
 /**
- * Give information about the work memory of dynamic allocation
+ * Give information about the work memory of dynamic allocation.
+ * The sizes are about the TLSF pools, the slabs have their own fields.
+ * With `LV_MEM_CUSTOM` only `alloc_cnt` is set.
  * @param mon_p pointer to a lv_mem_monitor_t variable,
  *              the result of the analysis will be stored here
  */
@@ -104,6 +126,7 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
 /**
  * Get a temporal buffer with the given size.
+ * With `LV_USE_REFR_THREADS` every drawing thread has its own set of buffers.
  * @param size the required size
  */
 void * lv_mem_buf_get(uint32_t size);
@@ -119,6 +142,37 @@ void lv_mem_buf_release(void * p);
  */
 void lv_mem_buf_free_all(void);
 
+/**
+ * Allocate from the arena of the calling thread. Blocks freed in reverse order are given back at once,
+ * the others when the blocks above them are freed or at the next `lv_mem_frame_reset()`.
+ * The memory must be freed by the same thread with `lv_mem_frame_free()` and not used after the refresh.
+ * @param size  size of the memory in bytes
+ * @return      pointer to the memory, NULL if `size` is 0 or there is no memory
+ */
+void * lv_mem_frame_alloc(uint32_t size);
+
+/**
+ * Free a memory of `lv_mem_frame_alloc()`
+ * @param p     pointer to the memory, can be NULL
+ */
+void lv_mem_frame_free(void * p);
+
+/**
+ * Empty the arena of the calling thread. Called at the end of each refresh.
+ */
+void lv_mem_frame_reset(void);
+
+/**
+ * Get the statistics of the arenas of all threads
+ * @param stats     store the statistics here
+ */
+void lv_mem_frame_get_stats(lv_mem_frame_stats_t * stats);
+
+/**
+ * Clear the high water mark and the overflow count
+ */
+void lv_mem_frame_reset_stats(void);
+
 //! @cond Doxygen_Suppress
 
 #if LV_MEMCPY_MEMSET_STD
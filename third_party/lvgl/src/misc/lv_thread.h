@@ -0,0 +1,85 @@
+/**
+ * @file lv_thread.h
+ * The few threading primitives needed when `LV_USE_REFR_THREADS` draws in parallel.
+ * Without it they compile to nothing.
+ */
+
+#ifndef LV_THREAD_H
+#define LV_THREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_REFR_THREADS
+#include <pthread.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#if LV_USE_REFR_THREADS
+/*State which is used while drawing and therefore has to be separate for every drawing thread*/
+#define LV_THREAD_LOCAL __thread
+#define LV_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#else
+#define LV_THREAD_LOCAL
+#define LV_MUTEX_INITIALIZER 0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+#if LV_USE_REFR_THREADS
+typedef pthread_mutex_t lv_mutex_t;
+#else
+typedef int lv_mutex_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+static inline void lv_mutex_lock(lv_mutex_t * m)
+{
+#if LV_USE_REFR_THREADS
+    pthread_mutex_lock(m);
+#else
+    (void)m;
+#endif
+}
+
+static inline void lv_mutex_unlock(lv_mutex_t * m)
+{
+#if LV_USE_REFR_THREADS
+    pthread_mutex_unlock(m);
+#else
+    (void)m;
+#endif
+}
+
+/**
+ * Increment a counter which can be updated by more drawing threads
+ * @param cnt   pointer to the counter
+ */
+static inline void lv_atomic_inc(uint32_t * cnt)
+{
+#if LV_USE_REFR_THREADS
+    __atomic_fetch_add(cnt, 1, __ATOMIC_RELAXED);
+#else
+    (*cnt)++;
+#endif
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_THREAD_H*/
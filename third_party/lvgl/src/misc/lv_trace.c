@@ -0,0 +1,249 @@
+/**
+ * @file lv_trace.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE /*For syscall(SYS_gettid)*/
+#endif
+
+#include "lv_trace.h"
+
+#if LV_USE_TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#if (LV_TRACE_BUF_EVENTS & (LV_TRACE_BUF_EVENTS - 1)) != 0
+    #error "LV_TRACE_BUF_EVENTS has to be a power of 2"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    const char * name;
+    uint64_t ts;        /*CLOCK_MONOTONIC in ns with the lowest bit set for begin and cleared for end*/
+} trace_event_t;
+
+/*Written only by its thread. `claimed` is bumped before an event is written and `head` after it,
+ *so a dump can tell which of the events it copied were overwritten meanwhile*/
+typedef struct {
+    trace_event_t * ev;
+    uint32_t claimed;
+    uint32_t head;
+    int tid;
+    bool ready;
+    bool named;
+    char name[16];
+} trace_ring_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static trace_ring_t * ring_get(void);
+static void record(const char * name, uint64_t begin);
+static uint32_t ring_copy(trace_ring_t * r, trace_event_t * out);
+static void write_name(FILE * f, const char * name);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static trace_ring_t rings[LV_TRACE_MAX_THREADS];
+static trace_ring_t ring_none;          /*Of the threads beyond LV_TRACE_MAX_THREADS: not recorded*/
+static uint32_t ring_cnt;
+static bool trace_enabled = true;
+static __thread trace_ring_t * ring_act;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_trace_begin(const char * name)
+{
+    record(name, 1);
+}
+
+void lv_trace_end(const char * name)
+{
+    record(name, 0);
+}
+
+void lv_trace_set_thread_name(const char * name)
+{
+    trace_ring_t * r = ring_get();
+    if(r->ev == NULL || __atomic_load_n(&r->named, __ATOMIC_RELAXED)) return;
+
+    strncpy(r->name, name, sizeof(r->name) - 1);
+    __atomic_store_n(&r->named, true, __ATOMIC_RELEASE);
+}
+
+void lv_trace_set_enabled(bool en)
+{
+    __atomic_store_n(&trace_enabled, en, __ATOMIC_RELAXED);
+}
+
+bool lv_trace_is_enabled(void)
+{
+    return __atomic_load_n(&trace_enabled, __ATOMIC_RELAXED);
+}
+
+lv_res_t lv_trace_dump(const char * path)
+{
+    trace_event_t * buf = malloc(sizeof(trace_event_t) * LV_TRACE_BUF_EVENTS);
+    if(buf == NULL) return LV_RES_INV;
+
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        free(buf);
+        return LV_RES_INV;
+    }
+
+    int pid = (int)getpid();
+    const char * sep = "\n";
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    uint32_t cnt = __atomic_load_n(&ring_cnt, __ATOMIC_RELAXED);
+    if(cnt > LV_TRACE_MAX_THREADS) cnt = LV_TRACE_MAX_THREADS;
+
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        trace_ring_t * r = &rings[i];
+        if(!__atomic_load_n(&r->ready, __ATOMIC_ACQUIRE)) continue;
+
+        if(__atomic_load_n(&r->named, __ATOMIC_ACQUIRE)) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", sep, pid,
+                    r->tid);
+            write_name(f, r->name);
+            fprintf(f, "}}");
+            sep = ",\n";
+        }
+
+        /*The oldest events may be the ends of spans whose beginning was overwritten: skip those*/
+        uint32_t n = ring_copy(r, buf);
+        uint32_t depth = 0;
+        uint32_t e;
+        for(e = 0; e < n; e++) {
+            bool begin = buf[e].ts & 1;
+            if(begin) depth++;
+            else if(depth == 0) continue;
+            else depth--;
+
+            fprintf(f, "%s{\"name\":", sep);
+            write_name(f, buf[e].name);
+            fprintf(f, ",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":%d,\"tid\":%d}", begin ? 'B' : 'E',
+                    (unsigned long long)(buf[e].ts / 1000), (unsigned)(buf[e].ts % 1000), pid, r->tid);
+            sep = ",\n";
+        }
+    }
+
+    fprintf(f, "\n]}\n");
+    free(buf);
+
+    bool ok = !ferror(f);
+    if(fclose(f) != 0) ok = false;
+    return ok ? LV_RES_OK : LV_RES_INV;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the ring of the calling thread, set it up on the first call.
+ * Threads keep their ring after they exit.
+ */
+static trace_ring_t * ring_get(void)
+{
+    trace_ring_t * r = ring_act;
+    if(r) return r;
+
+    uint32_t slot = __atomic_fetch_add(&ring_cnt, 1, __ATOMIC_RELAXED);
+    if(slot < LV_TRACE_MAX_THREADS) {
+        r = &rings[slot];
+        r->tid = (int)syscall(SYS_gettid);
+        r->ev = malloc(sizeof(trace_event_t) * LV_TRACE_BUF_EVENTS);
+        __atomic_store_n(&r->ready, r->ev != NULL, __ATOMIC_RELEASE);
+    }
+    else {
+        r = &ring_none;
+    }
+
+    ring_act = r;
+    return r;
+}
+
+static void record(const char * name, uint64_t begin)
+{
+    if(!__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED)) return;
+
+    trace_ring_t * r = ring_get();
+    if(r->ev == NULL) return;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+
+    uint32_t i = r->head;
+    trace_event_t * e = &r->ev[i & (LV_TRACE_BUF_EVENTS - 1)];
+    __atomic_store_n(&r->claimed, i + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->name, name, __ATOMIC_RELEASE);
+    __atomic_store_n(&e->ts, (ns & ~(uint64_t)1) | begin, __ATOMIC_RELEASE);
+    __atomic_store_n(&r->head, i + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy the events of a ring which are still in it, oldest first
+ * @param r     the ring
+ * @param out   room for LV_TRACE_BUF_EVENTS events
+ * @return      number of events copied
+ */
+static uint32_t ring_copy(trace_ring_t * r, trace_event_t * out)
+{
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    uint32_t first = head > LV_TRACE_BUF_EVENTS ? head - LV_TRACE_BUF_EVENTS : 0;
+
+    uint32_t i;
+    for(i = first; i != head; i++) {
+        const trace_event_t * e = &r->ev[i & (LV_TRACE_BUF_EVENTS - 1)];
+        out[i - first].name = __atomic_load_n(&e->name, __ATOMIC_ACQUIRE);
+        out[i - first].ts = __atomic_load_n(&e->ts, __ATOMIC_ACQUIRE);
+    }
+
+    /*Event `i` is overwritten by event `i + LV_TRACE_BUF_EVENTS` which is claimed before it's written,
+     *so having read any of its fields means seeing its claim here*/
+    uint32_t claimed = __atomic_load_n(&r->claimed, __ATOMIC_RELAXED);
+    uint32_t valid = claimed > LV_TRACE_BUF_EVENTS ? claimed - LV_TRACE_BUF_EVENTS : 0;
+    if(valid <= first) return head - first;
+    if(valid >= head) return 0;
+
+    memmove(out, out + (valid - first), (head - valid) * sizeof(trace_event_t));
+    return head - valid;
+}
+
+static void write_name(FILE * f, const char * name)
+{
+    fputc('"', f);
+    for(; *name; name++) {
+        if(*name == '"' || *name == '\\') fputc('\\', f);
+        if((unsigned char)*name >= 0x20) fputc(*name, f);
+    }
+    fputc('"', f);
+}
+
+#endif /*LV_USE_TRACE*/
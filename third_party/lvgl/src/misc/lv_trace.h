@@ -0,0 +1,89 @@
+/**
+ * @file lv_trace.h
+ * Scoped trace points written to per thread ring buffers and dumped as Chrome trace JSON
+ * (chrome://tracing, https://ui.perfetto.dev).
+ * Every thread owns its ring so recording an event is a clock read and two stores, no lock.
+ * The rings keep the last `LV_TRACE_BUF_EVENTS` events of each thread, older ones are overwritten.
+ * Needs `LV_USE_TRACE`, `__thread` and `clock_gettime()`. Without `LV_USE_TRACE` the macros compile to nothing.
+ */
+
+#ifndef LV_TRACE_H
+#define LV_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#include <stdbool.h>
+#include "lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#if LV_USE_TRACE
+/*`name` has to be a string which lives as long as the program, typically a literal*/
+#define LV_TRACE_BEGIN(name) lv_trace_begin(name)
+#define LV_TRACE_END(name)   lv_trace_end(name)
+#else
+#define LV_TRACE_BEGIN(name)
+#define LV_TRACE_END(name)
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_USE_TRACE
+
+/**
+ * Open a span on the calling thread. The thread gets its ring buffer on its first event.
+ * @param name  name of the span, only the pointer is stored
+ */
+void lv_trace_begin(const char * name);
+
+/**
+ * Close the innermost open span of the calling thread.
+ * @param name  name of the span, the same as at `lv_trace_begin()`
+ */
+void lv_trace_end(const char * name);
+
+/**
+ * Name the calling thread in the dumps ("ui", "leds", ...).
+ * @param name  the name, copied (at most 15 characters)
+ */
+void lv_trace_set_thread_name(const char * name);
+
+/**
+ * Turn recording on or off on every thread. It is on after start.
+ * @param en    true: record, false: the trace points return right away
+ */
+void lv_trace_set_enabled(bool en);
+
+/**
+ * Tell whether the events are recorded
+ * @return      true: recording
+ */
+bool lv_trace_is_enabled(void);
+
+/**
+ * Write the events in the rings as Chrome trace JSON. Can be called from any thread
+ * while the others keep recording; events overwritten during the dump are left out.
+ * It does file I/O, so don't call it from a signal handler: set a flag there instead.
+ * @param path  file to (over)write
+ * @return      LV_RES_OK: written; LV_RES_INV: the file could not be written
+ */
+lv_res_t lv_trace_dump(const char * path);
+
+#endif /*LV_USE_TRACE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_TRACE_H*/
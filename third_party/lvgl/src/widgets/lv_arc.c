@@ -14,6 +14,10 @@
 #include "../misc/lv_assert.h"
 #include "../misc/lv_math.h"
 #include "../draw/lv_draw_arc.h"
+#include "../draw/lv_draw_img.h"
+#include "../draw/lv_draw_mask.h"
+#include "../draw/lv_img_cache.h"
+#include "../misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -35,7 +39,13 @@
  **********************/
 
 static void lv_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void lv_arc_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_arc_draw(lv_event_t * e);
+static bool draw_bg_cached(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc,
+                           const lv_point_t * center, uint16_t radius, uint16_t start_angle, uint16_t end_angle);
+static bool bg_cache_update(lv_obj_t * obj, const lv_point_t * center, uint16_t radius, lv_coord_t width,
+                            uint16_t start_angle, uint16_t end_angle);
+static void bg_cache_free(lv_obj_t * obj);
 static void lv_arc_event(const lv_obj_class_t * class_p, lv_event_t * e);
 static void inv_arc_area(lv_obj_t * arc, uint16_t start_angle, uint16_t end_angle, lv_part_t part);
 static void inv_knob_area(lv_obj_t * obj);
@@ -44,6 +54,7 @@ static lv_coord_t get_angle(const lv_obj_t * obj);
 static void get_knob_area(lv_obj_t * arc, const lv_point_t * center, lv_coord_t r, lv_area_t * knob_area);
 static void value_update(lv_obj_t * arc);
 static lv_coord_t knob_get_extra_size(lv_obj_t * obj);
+static bool knob_is_drawn(lv_obj_t * obj);
 static bool lv_arc_angle_within_bg_bounds(lv_obj_t * obj, const uint32_t angle, const uint32_t tolerance_deg);
 
 /**********************
@@ -51,6 +62,7 @@ static bool lv_arc_angle_within_bg_bounds(lv_obj_t * obj, const uint32_t angle,
  **********************/
 const lv_obj_class_t lv_arc_class  = {
     .constructor_cb = lv_arc_constructor,
+    .destructor_cb = lv_arc_destructor,
     .event_cb = lv_arc_event,
     .instance_size = sizeof(lv_arc_t),
     .editable = LV_OBJ_CLASS_EDITABLE_TRUE,
@@ -272,6 +284,26 @@ void lv_arc_set_change_rate(lv_obj_t * obj, uint16_t rate)
     arc->chg_rate = rate;
 }
 
+void lv_arc_set_bg_cache(lv_obj_t * obj, bool en)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_arc_t * arc = (lv_arc_t *)obj;
+
+    if(en == (arc->bg_cache != NULL)) return;
+
+    if(en) {
+        arc->bg_cache = lv_mem_alloc(sizeof(_lv_arc_bg_cache_t));
+        LV_ASSERT_MALLOC(arc->bg_cache);
+        if(arc->bg_cache == NULL) return;
+        lv_memset_00(arc->bg_cache, sizeof(_lv_arc_bg_cache_t));
+    }
+    else {
+        bg_cache_free(obj);
+    }
+
+    lv_obj_invalidate(obj);
+}
+
 /*=====================
  * Getter functions
  *====================*/
@@ -324,6 +356,12 @@ lv_arc_mode_t lv_arc_get_mode(const lv_obj_t * obj)
     return ((lv_arc_t *) obj)->type;
 }
 
+bool lv_arc_get_bg_cache(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    return ((lv_arc_t *) obj)->bg_cache != NULL;
+}
+
 /*=====================
  * Other functions
  *====================*/
@@ -405,6 +443,7 @@ static void lv_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     arc->last_tick = lv_tick_get();
     arc->last_angle = arc->indic_angle_end;
     arc->in_out = CLICK_OUTSIDE_BG_ANGLES;
+    arc->bg_cache = NULL;
 
     lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLL_CHAIN | LV_OBJ_FLAG_SCROLLABLE);
@@ -414,6 +453,13 @@ static void lv_arc_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     LV_TRACE_OBJ_CREATE("finished");
 }
 
+static void lv_arc_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+
+    bg_cache_free(obj);
+}
+
 static void lv_arc_event(const lv_obj_class_t * class_p, lv_event_t * e)
 {
     LV_UNUSED(class_p);
@@ -672,8 +718,15 @@ static void lv_arc_draw(lv_event_t * e)
         part_draw_dsc.arc_dsc = &arc_dsc;
         lv_event_send(obj, LV_EVENT_DRAW_PART_BEGIN, &part_draw_dsc);
 
-        lv_draw_arc(draw_ctx, &arc_dsc, &center, part_draw_dsc.radius, arc->bg_angle_start + arc->rotation,
-                    arc->bg_angle_end + arc->rotation);
+        bool cached = false;
+        if(arc->bg_cache) {
+            cached = draw_bg_cached(obj, draw_ctx, &arc_dsc, &center, part_draw_dsc.radius,
+                                    arc->bg_angle_start + arc->rotation, arc->bg_angle_end + arc->rotation);
+        }
+        if(!cached) {
+            lv_draw_arc(draw_ctx, &arc_dsc, &center, part_draw_dsc.radius, arc->bg_angle_start + arc->rotation,
+                        arc->bg_angle_end + arc->rotation);
+        }
 
         lv_event_send(obj, LV_EVENT_DRAW_PART_END, &part_draw_dsc);
     }
@@ -723,6 +776,149 @@ static void lv_arc_draw(lv_event_t * e)
     lv_event_send(obj, LV_EVENT_DRAW_PART_END, &part_draw_dsc);
 }
 
+/**
+ * Draw the background arc by blending its cached alpha map
+ * @return      false if the arc can't be drawn from the cache, draw it with `lv_draw_arc()` then
+ */
+static bool draw_bg_cached(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc,
+                           const lv_point_t * center, uint16_t radius, uint16_t start_angle, uint16_t end_angle)
+{
+    /*The rounded ends and images are drawn in other steps; alpha maps can't be drawn under masks*/
+    if(dsc->img_src || dsc->rounded) return false;
+    if(lv_draw_mask_is_any(draw_ctx->clip_area)) return false;
+    if(dsc->opa <= LV_OPA_MIN || dsc->width == 0 || start_angle == end_angle) return true;
+
+    lv_arc_t * arc = (lv_arc_t *)obj;
+
+    /*With `LV_USE_REFR_THREADS` the first thread drawing the arc renders the map, the others wait for it*/
+    static lv_mutex_t mutex = LV_MUTEX_INITIALIZER;
+    lv_mutex_lock(&mutex);
+    bool ok = bg_cache_update(obj, center, radius, LV_MIN(dsc->width, radius), start_angle, end_angle);
+    lv_mutex_unlock(&mutex);
+    if(!ok) return false;
+
+    lv_draw_img_dsc_t img_dsc;
+    lv_draw_img_dsc_init(&img_dsc);
+    img_dsc.recolor = dsc->color;
+    img_dsc.opa = dsc->opa;
+    img_dsc.blend_mode = dsc->blend_mode;
+
+    lv_area_t coords = arc->bg_cache->area;
+    lv_area_move(&coords, center->x, center->y);
+    lv_draw_img(draw_ctx, &img_dsc, &coords, &arc->bg_cache->img);
+
+    return true;
+}
+
+/**
+ * Render the alpha map of the background arc if its geometry changed.
+ * It applies the same masks in the same order as `lv_draw_sw_arc()` so the pixels are the same.
+ * @return      false if there is no memory for the map
+ */
+static bool bg_cache_update(lv_obj_t * obj, const lv_point_t * center, uint16_t radius, lv_coord_t width,
+                            uint16_t start_angle, uint16_t end_angle)
+{
+    lv_arc_t * arc = (lv_arc_t *)obj;
+    _lv_arc_bg_cache_t * cache = arc->bg_cache;
+
+    if(cache->img.data && cache->radius == radius && cache->width == width &&
+       cache->start_angle == start_angle && cache->end_angle == end_angle) {
+        return true;
+    }
+
+    lv_area_t area_out;
+    area_out.x1 = center->x - radius;
+    area_out.y1 = center->y - radius;
+    area_out.x2 = center->x + radius - 1;
+    area_out.y2 = center->y + radius - 1;
+
+    lv_area_t area_in = area_out;
+    area_in.x1 += width;
+    area_in.y1 += width;
+    area_in.x2 -= width;
+    area_in.y2 -= width;
+
+    lv_area_t map_area;
+    lv_draw_arc_get_area(center->x, center->y, radius, start_angle, end_angle, width, false, &map_area);
+    if(!_lv_area_intersect(&map_area, &map_area, &area_out)) return false;
+
+    lv_coord_t w = lv_area_get_width(&map_area);
+    lv_coord_t h = lv_area_get_height(&map_area);
+
+    lv_img_cache_invalidate_src(&cache->img);
+    lv_opa_t * map = lv_mem_realloc((void *)cache->img.data, (size_t)w * h);
+    if(map == NULL) {
+        LV_LOG_WARN("Not enough memory to cache the background arc");
+        lv_mem_free((void *)cache->img.data);
+        cache->img.data = NULL;
+        return false;
+    }
+
+    cache->radius = radius;
+    cache->width = width;
+    cache->start_angle = start_angle;
+    cache->end_angle = end_angle;
+
+    bool full = start_angle + 360 == end_angle || start_angle == end_angle + 360;
+    while(start_angle >= 360) start_angle -= 360;
+    while(end_angle >= 360) end_angle -= 360;
+
+    void * masks[3];
+    uint32_t mask_cnt = 0;
+    lv_draw_mask_radius_param_t mask_in_param;
+    lv_draw_mask_radius_param_t mask_out_param;
+    lv_draw_mask_angle_param_t mask_angle_param;
+    if(lv_area_get_width(&area_in) > 0 && lv_area_get_height(&area_in) > 0) {
+        lv_draw_mask_radius_init(&mask_in_param, &area_in, LV_RADIUS_CIRCLE, true);
+        masks[mask_cnt++] = &mask_in_param;
+    }
+    lv_draw_mask_radius_init(&mask_out_param, &area_out, LV_RADIUS_CIRCLE, false);
+    masks[mask_cnt++] = &mask_out_param;
+    if(!full) {
+        lv_draw_mask_angle_init(&mask_angle_param, center->x, center->y, start_angle, end_angle);
+        masks[mask_cnt++] = &mask_angle_param;
+    }
+
+    lv_opa_t * line = map;
+    lv_coord_t y;
+    uint32_t i;
+    for(y = map_area.y1; y <= map_area.y2; y++) {
+        lv_memset_ff(line, w);
+        for(i = 0; i < mask_cnt; i++) {
+            _lv_draw_mask_common_dsc_t * mask_dsc = masks[i];
+            if(mask_dsc->cb(line, map_area.x1, y, w, masks[i]) == LV_DRAW_MASK_RES_TRANSP) {
+                lv_memset_00(line, w);
+                break;
+            }
+        }
+        line += w;
+    }
+
+    for(i = 0; i < mask_cnt; i++) lv_draw_mask_free_param(masks[i]);
+
+    cache->img.header.always_zero = 0;
+    cache->img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+    cache->img.header.w = w;
+    cache->img.header.h = h;
+    cache->img.data_size = (uint32_t)w * h;
+    cache->img.data = map;
+    cache->area = map_area;
+    lv_area_move(&cache->area, -center->x, -center->y);
+
+    return true;
+}
+
+static void bg_cache_free(lv_obj_t * obj)
+{
+    lv_arc_t * arc = (lv_arc_t *)obj;
+    if(arc->bg_cache == NULL) return;
+
+    lv_img_cache_invalidate_src(&arc->bg_cache->img);
+    lv_mem_free((void *)arc->bg_cache->img.data);
+    lv_mem_free(arc->bg_cache);
+    arc->bg_cache = NULL;
+}
+
 static void inv_arc_area(lv_obj_t * obj, uint16_t start_angle, uint16_t end_angle, lv_part_t part)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
@@ -758,6 +954,9 @@ static void inv_arc_area(lv_obj_t * obj, uint16_t start_angle, uint16_t end_angl
 
 static void inv_knob_area(lv_obj_t * obj)
 {
+    /*E.g. a gauge without a knob doesn't need to redraw where the knob would be*/
+    if(!knob_is_drawn(obj)) return;
+
     lv_point_t c;
     lv_coord_t r;
     get_center(obj, &c, &r);
@@ -900,6 +1099,17 @@ static lv_coord_t knob_get_extra_size(lv_obj_t * obj)
     return LV_MAX(knob_shadow_size, knob_outline_size);
 }
 
+static bool knob_is_drawn(lv_obj_t * obj)
+{
+    if(lv_obj_get_style_bg_opa(obj, LV_PART_KNOB) > LV_OPA_MIN) return true;
+    if(lv_obj_get_style_bg_img_src(obj, LV_PART_KNOB)) return true;
+    if(lv_obj_get_style_border_width(obj, LV_PART_KNOB) > 0 &&
+       lv_obj_get_style_border_opa(obj, LV_PART_KNOB) > LV_OPA_MIN) return true;
+
+    /*Shadow or outline*/
+    return knob_get_extra_size(obj) > 0;
+}
+
 /**
  * Check if angle is within arc background bounds
  *
@@ -34,6 +34,16 @@ enum {
 };
 typedef uint8_t lv_arc_mode_t;
 
+/*Alpha map of the background arc, kept while its geometry doesn't change*/
+typedef struct {
+    lv_img_dsc_t img;
+    lv_area_t area;             /*Area of `img` relative to the center of the arc*/
+    uint16_t radius;
+    lv_coord_t width;
+    uint16_t start_angle;
+    uint16_t end_angle;
+} _lv_arc_bg_cache_t;
+
 typedef struct {
     lv_obj_t obj;
     uint16_t rotation;
@@ -51,6 +61,7 @@ typedef struct {
     uint32_t chg_rate;          /*Drag angle rate of change of the arc (degrees/sec)*/
     uint32_t last_tick;         /*Last dragging event timestamp of the arc*/
     int16_t last_angle;         /*Last dragging angle of the arc*/
+    _lv_arc_bg_cache_t * bg_cache;  /*Rendered background arc if enabled with `lv_arc_set_bg_cache()`*/
 } lv_arc_t;
 
 extern const lv_obj_class_t lv_arc_class;
@@ -164,6 +175,15 @@ void lv_arc_set_range(lv_obj_t * obj, int16_t min, int16_t max);
  */
 void lv_arc_set_change_rate(lv_obj_t * obj, uint16_t rate);
 
+/**
+ * Render the background arc once into an alpha map and only blend the map when the arc is redrawn.
+ * The map takes 1 byte for every pixel of the background arc's bounding box and it's rendered again
+ * when the radius, width or angles of the background change. Not used for rounded and image arcs.
+ * @param obj       pointer to an arc object
+ * @param en        true: enable; false: disable and free the map (default)
+ */
+void lv_arc_set_bg_cache(lv_obj_t * obj, bool en);
+
 /*=====================
  * Getter functions
  *====================*/
@@ -224,6 +244,13 @@ int16_t lv_arc_get_max_value(const lv_obj_t * obj);
  */
 lv_arc_mode_t lv_arc_get_mode(const lv_obj_t * obj);
 
+/**
+ * Get whether the background arc is drawn from a cached alpha map
+ * @param obj       pointer to an arc object
+ * @return          true: the background is cached
+ */
+bool lv_arc_get_bg_cache(const lv_obj_t * obj);
+
 /*=====================
  * Other functions
  *====================*/
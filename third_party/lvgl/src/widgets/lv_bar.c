@@ -47,7 +47,11 @@
 static void lv_bar_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_bar_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_bar_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void get_indic_area(lv_obj_t * obj, lv_area_t * indic_area, lv_area_t * indic_max_area);
 static void draw_indic(lv_event_t * e);
+static bool indic_change_begin(lv_obj_t * obj, lv_area_t * indic_old);
+static void indic_change_end(lv_obj_t * obj, bool delta, const lv_area_t * indic_old);
+static void refr_indic_area(lv_obj_t * obj);
 static void lv_bar_set_value_with_anim(lv_obj_t * obj, int32_t new_value, int32_t * value_ptr,
                                        _lv_bar_anim_t * anim_info, lv_anim_enable_t en);
 static void lv_bar_init_anim(lv_obj_t * bar, _lv_bar_anim_t * bar_anim);
@@ -140,6 +144,7 @@ void lv_bar_set_range(lv_obj_t * obj, int32_t min, int32_t max)
         bar->cur_value = min;
         lv_bar_set_value(obj, bar->cur_value, LV_ANIM_OFF);
     }
+    refr_indic_area(obj);
     lv_obj_invalidate(obj);
 }
 
@@ -153,9 +158,18 @@ void lv_bar_set_mode(lv_obj_t * obj, lv_bar_mode_t mode)
         bar->start_value = bar->min_value;
     }
 
+    refr_indic_area(obj);
     lv_obj_invalidate(obj);
 }
 
+void lv_bar_set_delta_refr(lv_obj_t * obj, bool en)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_bar_t * bar = (lv_bar_t *)obj;
+
+    bar->delta_refr = en ? 1 : 0;
+}
+
 /*=====================
  * Getter functions
  *====================*/
@@ -201,6 +215,22 @@ lv_bar_mode_t lv_bar_get_mode(lv_obj_t * obj)
     return bar->mode;
 }
 
+bool lv_bar_get_delta_refr(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_bar_t * bar = (lv_bar_t *)obj;
+
+    return bar->delta_refr;
+}
+
+void _lv_bar_get_indic_area(lv_obj_t * obj, lv_area_t * area)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_area_t indic_max;
+    get_indic_area(obj, area, &indic_max);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -220,6 +250,7 @@ static void lv_bar_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     bar->indic_area.y1 = 0;
     bar->indic_area.y2 = 0;
     bar->mode = LV_BAR_MODE_NORMAL;
+    bar->delta_refr = 0;
 
     lv_bar_init_anim(obj, &bar->cur_value_anim);
     lv_bar_init_anim(obj, &bar->start_value_anim);
@@ -240,13 +271,16 @@ static void lv_bar_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_anim_del(&bar->start_value_anim, NULL);
 }
 
-static void draw_indic(lv_event_t * e)
+/**
+ * Calculate where the indicator is with the current (or animated) values
+ * @param obj               pointer to a bar
+ * @param indic_area        store the indicator's area here
+ * @param indic_max_area    store the area of a full indicator here (the gradient is applied on it)
+ */
+static void get_indic_area(lv_obj_t * obj, lv_area_t * indic_area, lv_area_t * indic_max_area)
 {
-    lv_obj_t * obj = lv_event_get_target(e);
     lv_bar_t * bar = (lv_bar_t *)obj;
 
-    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
-
     lv_area_t bar_coords;
     lv_obj_get_coords(obj, &bar_coords);
 
@@ -270,23 +304,24 @@ static void draw_indic(lv_event_t * e)
     lv_coord_t bg_top = lv_obj_get_style_pad_top(obj,       LV_PART_MAIN);
     lv_coord_t bg_bottom = lv_obj_get_style_pad_bottom(obj, LV_PART_MAIN);
     /*Respect padding and minimum width/height too*/
-    lv_area_copy(&bar->indic_area, &bar_coords);
-    bar->indic_area.x1 += bg_left;
-    bar->indic_area.x2 -= bg_right;
-    bar->indic_area.y1 += bg_top;
-    bar->indic_area.y2 -= bg_bottom;
-
-    if(hor && lv_area_get_height(&bar->indic_area) < LV_BAR_SIZE_MIN) {
-        bar->indic_area.y1 = obj->coords.y1 + (barh / 2) - (LV_BAR_SIZE_MIN / 2);
-        bar->indic_area.y2 = bar->indic_area.y1 + LV_BAR_SIZE_MIN;
+    lv_area_copy(indic_area, &bar_coords);
+    indic_area->x1 += bg_left;
+    indic_area->x2 -= bg_right;
+    indic_area->y1 += bg_top;
+    indic_area->y2 -= bg_bottom;
+
+    if(hor && lv_area_get_height(indic_area) < LV_BAR_SIZE_MIN) {
+        indic_area->y1 = obj->coords.y1 + (barh / 2) - (LV_BAR_SIZE_MIN / 2);
+        indic_area->y2 = indic_area->y1 + LV_BAR_SIZE_MIN;
     }
-    else if(!hor && lv_area_get_width(&bar->indic_area) < LV_BAR_SIZE_MIN) {
-        bar->indic_area.x1 = obj->coords.x1 + (barw / 2) - (LV_BAR_SIZE_MIN / 2);
-        bar->indic_area.x2 = bar->indic_area.x1 + LV_BAR_SIZE_MIN;
+    else if(!hor && lv_area_get_width(indic_area) < LV_BAR_SIZE_MIN) {
+        indic_area->x1 = obj->coords.x1 + (barw / 2) - (LV_BAR_SIZE_MIN / 2);
+        indic_area->x2 = indic_area->x1 + LV_BAR_SIZE_MIN;
     }
 
-    lv_coord_t indicw = lv_area_get_width(&bar->indic_area);
-    lv_coord_t indich = lv_area_get_height(&bar->indic_area);
+    *indic_max_area = *indic_area;
+    lv_coord_t indicw = lv_area_get_width(indic_area);
+    lv_coord_t indich = lv_area_get_height(indic_area);
 
     /*Calculate the indicator length*/
     lv_coord_t anim_length = hor ? indicw : indich;
@@ -294,17 +329,14 @@ static void draw_indic(lv_event_t * e)
     lv_coord_t anim_cur_value_x, anim_start_value_x;
 
     lv_coord_t * axis1, * axis2;
-    lv_coord_t (*indic_length_calc)(const lv_area_t * area);
 
     if(hor) {
-        axis1 = &bar->indic_area.x1;
-        axis2 = &bar->indic_area.x2;
-        indic_length_calc = lv_area_get_width;
+        axis1 = &indic_area->x1;
+        axis2 = &indic_area->x2;
     }
     else {
-        axis1 = &bar->indic_area.y1;
-        axis2 = &bar->indic_area.y2;
-        indic_length_calc = lv_area_get_height;
+        axis1 = &indic_area->y1;
+        axis2 = &indic_area->y2;
     }
 
     if(LV_BAR_IS_ANIMATING(bar->start_value_anim)) {
@@ -384,25 +416,60 @@ static void draw_indic(lv_event_t * e)
             }
         }
     }
+}
+
+static void draw_indic(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    lv_bar_t * bar = (lv_bar_t *)obj;
+
+    lv_draw_ctx_t * draw_ctx = lv_event_get_draw_ctx(e);
+
+    /*Computed here: the bands can be drawn in parallel and drawing must not change the bar*/
+    lv_area_t indic_area;
+    lv_area_t mask_indic_max_area;
+    get_indic_area(obj, &indic_area, &mask_indic_max_area);
+
+    lv_area_t bar_coords;
+    lv_obj_get_coords(obj, &bar_coords);
+
+    lv_coord_t transf_w = lv_obj_get_style_transform_width(obj, LV_PART_MAIN);
+    lv_coord_t transf_h = lv_obj_get_style_transform_height(obj, LV_PART_MAIN);
+    bar_coords.x1 -= transf_w;
+    bar_coords.x2 += transf_w;
+    bar_coords.y1 -= transf_h;
+    bar_coords.y2 += transf_h;
+    lv_coord_t barw = lv_area_get_width(&bar_coords);
+    lv_coord_t barh = lv_area_get_height(&bar_coords);
+    bool hor = barw >= barh ? true : false;
+    bool sym = false;
+    if(bar->mode == LV_BAR_MODE_SYMMETRICAL && bar->min_value < 0 && bar->max_value > 0 &&
+       bar->start_value == bar->min_value) sym = true;
+
+    lv_coord_t bg_left = lv_obj_get_style_pad_left(obj,     LV_PART_MAIN);
+    lv_coord_t bg_right = lv_obj_get_style_pad_right(obj,   LV_PART_MAIN);
+    lv_coord_t bg_top = lv_obj_get_style_pad_top(obj,       LV_PART_MAIN);
+    lv_coord_t bg_bottom = lv_obj_get_style_pad_bottom(obj, LV_PART_MAIN);
+
+    lv_coord_t indicw = lv_area_get_width(&mask_indic_max_area);
+    lv_coord_t indich = lv_area_get_height(&mask_indic_max_area);
+    lv_coord_t (*indic_length_calc)(const lv_area_t * area) = hor ? lv_area_get_width : lv_area_get_height;
 
     /*Do not draw a zero length indicator but at least call the draw part events*/
-    if(!sym && indic_length_calc(&bar->indic_area) <= 1) {
+    if(!sym && indic_length_calc(&indic_area) <= 1) {
 
         lv_obj_draw_part_dsc_t part_draw_dsc;
         lv_obj_draw_dsc_init(&part_draw_dsc, draw_ctx);
         part_draw_dsc.part = LV_PART_INDICATOR;
         part_draw_dsc.class_p = MY_CLASS;
         part_draw_dsc.type = LV_BAR_DRAW_PART_INDICATOR;
-        part_draw_dsc.draw_area = &bar->indic_area;
+        part_draw_dsc.draw_area = &indic_area;
 
         lv_event_send(obj, LV_EVENT_DRAW_PART_BEGIN, &part_draw_dsc);
         lv_event_send(obj, LV_EVENT_DRAW_PART_END, &part_draw_dsc);
         return;
     }
 
-    lv_area_t indic_area;
-    lv_area_copy(&indic_area, &bar->indic_area);
-
     lv_draw_rect_dsc_t draw_rect_dsc;
     lv_draw_rect_dsc_init(&draw_rect_dsc);
     lv_obj_init_draw_rect_dsc(obj, LV_PART_INDICATOR, &draw_rect_dsc);
@@ -413,7 +480,7 @@ static void draw_indic(lv_event_t * e)
     part_draw_dsc.class_p = MY_CLASS;
     part_draw_dsc.type = LV_BAR_DRAW_PART_INDICATOR;
     part_draw_dsc.rect_dsc = &draw_rect_dsc;
-    part_draw_dsc.draw_area = &bar->indic_area;
+    part_draw_dsc.draw_area = &indic_area;
 
     lv_event_send(obj, LV_EVENT_DRAW_PART_BEGIN, &part_draw_dsc);
 
@@ -428,8 +495,8 @@ static void draw_indic(lv_event_t * e)
     /*Draw only the shadow and outline only if the indicator is long enough.
      *The radius of the bg and the indicator can make a strange shape where
      *it'd be very difficult to draw shadow.*/
-    if((hor && lv_area_get_width(&bar->indic_area) > indic_radius * 2) ||
-       (!hor && lv_area_get_height(&bar->indic_area) > indic_radius * 2)) {
+    if((hor && lv_area_get_width(&indic_area) > indic_radius * 2) ||
+       (!hor && lv_area_get_height(&indic_area) > indic_radius * 2)) {
         lv_opa_t bg_opa = draw_rect_dsc.bg_opa;
         lv_opa_t bg_img_opa = draw_rect_dsc.bg_img_opa;
         lv_opa_t border_opa = draw_rect_dsc.border_opa;
@@ -437,7 +504,7 @@ static void draw_indic(lv_event_t * e)
         draw_rect_dsc.bg_img_opa = LV_OPA_TRANSP;
         draw_rect_dsc.border_opa = LV_OPA_TRANSP;
 
-        lv_draw_rect(draw_ctx, &draw_rect_dsc, &bar->indic_area);
+        lv_draw_rect(draw_ctx, &draw_rect_dsc, &indic_area);
 
         draw_rect_dsc.bg_opa = bg_opa;
         draw_rect_dsc.bg_img_opa = bg_img_opa;
@@ -462,26 +529,12 @@ static void draw_indic(lv_event_t * e)
     draw_rect_dsc.border_opa = LV_OPA_TRANSP;
     draw_rect_dsc.shadow_opa = LV_OPA_TRANSP;
 
-    /*Get the max possible indicator area. The gradient should be applied on this*/
-    lv_area_t mask_indic_max_area;
-    lv_area_copy(&mask_indic_max_area, &bar_coords);
-    mask_indic_max_area.x1 += bg_left;
-    mask_indic_max_area.y1 += bg_top;
-    mask_indic_max_area.x2 -= bg_right;
-    mask_indic_max_area.y2 -= bg_bottom;
-    if(hor && lv_area_get_height(&mask_indic_max_area) < LV_BAR_SIZE_MIN) {
-        mask_indic_max_area.y1 = obj->coords.y1 + (barh / 2) - (LV_BAR_SIZE_MIN / 2);
-        mask_indic_max_area.y2 = mask_indic_max_area.y1 + LV_BAR_SIZE_MIN;
-    }
-    else if(!hor && lv_area_get_width(&mask_indic_max_area) < LV_BAR_SIZE_MIN) {
-        mask_indic_max_area.x1 = obj->coords.x1 + (barw / 2) - (LV_BAR_SIZE_MIN / 2);
-        mask_indic_max_area.x2 = mask_indic_max_area.x1 + LV_BAR_SIZE_MIN;
-    }
+    /*The gradient is applied on the max possible indicator area (`mask_indic_max_area`)*/
 
 #if LV_DRAW_COMPLEX
     /*Create a mask to the current indicator area to see only this part from the whole gradient.*/
     lv_draw_mask_radius_param_t mask_indic_param;
-    lv_draw_mask_radius_init(&mask_indic_param, &bar->indic_area, draw_rect_dsc.radius, false);
+    lv_draw_mask_radius_init(&mask_indic_param, &indic_area, draw_rect_dsc.radius, false);
     int16_t mask_indic_id = lv_draw_mask_add(&mask_indic_param, NULL);
 #endif
 
@@ -493,7 +546,7 @@ static void draw_indic(lv_event_t * e)
     draw_rect_dsc.bg_opa = LV_OPA_TRANSP;
     draw_rect_dsc.bg_img_opa = LV_OPA_TRANSP;
     draw_rect_dsc.shadow_opa = LV_OPA_TRANSP;
-    lv_draw_rect(draw_ctx, &draw_rect_dsc, &bar->indic_area);
+    lv_draw_rect(draw_ctx, &draw_rect_dsc, &indic_area);
 
 #if LV_DRAW_COMPLEX
     lv_draw_mask_free_param(&mask_indic_param);
@@ -539,18 +592,125 @@ static void lv_bar_event(const lv_obj_class_t * class_p, lv_event_t * e)
     }
     else if(code == LV_EVENT_PRESSED || code == LV_EVENT_RELEASED) {
         lv_bar_t * bar = (lv_bar_t *)obj;
+        refr_indic_area(obj);
         lv_obj_invalidate_area(obj, &bar->indic_area);
     }
+    else if(code == LV_EVENT_SIZE_CHANGED || code == LV_EVENT_STYLE_CHANGED) {
+        refr_indic_area(obj);
+    }
     else if(code == LV_EVENT_DRAW_MAIN) {
         draw_indic(e);
     }
 }
 
+/**
+ * Update `indic_area` of the bar. Only from the thread changing the bar, never while drawing:
+ * with LV_USE_REFR_THREADS the bands are drawn in parallel.
+ * @param obj       pointer to a bar
+ */
+static void refr_indic_area(lv_obj_t * obj)
+{
+    lv_bar_t * bar = (lv_bar_t *)obj;
+    lv_area_t indic_max;
+    get_indic_area(obj, &bar->indic_area, &indic_max);
+}
+
+/**
+ * Call before changing the values
+ * @param obj       pointer to a bar
+ * @param indic_old store the indicator area before the change here
+ * @return          true: only the changed part needs to be redrawn
+ */
+static bool indic_change_begin(lv_obj_t * obj, lv_area_t * indic_old)
+{
+    lv_bar_t * bar = (lv_bar_t *)obj;
+
+    /*Derived widgets (e.g. slider) draw more things depending on the value*/
+    if(!bar->delta_refr || obj->class_p != MY_CLASS) return false;
+
+    /*Shadow and outline are drawn around the whole indicator*/
+    if(lv_obj_get_style_shadow_width(obj, LV_PART_INDICATOR) > 0 &&
+       lv_obj_get_style_shadow_opa(obj, LV_PART_INDICATOR) > LV_OPA_MIN) return false;
+    if(lv_obj_get_style_outline_width(obj, LV_PART_INDICATOR) > 0 &&
+       lv_obj_get_style_outline_opa(obj, LV_PART_INDICATOR) > LV_OPA_MIN) return false;
+
+    lv_area_t indic_max;
+    get_indic_area(obj, indic_old, &indic_max);
+    return true;
+}
+
+/**
+ * Call after changing the values to invalidate what changed
+ * @param obj       pointer to a bar
+ * @param delta     return value of `indic_change_begin()`
+ * @param indic_old the indicator area saved by `indic_change_begin()`
+ */
+static void indic_change_end(lv_obj_t * obj, bool delta, const lv_area_t * indic_old)
+{
+    refr_indic_area(obj);
+    if(!delta) {
+        lv_obj_invalidate(obj);
+        return;
+    }
+
+    lv_area_t indic_new;
+    lv_area_t indic_max;
+    get_indic_area(obj, &indic_new, &indic_max);
+    if(_lv_area_is_equal(indic_old, &indic_new)) return;
+
+    /*The rounding and the border of an end is redrawn when the end moves*/
+    lv_coord_t r = lv_obj_get_style_radius(obj, LV_PART_INDICATOR);
+    lv_coord_t short_side = LV_MIN(lv_area_get_width(&indic_max), lv_area_get_height(&indic_max));
+    if(r > short_side >> 1) r = short_side >> 1;
+    lv_coord_t margin = LV_MAX(r, lv_obj_get_style_border_width(obj, LV_PART_INDICATOR)) + 1;
+
+    bool hor = indic_old->y1 == indic_new.y1 && indic_old->y2 == indic_new.y2;
+    bool ver = indic_old->x1 == indic_new.x1 && indic_old->x2 == indic_new.x2;
+    lv_coord_t len_old = hor ? lv_area_get_width(indic_old) : lv_area_get_height(indic_old);
+    lv_coord_t len_new = hor ? lv_area_get_width(&indic_new) : lv_area_get_height(&indic_new);
+
+    /*A short indicator is rounded on its whole length so all of it changes*/
+    if((!hor && !ver) || LV_MIN(len_old, len_new) <= 2 * margin) {
+        lv_area_t a;
+        _lv_area_join(&a, indic_old, &indic_new);
+        lv_obj_invalidate_area(obj, &a);
+        return;
+    }
+
+    lv_area_t a = indic_new;
+    if(hor) {
+        if(indic_old->x1 != indic_new.x1) {
+            a.x1 = LV_MIN(indic_old->x1, indic_new.x1) - margin;
+            a.x2 = LV_MAX(indic_old->x1, indic_new.x1) + margin;
+            lv_obj_invalidate_area(obj, &a);
+        }
+        if(indic_old->x2 != indic_new.x2) {
+            a.x1 = LV_MIN(indic_old->x2, indic_new.x2) - margin;
+            a.x2 = LV_MAX(indic_old->x2, indic_new.x2) + margin;
+            lv_obj_invalidate_area(obj, &a);
+        }
+    }
+    else {
+        if(indic_old->y1 != indic_new.y1) {
+            a.y1 = LV_MIN(indic_old->y1, indic_new.y1) - margin;
+            a.y2 = LV_MAX(indic_old->y1, indic_new.y1) + margin;
+            lv_obj_invalidate_area(obj, &a);
+        }
+        if(indic_old->y2 != indic_new.y2) {
+            a.y1 = LV_MIN(indic_old->y2, indic_new.y2) - margin;
+            a.y2 = LV_MAX(indic_old->y2, indic_new.y2) + margin;
+            lv_obj_invalidate_area(obj, &a);
+        }
+    }
+}
+
 static void lv_bar_anim(void * var, int32_t value)
 {
     _lv_bar_anim_t * bar_anim = var;
+    lv_area_t indic_old;
+    bool delta = indic_change_begin(bar_anim->bar, &indic_old);
     bar_anim->anim_state    = value;
-    lv_obj_invalidate(bar_anim->bar);
+    indic_change_end(bar_anim->bar, delta, &indic_old);
 }
 
 static void lv_bar_anim_ready(lv_anim_t * a)
@@ -559,22 +719,26 @@ static void lv_bar_anim_ready(lv_anim_t * a)
     lv_obj_t * obj = (lv_obj_t *)var->bar;
     lv_bar_t * bar = (lv_bar_t *)obj;
 
+    lv_area_t indic_old;
+    bool delta = indic_change_begin(obj, &indic_old);
     var->anim_state = LV_BAR_ANIM_STATE_INV;
     if(var == &bar->cur_value_anim)
         bar->cur_value = var->anim_end;
     else if(var == &bar->start_value_anim)
         bar->start_value = var->anim_end;
-    lv_obj_invalidate(var->bar);
+    indic_change_end(obj, delta, &indic_old);
 }
 
 static void lv_bar_set_value_with_anim(lv_obj_t * obj, int32_t new_value, int32_t * value_ptr,
                                        _lv_bar_anim_t * anim_info, lv_anim_enable_t en)
 {
     if(en == LV_ANIM_OFF) {
+        lv_area_t indic_old;
+        bool delta = indic_change_begin(obj, &indic_old);
         lv_anim_del(anim_info, NULL);
         anim_info->anim_state = LV_BAR_ANIM_STATE_INV;
         *value_ptr = new_value;
-        lv_obj_invalidate((lv_obj_t *)obj);
+        indic_change_end(obj, delta, &indic_old);
     }
     else {
         /*No animation in progress -> simply set the values*/
@@ -50,10 +50,11 @@ typedef struct {
     int32_t min_value;          /**< Minimum value of the bar*/
     int32_t max_value;          /**< Maximum value of the bar*/
     int32_t start_value;        /**< Start value of the bar*/
-    lv_area_t indic_area;       /**< Save the indicator area. Might be used by derived types*/
+    lv_area_t indic_area;       /**< Save the indicator area. Updated when the values, size or style change, not while drawing*/
     _lv_bar_anim_t cur_value_anim;
     _lv_bar_anim_t start_value_anim;
     lv_bar_mode_t mode : 2;     /**< Type of bar*/
+    uint8_t delta_refr : 1;     /**< Redraw only the changed part of the indicator*/
 } lv_bar_t;
 
 extern const lv_obj_class_t lv_bar_class;
@@ -112,6 +113,16 @@ void lv_bar_set_range(lv_obj_t * obj, int32_t min, int32_t max);
  */
 void lv_bar_set_mode(lv_obj_t * obj, lv_bar_mode_t mode);
 
+/**
+ * Redraw only the ends of the indicator which moved when the value changes, instead of the whole bar.
+ * Then drawing time depends on how much the value changed, not on the size of the bar.
+ * Don't use it if the indicator has shadow or outline, or `LV_EVENT_DRAW_PART_BEGIN/END` draws
+ * something depending on the value: these parts won't be redrawn.
+ * @param obj       pointer to bar object
+ * @param en        true: enable; false: invalidate the whole bar (default)
+ */
+void lv_bar_set_delta_refr(lv_obj_t * obj, bool en);
+
 /*=====================
  * Getter functions
  *====================*/
@@ -151,6 +162,21 @@ int32_t lv_bar_get_max_value(const lv_obj_t * obj);
  */
 lv_bar_mode_t lv_bar_get_mode(lv_obj_t * obj);
 
+/**
+ * Tell whether only the changed part of the indicator is redrawn
+ * @param obj       pointer to bar object
+ * @return          true: only the changed part; false: the whole bar
+ */
+bool lv_bar_get_delta_refr(const lv_obj_t * obj);
+
+/**
+ * Calculate the indicator's area from the current values and coordinates.
+ * Unlike `indic_area` it doesn't depend on when the bar was last updated, so derived widgets use it while drawing.
+ * @param obj       pointer to bar object
+ * @param area      store the area here
+ */
+void _lv_bar_get_indic_area(lv_obj_t * obj, lv_area_t * area);
+
 /**********************
  *      MACROS
  **********************/
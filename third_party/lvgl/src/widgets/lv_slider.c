@@ -338,6 +338,10 @@ static void draw_knob(lv_event_t * e)
     const bool is_rtl = LV_BASE_DIR_RTL == lv_obj_get_style_base_dir(obj, LV_PART_MAIN);
     const bool is_horizontal = is_slider_horizontal(obj);
 
+    /*Not `bar.indic_area`: that isn't updated when the slider only moves*/
+    lv_area_t indic_area;
+    _lv_bar_get_indic_area(obj, &indic_area);
+
     lv_area_t knob_area;
     lv_coord_t knob_size;
     bool is_symmetrical = false;
@@ -346,13 +350,13 @@ static void draw_knob(lv_event_t * e)
 
     if(is_horizontal) {
         knob_size = lv_obj_get_height(obj);
-        if(is_symmetrical && slider->bar.cur_value < 0) knob_area.x1 = slider->bar.indic_area.x1;
-        else knob_area.x1 = LV_SLIDER_KNOB_COORD(is_rtl, slider->bar.indic_area);
+        if(is_symmetrical && slider->bar.cur_value < 0) knob_area.x1 = indic_area.x1;
+        else knob_area.x1 = LV_SLIDER_KNOB_COORD(is_rtl, indic_area);
     }
     else {
         knob_size = lv_obj_get_width(obj);
-        if(is_symmetrical && slider->bar.cur_value < 0) knob_area.y1 = slider->bar.indic_area.y2;
-        else knob_area.y1 = slider->bar.indic_area.y1;
+        if(is_symmetrical && slider->bar.cur_value < 0) knob_area.y1 = indic_area.y2;
+        else knob_area.y1 = indic_area.y1;
     }
 
     lv_draw_rect_dsc_t knob_rect_dsc;
@@ -389,10 +393,10 @@ static void draw_knob(lv_event_t * e)
         /*Calculate the second knob area*/
         if(is_horizontal) {
             /*use !is_rtl to get the other knob*/
-            knob_area.x1 = LV_SLIDER_KNOB_COORD(!is_rtl, slider->bar.indic_area);
+            knob_area.x1 = LV_SLIDER_KNOB_COORD(!is_rtl, indic_area);
         }
         else {
-            knob_area.y1 = slider->bar.indic_area.y2;
+            knob_area.y1 = indic_area.y2;
         }
         position_knob(obj, &knob_area, knob_size, is_horizontal);
         lv_area_copy(&slider->left_knob_area, &knob_area);
@@ -0,0 +1,197 @@
+// CAN traffic generator for the dash, replacing randomCan.sh: sends the
+// synthetic drive of cantrace.hpp (or a candump log) to a (v)can interface,
+// batched with sendmmsg, from a few frames per second up to what the bus takes.
+//   cangen [-i vcan0] [-r rpm_hz] [-m] [-d seconds] [-t candump.log] [-s speed] [-l] [-b batch]
+//     -r  0x2000 frames per second, the other ids scale with it (default 100)
+//     -m  no pacing: send as fast as the interface takes frames, the drive plays fast forward
+//     -d  stop after this many seconds (default: never, or at the end of the log)
+//     -t  replay a candump -l log at its own timing instead of the drive
+//     -s  replay speed factor, 2 is twice as fast
+//     -l  loop the log
+//     -b  frames per sendmmsg (default 64)
+// Prints the frames/s every second. A vcan interface for testing:
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include "cantrace.hpp"
+
+static volatile sig_atomic_t g_run = 1;
+
+static void on_signal(int){ g_run = 0; }
+
+static uint64_t now_ns(){
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static void sleep_until(uint64_t t_ns){
+  timespec ts{ time_t(t_ns / 1000000000ull), long(t_ns % 1000000000ull) };
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
+// Raw CAN socket for sending only: no receive filter, so its queue never fills.
+static int open_can(const char *ifname){
+  int s = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (s < 0) return -1;
+  ifreq ifr{}; std::snprintf(ifr.ifr_name, IFNAMSIZ, "%s", ifname);
+  if (ioctl(s, SIOCGIFINDEX, &ifr) < 0) { close(s); return -1; }
+  setsockopt(s, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0);
+  sockaddr_can addr{}; addr.can_family = AF_CAN; addr.can_ifindex = ifr.ifr_ifindex;
+  if (bind(s, (sockaddr*)&addr, sizeof(addr)) < 0) { close(s); return -1; }
+  return s;
+}
+
+// The frames to send in time order: the drive, or the log (looped if asked).
+struct Source {
+  DriveSchedule drive;
+  std::vector<TraceFrame> log;
+  bool use_log = false;
+  bool loop = false;
+  size_t pos = 0;
+  uint64_t offset_us = 0;
+
+  explicit Source(uint32_t rpm_hz) : drive(rpm_hz) {}
+
+  bool next(TraceFrame &f){
+    if (!use_log) { f = drive.next(); return true; }
+    if (pos == log.size()) {
+      if (!loop || log.empty()) return false;
+      offset_us += log.back().t_us + 10000;  // 10 ms gap between the rounds
+      pos = 0;
+    }
+    f = log[pos++];
+    f.t_us += offset_us;
+    return true;
+  }
+};
+
+// Sends all n frames; waits when the interface's queue is full (ENOBUFS).
+static bool send_all(int s, mmsghdr *msgs, int n){
+  int sent = 0;
+  while (sent < n && g_run) {
+    int r = sendmmsg(s, msgs + sent, unsigned(n - sent), 0);
+    if (r >= 0) { sent += r; continue; }
+    if (errno == EINTR) continue;
+    if (errno == ENOBUFS || errno == EAGAIN) {
+      pollfd p{ s, POLLOUT, 0 };
+      poll(&p, 1, 10);
+      continue;
+    }
+    std::perror("sendmmsg");
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv){
+  const char *ifname = "vcan0";
+  const char *log_path = nullptr;
+  uint32_t rpm_hz = 100;
+  bool max_rate = false, loop = false;
+  double duration_s = 0, speed = 1;
+  int batch = 64;
+  for (int c; (c = getopt(argc, argv, "i:r:md:t:s:lb:")) != -1;) {
+    switch (c) {
+      case 'i': ifname = optarg; break;
+      case 'r': rpm_hz = uint32_t(std::atoi(optarg)); break;
+      case 'm': max_rate = true; break;
+      case 'd': duration_s = std::atof(optarg); break;
+      case 't': log_path = optarg; break;
+      case 's': speed = std::atof(optarg); break;
+      case 'l': loop = true; break;
+      case 'b': batch = std::atoi(optarg); break;
+      default:
+        std::fprintf(stderr, "usage: %s [-i vcan0] [-r rpm_hz] [-m] [-d seconds] [-t candump.log] [-s speed] [-l] "
+                             "[-b batch]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (rpm_hz == 0) rpm_hz = 1;
+  if (speed <= 0) speed = 1;
+  batch = std::max(1, std::min(batch, 1024));
+
+  Source src(rpm_hz);
+  if (log_path) {
+    if (!cantrace_load_candump(log_path, src.log)) {
+      std::fprintf(stderr, "can't read %s\n", log_path);
+      return 1;
+    }
+    src.use_log = true;
+    src.loop = loop;
+  }
+
+  int s = open_can(ifname);
+  if (s < 0) {
+    std::fprintf(stderr, "can't open %s: %s\n", ifname, std::strerror(errno));
+    return 1;
+  }
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+
+  std::vector<can_frame> frames(batch);
+  std::vector<iovec> iov(batch);
+  std::vector<mmsghdr> msgs(batch);
+  for (int i = 0; i < batch; ++i) {
+    iov[i] = { &frames[i], sizeof(can_frame) };
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  const uint64_t start = now_ns();
+  const uint64_t end = duration_s > 0 ? start + uint64_t(duration_s * 1e9) : UINT64_MAX;
+  auto due_ns = [&](const TraceFrame &f){ return start + uint64_t(double(f.t_us) * 1000.0 / speed); };
+
+  uint64_t total = 0, last_total = 0, last_report = start;
+  TraceFrame pending;
+  bool have = src.next(pending);
+  while (g_run && have) {
+    uint64_t now = now_ns();
+    if (now >= end) break;
+    if (!max_rate && due_ns(pending) > now) {
+      sleep_until(std::min(due_ns(pending), end));
+      continue;
+    }
+
+    // Everything due by now, up to a batch.
+    int n = 0;
+    while (have && n < batch && (max_rate || due_ns(pending) <= now)) {
+      can_frame &cf = frames[n++];
+      cf = {};
+      cf.can_id = pending.fr.id > CAN_SFF_MASK ? (pending.fr.id & CAN_EFF_MASK) | CAN_EFF_FLAG : pending.fr.id;
+      cf.can_dlc = std::min<uint8_t>(pending.fr.dlc, 8);
+      std::memcpy(cf.data, pending.fr.data, 8);
+      have = src.next(pending);
+    }
+    if (!send_all(s, msgs.data(), n)) break;
+    total += uint64_t(n);
+
+    if (now - last_report >= 1000000000ull) {
+      std::printf("%8.0f frames/s  %10llu total\n", double(total - last_total) * 1e9 / double(now - last_report),
+                  (unsigned long long)total);
+      std::fflush(stdout);
+      last_total = total;
+      last_report = now;
+    }
+  }
+
+  double secs = double(now_ns() - start) / 1e9;
+  std::printf("sent %llu frames in %.1f s (%.0f frames/s)\n", (unsigned long long)total, secs,
+              secs > 0 ? double(total) / secs : 0.0);
+  close(s);
+  return 0;
+}
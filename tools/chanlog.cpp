@@ -0,0 +1,79 @@
+// Columnar session logs (chanlog.hpp) from the command line.
+//   chanlog build <log> <out.dcol>                  decodes a CAN log (a canlog directory,
+//                                                   candump, ASC or binary trace) into columns
+//   chanlog list <file.dcol>                        channels: blocks, samples, bytes, time span
+//   chanlog get <file.dcol> <channel> [from_s [to_s]]
+//                                                   "t_s value" lines of one channel; the blocks
+//                                                   read go to stderr
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "canlog.hpp"
+#include "cantrace.hpp"
+#include "cansignals.hpp"
+#include "chanlog.hpp"
+
+static int usage(const char *argv0){
+  std::fprintf(stderr, "usage: %s build <log> <out.dcol>\n"
+                       "       %s list <file.dcol>\n"
+                       "       %s get <file.dcol> <channel> [from_s [to_s]]\n", argv0, argv0, argv0);
+  return 2;
+}
+
+static int build(const char *in, const char *out){
+  std::vector<TraceFrame> tr;
+  bool ok = canlog_is_log(in) ? canlog_load(in, tr) : cantrace_load(in, tr);
+  if (!ok) { std::fprintf(stderr, "can't read %s\n", in); return 1; }
+  ChanLogWriter w;
+  if (!w.open(out)) { std::perror(out); return 1; }
+  uint32_t ids[CH_COUNT];
+  for (int i = 0; i < CH_COUNT; ++i) ids[i] = w.channel(DASH_CHANNEL_NAMES[i]);
+  uint64_t samples = 0;
+  for (const TraceFrame &f : tr) {
+    ChannelSample s[2];
+    int n = can_decode(f.fr, s);
+    for (int i = 0; i < n; ++i) w.add(ids[s[i].ch], f.t_us, s[i].v);
+    samples += uint64_t(n);
+  }
+  if (!w.close()) { std::perror(out); return 1; }
+  std::printf("%zu frames, %llu samples -> %s, %llu bytes (%.2f per sample)\n", tr.size(),
+              (unsigned long long)samples, out, (unsigned long long)w.bytes_written(),
+              samples ? double(w.bytes_written()) / double(samples) : 0.0);
+  return 0;
+}
+
+static int list(const char *path){
+  ChanLogReader r;
+  if (!r.open(path)) { std::fprintf(stderr, "%s: not a complete chanlog\n", path); return 1; }
+  std::printf("%-12s %7s %10s %10s %10s %10s\n", "channel", "blocks", "samples", "bytes", "from s", "to s");
+  for (uint32_t ch = 0; ch < r.channels().size(); ++ch) {
+    ChanLogReader::ChannelInfo ci = r.info(ch);
+    std::printf("%-12s %7u %10llu %10llu %10.3f %10.3f\n", r.channels()[ch].c_str(), (unsigned)ci.blocks,
+                (unsigned long long)ci.samples, (unsigned long long)ci.bytes, ci.t_first_us / 1e6, ci.t_last_us / 1e6);
+  }
+  return 0;
+}
+
+static int get(const char *path, const char *name, double from_s, double to_s){
+  ChanLogReader r;
+  if (!r.open(path)) { std::fprintf(stderr, "%s: not a complete chanlog\n", path); return 1; }
+  int ch = r.channel(name);
+  if (ch < 0) { std::fprintf(stderr, "%s: no channel %s\n", path, name); return 1; }
+  std::vector<ChanSample> out;
+  uint64_t from_us = from_s > 0 ? uint64_t(from_s * 1e6) : 0;
+  uint64_t to_us = to_s >= 0 ? uint64_t(to_s * 1e6) : UINT64_MAX;
+  if (!r.read(uint32_t(ch), from_us, to_us, out)) { std::fprintf(stderr, "%s: read error\n", path); return 1; }
+  for (const ChanSample &s : out) std::printf("%.6f %.10g\n", s.t_us / 1e6, s.v);
+  std::fprintf(stderr, "%zu samples from %llu of %u blocks (%llu bytes)\n", out.size(),
+               (unsigned long long)r.blocks_read(), (unsigned)r.info(uint32_t(ch)).blocks,
+               (unsigned long long)r.bytes_read());
+  return 0;
+}
+
+int main(int argc, char **argv){
+  if (argc >= 4 && std::strcmp(argv[1], "build") == 0) return build(argv[2], argv[3]);
+  if (argc >= 3 && std::strcmp(argv[1], "list") == 0) return list(argv[2]);
+  if (argc >= 4 && std::strcmp(argv[1], "get") == 0)
+    return get(argv[2], argv[3], argc > 4 ? std::atof(argv[4]) : 0, argc > 5 ? std::atof(argv[5]) : -1);
+  return usage(argv[0]);
+}
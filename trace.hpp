@@ -0,0 +1,33 @@
+#pragma once
+// Scoped trace points of the dash, recorded by LVGL's lv_trace (LV_USE_TRACE,
+// CMake's DASH_TRACE) next to its own refresh and draw spans:
+//   { TRACE_SCOPE("can drain"); ... }
+// opens a span on the calling thread until the end of the block. The name
+// must be a literal: only the pointer is kept. lv_trace_dump() writes the last
+// events of every thread as Chrome trace JSON. Without LV_USE_TRACE the
+// scopes compile to nothing.
+
+extern "C" {
+  #include "lvgl.h"
+}
+
+#if LV_USE_TRACE
+class TraceScope {
+public:
+  explicit TraceScope(const char *name) : name_(name) { lv_trace_begin(name); }
+  ~TraceScope(){ lv_trace_end(name_); }
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *name_;
+};
+
+#define TRACE_CAT_(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD(name) lv_trace_set_thread_name(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#endif